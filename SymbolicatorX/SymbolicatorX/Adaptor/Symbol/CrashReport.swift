@@ -0,0 +1,182 @@
+//
+//  CrashReport.swift
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+import Foundation
+
+
+/// Structured contents of a text crash, spindump or sample report, produced by
+/// the single-pass parser in libsymbolicator.
+public final class CrashReport {
+    
+    public struct Image {
+        let start: UInt64
+        let end: UInt64
+        let name: String
+        let architecture: String
+        let uuid: String
+        let path: String
+    }
+    
+    public struct Frame {
+        
+        enum Kind {
+            case crash
+            case sample
+        }
+        
+        let image: String
+        let address: String
+        let addressValue: UInt64
+        let addressOffset: Int
+        let symbolOffset: Int
+        let symbolLength: Int
+        let thread: Int32
+        let imageIndex: Int?
+        let kind: Kind
+        let isMainImage: Bool
+    }
+    
+    let processName: String
+    let identifier: String
+    let responsible: String
+    let codeType: String
+    let version: String
+    let buildVersion: String
+    let images: [Image]
+    let frames: [Frame]
+    let mainImageIndex: Int?
+    
+    var mainImage: Image? {
+        return mainImageIndex.map { images[$0] }
+    }
+    
+    /// The text the report was parsed from, copied out of the report on
+    /// each access; .ips files come back translated.
+    var text: String {
+        guard let rawValue = rawValue else { return "" }
+        
+        var text: UnsafePointer<CChar>? = nil
+        var length = 0
+        symbolicator_report_get_text(rawValue, &text, &length)
+        guard let bytes = text else { return "" }
+        return String(decoding: UnsafeRawBufferPointer(start: bytes, count: length), as: UTF8.self)
+    }
+    
+    private var rawValue: symbolicator_report_t?
+    
+    public convenience init(content: String) throws {
+        
+        var text = content
+        var report: symbolicator_report_t? = nil
+        let rawError = text.withUTF8 { buffer in
+            buffer.withMemoryRebound(to: CChar.self) {
+                symbolicator_report_parse($0.baseAddress, $0.count, &report)
+            }
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard let rawValue = report else {
+            throw SymbolicatorError.unknown
+        }
+        self.init(rawValue: rawValue)
+    }
+    
+    /// Maps the file and parses it in place, so reading a report costs no
+    /// copy of it; an .ips file is translated to the text format first.
+    public convenience init(path: URL) throws {
+        
+        var report: symbolicator_report_t? = nil
+        let rawError = symbolicator_report_open(path.path, &report)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard let rawValue = report else {
+            throw SymbolicatorError.unknown
+        }
+        self.init(rawValue: rawValue)
+    }
+    
+    private init(rawValue: symbolicator_report_t) {
+        
+        self.rawValue = rawValue
+        
+        var info = symbolicator_report_info_t()
+        symbolicator_report_get_info(rawValue, &info)
+        processName = String(cString: info.process_name)
+        identifier = String(cString: info.identifier)
+        responsible = String(cString: info.responsible)
+        codeType = String(cString: info.code_type)
+        version = String(cString: info.version)
+        buildVersion = String(cString: info.build_version)
+        mainImageIndex = info.main_image >= 0 ? Int(info.main_image) : nil
+        
+        var rawImages: UnsafePointer<symbolicator_report_image_t>? = nil
+        var imageCount = 0
+        symbolicator_report_get_images(rawValue, &rawImages, &imageCount)
+        images = UnsafeBufferPointer(start: rawImages, count: imageCount).map {
+            Image(
+                start: $0.start,
+                end: $0.end,
+                name: String(cString: $0.name),
+                architecture: String(cString: $0.arch),
+                uuid: String(cString: $0.uuid),
+                path: String(cString: $0.path)
+            )
+        }
+        
+        var rawFrames: UnsafePointer<symbolicator_report_frame_t>? = nil
+        var frameCount = 0
+        symbolicator_report_get_frames(rawValue, &rawFrames, &frameCount)
+        frames = UnsafeBufferPointer(start: rawFrames, count: frameCount).map {
+            Frame(
+                image: String(cString: $0.image),
+                address: String(cString: $0.address),
+                addressValue: $0.address_value,
+                addressOffset: $0.address_offset,
+                symbolOffset: $0.symbol_offset,
+                symbolLength: $0.symbol_length,
+                thread: $0.thread,
+                imageIndex: $0.image_index >= 0 ? Int($0.image_index) : nil,
+                kind: $0.kind == SYMBOLICATOR_REPORT_FRAME_SAMPLE ? .sample : .crash,
+                isMainImage: $0.is_main_image != 0
+            )
+        }
+    }
+    
+    deinit {
+        if let rawValue = rawValue {
+            symbolicator_report_free(rawValue)
+        }
+    }
+    
+    /// Returns the report text with `replacements[i]` in place of the
+    /// unresolved symbol of `frames[i]`; nil entries keep the frame as is.
+    public func render(replacements: [String?]) throws -> String {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let strings = replacements.map { $0.flatMap { strdup($0) } }
+        defer { strings.forEach { free($0) } }
+        
+        var output: UnsafePointer<CChar>? = nil
+        var length = 0
+        let rawError = strings.map { UnsafePointer($0) }.withUnsafeBufferPointer {
+            symbolicator_report_render(rawValue, $0.baseAddress, $0.count, &output, &length)
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard let rendered = output else {
+            throw SymbolicatorError.unknown
+        }
+        
+        return String(decoding: UnsafeRawBufferPointer(start: rendered, count: length), as: UTF8.self)
+    }
+}
@@ -0,0 +1,133 @@
+//
+//  DSYMCatalog.swift
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+import Foundation
+
+
+public final class DSYMCatalog {
+
+    /// Kept next to the symbol indexes; losing it only costs one full scan.
+    static let shared: DSYMCatalog? = {
+        guard let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else {
+            return nil
+        }
+        let file = caches.appendingPathComponent("SymbolicatorX").appendingPathComponent("DSYMCatalog")
+        return try? DSYMCatalog(file: file.path)
+    }()
+
+    private var rawValue: symbolicator_catalog_t?
+
+    /// `file` of nil keeps the catalog in memory.
+    public init(file: String?) throws {
+
+        var catalog: symbolicator_catalog_t? = nil
+        let rawError = symbolicator_catalog_new(file, &catalog)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard catalog != nil else {
+            throw SymbolicatorError.unknown
+        }
+        self.rawValue = catalog
+    }
+
+    deinit {
+        if let rawValue = rawValue {
+            symbolicator_catalog_free(rawValue)
+        }
+    }
+
+    /// Rescans `roots`, skipping directories unchanged since the last scan.
+    /// Blocks; must not be called on the main queue.
+    public func refresh(roots: [String], threads: UInt32 = 0) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+
+        let paths = roots.map { strdup(($0 as NSString).expandingTildeInPath) }
+        defer { paths.forEach { free($0) } }
+
+        let rawError = paths.map { $0.map { UnsafePointer($0) } }.withUnsafeBufferPointer {
+            symbolicator_catalog_refresh(rawValue, $0.baseAddress, $0.count, threads)
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+
+    /// Rescans `roots`, then keeps them up to date in the background from
+    /// FSEvents until the catalog is released. Blocks for the rescan; must
+    /// not be called on the main queue.
+    public func watch(roots: [String], threads: UInt32 = 0) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+
+        let paths = roots.map { strdup(($0 as NSString).expandingTildeInPath) }
+        defer { paths.forEach { free($0) } }
+
+        let rawError = paths.map { $0.map { UnsafePointer($0) } }.withUnsafeBufferPointer {
+            symbolicator_catalog_watch(rawValue, $0.baseAddress, $0.count, threads)
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+
+    /// Scans `roots` concurrently for the dSYMs of `uuids`, stopping once
+    /// each has been found; look them up with `dsymPath(uuid:)` afterwards.
+    /// Returns false when some were not found. Blocks; must not be called
+    /// on the main queue.
+    @discardableResult
+    public func search(uuids: [BinaryUUID], roots: [String], threads: UInt32 = 0) throws -> Bool {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+
+        let bytes = uuids.flatMap { $0.bytes }
+        let paths = roots.map { strdup(($0 as NSString).expandingTildeInPath) }
+        defer { paths.forEach { free($0) } }
+
+        let rawError = paths.map { $0.map { UnsafePointer($0) } }.withUnsafeBufferPointer { roots in
+            bytes.withUnsafeBufferPointer {
+                symbolicator_catalog_search(rawValue, $0.baseAddress, uuids.count, roots.baseAddress, roots.count, threads)
+            }
+        }
+        if rawError == SYMBOLICATOR_E_NOT_FOUND {
+            return false
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        return true
+    }
+
+    /// The Mach-O file holding the symbols for `uuid`, preferably the DWARF
+    /// file of a dSYM bundle.
+    public func binaryPath(uuid: BinaryUUID, architecture: String? = nil) -> String? {
+        guard let rawValue = self.rawValue else { return nil }
+
+        var path: UnsafeMutablePointer<CChar>? = nil
+        guard symbolicator_catalog_find(rawValue, uuid.bytes, architecture, &path) == SYMBOLICATOR_E_SUCCESS, let found = path else {
+            return nil
+        }
+        defer { symbolicator_string_free(found) }
+
+        return String(cString: found)
+    }
+
+    /// The .dSYM bundle holding the symbols for `uuid`, or nil when the
+    /// catalog only knows a plain binary.
+    public func dsymPath(uuid: BinaryUUID) -> String? {
+
+        guard let binaryPath = binaryPath(uuid: uuid), let range = binaryPath.range(of: ".dSYM/") else {
+            return nil
+        }
+        return String(binaryPath[..<range.lowerBound]) + ".dSYM"
+    }
+}
@@ -0,0 +1,223 @@
+//
+//  SymbolBatch.swift
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+import Foundation
+
+
+/// Symbolicates many reports over one thread pool. Reports sharing a build
+/// share the loaded symbol index.
+public final class SymbolBatch {
+    
+    /// Receives the images still lacking symbols and returns the Mach-O file
+    /// to use for each UUID it could find.
+    typealias LocateHandler = ([(uuid: BinaryUUID, architecture: String?)]) -> [BinaryUUID: String]
+    /// Called on the thread running the batch with each finished report, one at a time.
+    typealias ResultHandler = (_ name: String, _ output: String?, _ error: String?) -> Void
+    
+    /// Reports sharing a crash signature; only the first of `names` is
+    /// symbolicated and handed to the result handler.
+    struct Bucket {
+        let hash: UInt64
+        let signature: String
+        let names: [String]
+    }
+    
+    private final class Context {
+        let locate: LocateHandler
+        let result: ResultHandler
+        
+        init(locate: @escaping LocateHandler, result: @escaping ResultHandler) {
+            self.locate = locate
+            self.result = result
+        }
+    }
+    
+    private var rawValue: symbolicator_batch_t?
+    
+    public init(cache: SymbolCache?, threads: UInt32 = 0) throws {
+        
+        var batch: symbolicator_batch_t? = nil
+        let rawError = symbolicator_batch_new(cache?.rawCache, threads, &batch)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard batch != nil else {
+            throw SymbolicatorError.unknown
+        }
+        self.rawValue = batch
+    }
+    
+    deinit {
+        if let rawValue = rawValue {
+            symbolicator_batch_free(rawValue)
+        }
+    }
+    
+    public func addReport(name: String, content: String) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var content = content
+        let rawError = content.withUTF8 { buffer in
+            buffer.withMemoryRebound(to: CChar.self) {
+                symbolicator_batch_add_report(rawValue, name, $0.baseAddress, $0.count)
+            }
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// Queues the report at `path`, mapped by a worker when the batch runs.
+    public func addReportFile(path: String) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawError = symbolicator_batch_add_report_file(rawValue, path)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// Registers the Mach-O file holding the symbols for `uuid` up front,
+    /// so it is not asked for through `locate`.
+    public func addBinary(uuid: BinaryUUID, path: String) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawError = symbolicator_batch_add_binary(rawValue, uuid.bytes, path)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// Expands frames into the calls inlined at their address; text reports
+    /// then get one line per call. Off by default.
+    public func setExpandsInlines(_ expandsInlines: Bool) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawError = symbolicator_batch_set_expand_inlines(rawValue, expandsInlines ? 1 : 0)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// Demangles Swift and C++ function names, each distinct name once for
+    /// the whole batch. Off by default.
+    public func setDemangles(_ demangles: Bool) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawError = symbolicator_batch_set_demangle(rawValue, demangles ? 1 : 0)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// What the result handler receives for each report.
+    enum Format {
+        /// The symbolicated report, in the format it came in.
+        case text
+        /// One single-line JSON record per report: header, threads with
+        /// their resolved frames and inline chains, and binary images.
+        case json
+    }
+    
+    /// Sets the output format. `.text` by default.
+    func setFormat(_ format: Format) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawFormat: symbolicator_batch_format_t
+        switch format {
+        case .text: rawFormat = SYMBOLICATOR_BATCH_FORMAT_TEXT
+        case .json: rawFormat = SYMBOLICATOR_BATCH_FORMAT_JSON
+        }
+        let rawError = symbolicator_batch_set_format(rawValue, rawFormat)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// Groups reports by their exception type and top `frames` crashing
+    /// thread frames, and symbolicates one report per group. 0, the
+    /// default, symbolicates every report.
+    public func setDeduplicates(frames: UInt32) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawError = symbolicator_batch_set_deduplicate(rawValue, frames)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+    
+    /// The signature groups of the last `run`, ordered by their first report.
+    func buckets() throws -> [Bucket] {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var buckets: UnsafePointer<symbolicator_batch_bucket_t>? = nil
+        var count = 0
+        let rawError = symbolicator_batch_get_buckets(rawValue, &buckets, &count)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        return UnsafeBufferPointer(start: buckets, count: count).map { bucket in
+            let names = UnsafeBufferPointer(start: bucket.names, count: bucket.count).map { name in
+                name.map { String(cString: $0) } ?? ""
+            }
+            return Bucket(hash: bucket.hash, signature: String(cString: bucket.signature), names: names)
+        }
+    }
+    
+    /// Blocks until every report has been handed to `result`.
+    func run(locate: @escaping LocateHandler, result: @escaping ResultHandler) throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let context = Context(locate: locate, result: result)
+        let rawError = withExtendedLifetime(context) {
+            symbolicator_batch_run(rawValue, { (batch, keys, count, userData) in
+                
+                guard let batch = batch, let keys = keys, let userData = userData else { return }
+                let context = Unmanaged<Context>.fromOpaque(userData).takeUnretainedValue()
+                
+                let missing = UnsafeBufferPointer(start: keys, count: count).compactMap { key -> (uuid: BinaryUUID, architecture: String?)? in
+                    let bytes = withUnsafeBytes(of: key.uuid) { Array($0) }
+                    guard let uuid = BinaryUUID(bytes.map { String(format: "%02x", $0) }.joined()) else { return nil }
+                    return (uuid, key.arch.map { String(cString: $0) })
+                }
+                
+                for (uuid, path) in context.locate(missing) {
+                    symbolicator_batch_add_binary(batch, uuid.bytes, path)
+                }
+            }, { (name, output, length, error, userData) in
+                
+                guard let userData = userData else { return }
+                let context = Unmanaged<Context>.fromOpaque(userData).takeUnretainedValue()
+                
+                let text = output.map { String(decoding: UnsafeRawBufferPointer(start: $0, count: length), as: UTF8.self) }
+                context.result(name.map { String(cString: $0) } ?? "", text, error.map { String(cString: $0) })
+            }, Unmanaged.passUnretained(context).toOpaque())
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+}
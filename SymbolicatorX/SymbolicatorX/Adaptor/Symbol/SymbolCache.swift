@@ -0,0 +1,122 @@
+//
+//  SymbolCache.swift
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+import Foundation
+
+
+public final class SymbolCache {
+    
+    /// Indexes live under ~/Library/Caches so the system may purge them; they
+    /// are rebuilt from the dSYM on the next symbolication.
+    static let shared: SymbolCache? = {
+        guard let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else {
+            return nil
+        }
+        let directory = caches.appendingPathComponent("SymbolicatorX").appendingPathComponent("SymbolIndex")
+        return try? SymbolCache(directory: directory.path, maxBytes: 1 << 30)
+    }()
+    
+    private var rawValue: symbolicator_cache_t?
+    
+    /// Handle shared with `SymbolBatch`; stays owned by this cache.
+    var rawCache: symbolicator_cache_t? {
+        return rawValue
+    }
+    
+    public init(directory: String, maxBytes: UInt64) throws {
+        
+        var cache: symbolicator_cache_t? = nil
+        let rawError = symbolicator_cache_new(directory, maxBytes, &cache)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard cache != nil else {
+            throw SymbolicatorError.unknown
+        }
+        self.rawValue = cache
+    }
+    
+    deinit {
+        if let rawValue = rawValue {
+            symbolicator_cache_free(rawValue)
+        }
+    }
+    
+    /// Opens the dSYM binary at `path`, reusing the index stored for its UUID
+    /// and storing a freshly built one otherwise.
+    public func image(path: String, architecture: String?) throws -> SymbolImage {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var image: symbolicator_image_t? = nil
+        let rawError = symbolicator_cache_open_image(rawValue, path, architecture, &image)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard let opened = image else {
+            throw SymbolicatorError.unknown
+        }
+        return SymbolImage(rawValue: opened)
+    }
+    
+    /// Loads a previously stored index without needing the dSYM at all.
+    /// Returns nil when nothing is cached for `uuid`.
+    public func image(uuid: BinaryUUID, architecture: String) throws -> SymbolImage? {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var image: symbolicator_image_t? = nil
+        let rawError = symbolicator_cache_find_image(rawValue, uuid.bytes, architecture, &image)
+        if rawError == SYMBOLICATOR_E_NOT_FOUND {
+            return nil
+        }
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard let opened = image else {
+            throw SymbolicatorError.unknown
+        }
+        return SymbolImage(rawValue: opened)
+    }
+    
+    public func contains(uuid: BinaryUUID, architecture: String) -> Bool {
+        return (try? image(uuid: uuid, architecture: architecture)) != nil
+    }
+    
+    /// Writes the frames resolved by batches so far next to the indexes,
+    /// where the next launch picks them up.
+    public func saveFrames() throws {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        let rawError = symbolicator_cache_save_frames(rawValue)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+    }
+}
+
+
+extension BinaryUUID {
+    
+    /// The 16 raw bytes, in LC_UUID order.
+    var bytes: [UInt8] {
+        
+        var bytes = [UInt8]()
+        var index = raw.startIndex
+        while index < raw.endIndex {
+            let next = raw.index(index, offsetBy: 2)
+            bytes.append(UInt8(raw[index..<next], radix: 16) ?? 0)
+            index = next
+        }
+        return bytes
+    }
+}
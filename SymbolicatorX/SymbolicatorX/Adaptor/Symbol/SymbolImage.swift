@@ -0,0 +1,166 @@
+//
+//  SymbolImage.swift
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+import Foundation
+
+
+public enum SymbolicatorError: Int32, Error {
+    case invalidArgument = -1
+    case ioError = -2
+    case badFormat = -3
+    case architectureNotFound = -4
+    case noMemory = -5
+    case notFound = -6
+    case unknown = -256
+    
+    case deallocatedImage = 100
+    
+    var message: String {
+        let detail = String(cString: symbolicator_last_error())
+        return detail.isEmpty ? "\(self)" : detail
+    }
+}
+
+
+public struct SymbolFrame {
+    
+    let function: String?
+    let functionOffset: UInt64
+    let file: String?
+    let line: UInt32
+    
+    /// Formats the frame the way `atos` prints it, with the function name
+    /// demangled as `atos` does.
+    func atosDescription(address: String, imageName: String) -> String {
+        
+        guard let mangled = function else {
+            return "\(address) (in \(imageName))"
+        }
+        let function = SymbolFrame.demangle(mangled) ?? mangled
+        
+        if let file = file, line > 0 {
+            return "\(function) (in \(imageName)) (\((file as NSString).lastPathComponent):\(line))"
+        }
+        
+        return "\(function) (in \(imageName)) + \(functionOffset)"
+    }
+    
+    /// Demangles a Swift or C++ symbol name, or returns nil when `name` is
+    /// not one the built-in demangler understands.
+    static func demangle(_ name: String) -> String? {
+        
+        var demangled: UnsafeMutablePointer<CChar>? = nil
+        let rawError = symbolicator_demangle(name, &demangled)
+        defer { symbolicator_string_free(demangled) }
+        
+        guard SymbolicatorError(rawValue: rawError.rawValue) == nil, let demangled = demangled else {
+            return nil
+        }
+        return String(cString: demangled)
+    }
+}
+
+
+public final class SymbolImage {
+    
+    private var rawValue: symbolicator_image_t?
+    
+    public init(path: String, architecture: String?) throws {
+        
+        var image: symbolicator_image_t? = nil
+        let rawError = symbolicator_image_open(path, architecture, &image)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        guard image != nil else {
+            throw SymbolicatorError.unknown
+        }
+        self.rawValue = image
+    }
+    
+    /// Takes ownership of an image opened through `SymbolCache`.
+    init(rawValue: symbolicator_image_t) {
+        self.rawValue = rawValue
+    }
+    
+    deinit {
+        if let rawValue = rawValue {
+            symbolicator_image_free(rawValue)
+        }
+    }
+    
+    public func uuid() throws -> BinaryUUID? {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var bytes = [UInt8](repeating: 0, count: 16)
+        let rawError = symbolicator_image_get_uuid(rawValue, &bytes)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        
+        return BinaryUUID(bytes.map { String(format: "%02x", $0) }.joined())
+    }
+    
+    public func name() throws -> String {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        return String(cString: symbolicator_image_get_name(rawValue))
+    }
+    
+    public func lookup(loadAddress: UInt64, addresses: [UInt64]) throws -> [SymbolFrame] {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var frames = [symbolicator_frame_t](repeating: symbolicator_frame_t(), count: addresses.count)
+        let rawError = symbolicator_image_lookup(rawValue, loadAddress, addresses, addresses.count, &frames)
+        if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+            throw error
+        }
+        
+        return frames.map(SymbolFrame.init)
+    }
+    
+    /// The calls inlined at `address`, innermost first, followed by the
+    /// function they were inlined into; one frame when nothing is inlined.
+    public func lookupInlined(loadAddress: UInt64, address: UInt64) throws -> [SymbolFrame] {
+        guard let rawValue = self.rawValue else {
+            throw SymbolicatorError.deallocatedImage
+        }
+        
+        var frames = [symbolicator_frame_t](repeating: symbolicator_frame_t(), count: 8)
+        var count = 0
+        while true {
+            let rawError = symbolicator_image_lookup_inlined(rawValue, loadAddress, address, &frames, frames.count, &count)
+            if let error = SymbolicatorError(rawValue: rawError.rawValue) {
+                throw error
+            }
+            guard count > frames.count else { break }
+            frames = [symbolicator_frame_t](repeating: symbolicator_frame_t(), count: count)
+        }
+        
+        return frames.prefix(count).map(SymbolFrame.init)
+    }
+}
+
+
+private extension SymbolFrame {
+    
+    init(_ frame: symbolicator_frame_t) {
+        self.init(
+            function: frame.function.map { String(cString: $0) },
+            functionOffset: frame.function_offset,
+            file: frame.file.map { String(cString: $0) },
+            line: frame.line
+        )
+    }
+}
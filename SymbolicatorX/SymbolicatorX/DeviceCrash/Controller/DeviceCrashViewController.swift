@@ -17,6 +17,7 @@ class DeviceCrashViewController: BaseViewController {
     private let tableView = CrashFileTableView()
     private let emptyLab = NSTextField()
     private var confirmBtn: NSButton!
+    private var symbolicateAllBtn: NSButton!
     private let textWindowController = SymbolicatedWindowController()
     
     private var afcClient: AfcClient?
@@ -174,6 +175,22 @@ extension DeviceCrashViewController {
         didClickBackBtn()
     }
     
+    @objc private func didClickSymbolicateAllBtn() {
+        
+        guard !crashFileList.isEmpty, let window = view.window else { return }
+        
+        let openPanel = NSOpenPanel()
+        openPanel.canChooseFiles = false
+        openPanel.canChooseDirectories = true
+        openPanel.canCreateDirectories = true
+        openPanel.prompt = "Save Here"
+        openPanel.beginSheetModal(for: window) { (response) in
+            
+            guard response == .OK, let directory = openPanel.url else { return }
+            self.symbolicateAll(into: directory)
+        }
+    }
+    
     @objc private func didClickBackBtn() {
         
         guard
@@ -195,6 +212,74 @@ extension DeviceCrashViewController {
     }
 }
 
+// MARK: - Batch
+extension DeviceCrashViewController {
+    
+    /// Symbolicates every listed report in one batch, writing each result to
+    /// `directory` as soon as it is ready. Reports of the same crash are
+    /// symbolicated once; crash_buckets.txt lists which reports each covers.
+    private func symbolicateAll(into directory: URL) {
+        
+        let files = crashFileList
+        symbolicateAllBtn.isEnabled = false
+        
+        Symbolicator.queue.addOperation {
+            var failures = [String]()
+            do {
+                let batch = try SymbolBatch(cache: SymbolCache.shared)
+                try batch.setExpandsInlines(true)
+                try batch.setDemangles(true)
+                try batch.setDeduplicates(frames: 5)
+                for file in files {
+                    // The batch translates .ips reports itself.
+                    guard let data = file.data, let content = String(data: data, encoding: .utf8) else { continue }
+                    try batch.addReport(name: file.name, content: content)
+                }
+                
+                try batch.run(locate: { (missing) in
+                    
+                    let found = Symbolicator.locateDSYMs(uuids: missing.map { $0.uuid.pretty })
+                    var binaries = [BinaryUUID: String]()
+                    missing.forEach { image in
+                        if let dsymPath = found[image.uuid.pretty] {
+                            binaries[image.uuid] = DSYMFile.binaryPath(inBundle: URL(fileURLWithPath: dsymPath))
+                        }
+                    }
+                    return binaries
+                }, result: { (name, output, error) in
+                    
+                    guard let output = output else {
+                        failures.append("\(name): \(error ?? "")")
+                        return
+                    }
+                    let filename = ((name as NSString).deletingPathExtension as NSString).lastPathComponent + "_symbolicated.crash"
+                    try? output.write(to: directory.appendingPathComponent(filename), atomically: true, encoding: .utf8)
+                })
+                
+                let summary = try batch.buckets().sorted { $0.names.count > $1.names.count }.map { bucket in
+                    "\(bucket.names.count) reports: \(bucket.names.joined(separator: ", "))\n\(bucket.signature)\n"
+                }
+                if !summary.isEmpty {
+                    try? summary.joined(separator: "\n").write(to: directory.appendingPathComponent("crash_buckets.txt"), atomically: true, encoding: .utf8)
+                }
+                try? SymbolCache.shared?.saveFrames()
+            } catch let error as SymbolicatorError {
+                failures.append(error.message)
+            } catch {
+                failures.append("\(error)")
+            }
+            
+            DispatchQueue.main.async {
+                self.symbolicateAllBtn.isEnabled = true
+                NSWorkspace.shared.activateFileViewerSelecting([directory])
+                if !failures.isEmpty {
+                    self.view.window?.alert(message: failures.joined(separator: "\n"))
+                }
+            }
+        }
+    }
+}
+
 // MARK: - TableViewMenuDelegate
 extension DeviceCrashViewController: TableViewMenuDelegate {
     
@@ -324,6 +409,13 @@ extension DeviceCrashViewController {
             make.top.equalTo(confirmBtn)
         }
         
+        symbolicateAllBtn = NSButton.makeButton(title: "Symbolicate All", target: self, action: #selector(didClickSymbolicateAllBtn))
+        view.addSubview(symbolicateAllBtn)
+        symbolicateAllBtn.snp.makeConstraints { (make) in
+            make.right.equalTo(backBtn.snp.left).offset(-10)
+            make.top.equalTo(confirmBtn)
+        }
+        
         devicePopBtn.target = self
         devicePopBtn.action = #selector(didChangeDevice(_:))
         devicePopBtn.focusRingType = .none
@@ -340,7 +432,7 @@ extension DeviceCrashViewController {
         appPopBtn.snp.makeConstraints { (make) in
             make.top.equalTo(devicePopBtn)
             make.left.equalTo(devicePopBtn.snp.right).offset(10)
-            make.width.equalTo(285)
+            make.right.equalTo(symbolicateAllBtn.snp.left).offset(-10)
         }
         
         tableView.usesAlternatingRowBackgroundColors = true
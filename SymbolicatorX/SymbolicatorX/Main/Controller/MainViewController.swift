@@ -30,6 +30,17 @@ class MainViewController: BaseViewController {
     
     private var isSymbolicating = false
     
+    /// Whether the symbol cache already holds an index for the crash's UUID.
+    private var hasCachedSymbols: Bool {
+        guard
+            let crashFile = crashFile,
+            let uuid = crashFile.uuid,
+            let architecture = crashFile.architecture?.atosString
+        else { return false }
+        
+        return SymbolCache.shared?.contains(uuid: uuid, architecture: architecture) == true
+    }
+    
     private let textWindowController = SymbolicatedWindowController()
     private let crashFileDropZoneView = DropZoneView(fileTypes: [".crash", ".txt", ".crashinfo", ".ips"], text: "Drop Crash Report or Sample")
     private let dsymFileDropZoneView = DropZoneView(fileTypes: [".dSYM"], text: "Drop App DSYM")
@@ -50,19 +61,19 @@ extension MainViewController {
         
         if self.crashFile == nil {
             view.window?.alert(message: "No Crash File")
-        } else if self.dsymFile == nil {
+        } else if self.dsymFile == nil && !hasCachedSymbols {
             view.window?.alert(message: "No DSYM File")
         }
         
         guard
             !isSymbolicating,
             let crashFile = crashFile,
-            let dsymFile = dsymFile
+            dsymFile != nil || hasCachedSymbols
         else { return }
         
         isSymbolicating = true
         
-        Symbolicator.symbolicate(crashFile: crashFile, dsymFile: dsymFile, errorHandler: { [weak self] (error) in
+        Symbolicator.symbolicate(crashFile: crashFile, dsymFile: self.dsymFile, errorHandler: { [weak self] (error) in
             
             DispatchQueue.main.async {
                 self?.view.window?.alert(message: error)
@@ -104,6 +115,11 @@ extension MainViewController {
         guard let crashFile = crashFile, let crashFileUUID = crashFile.uuid
             else { return }
         
+        if hasCachedSymbols {
+            dsymFileDropZoneView.setDetailText("Using cached symbols")
+            return
+        }
+        
         dsymFileDropZoneView.setDetailText("Searching…")
         
         DSYMSearch.search(forUUID: crashFileUUID.pretty, crashFileDirectory: crashFile.path?.deletingLastPathComponent().path, errorHandler: { (error) in
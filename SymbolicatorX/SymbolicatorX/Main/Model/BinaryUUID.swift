@@ -8,7 +8,7 @@
 
 import Foundation
 
-struct BinaryUUID: Equatable {
+struct BinaryUUID: Hashable {
     
     let raw: String
 
@@ -28,7 +28,19 @@ public struct CrashFile {
     var version: String?
     var buildVersion: String?
     var uuid: BinaryUUID?
-    var content: String = ""
+    var report: CrashReport?
+    /// The original payload of an .ips report; `content` holds its text translation.
+    var ipsContent: String?
+    /// An .ips report file on disk, left for the symbolicator to map
+    /// instead of held as `ipsContent`.
+    var ipsPath: URL?
+    /// The report text. Reports opened from a path keep it only in their
+    /// mapping and hand out a copy when asked.
+    var content: String {
+        get { return storedContent ?? report?.text ?? "" }
+        set { storedContent = newValue }
+    }
+    private var storedContent: String?
     var symbolicatedContent: String?
     var symbolicatedContentSaveURL: URL? {
         
@@ -42,26 +54,29 @@ public struct CrashFile {
     
     public init?(path: URL) {
         
-        guard
-            var content = try? String(contentsOf: path, encoding: .utf8),
-            content.trimmingCharacters(in: .whitespacesAndNewlines) != ""
-        else {
-            return nil
-        }
-        
-        if path.pathExtension == "ips" {
-            content = CrashTranslator.convertFromJSON(jsonFile: content)
-        }
-        
         self.path = path
         self.filename = path.lastPathComponent
+        
         if path.pathExtension == "crashinfo" {
+            guard
+                let content = try? String(contentsOf: path, encoding: .utf8),
+                content.trimmingCharacters(in: .whitespacesAndNewlines) != ""
+            else {
+                return nil
+            }
             self.crashFileType = .crashinfo
             crashInfoConfig(content: content)
-        }else{
-            self.crashFileType = .crash
-            config(content: content)
+            return
+        }
+        
+        // Mapped and parsed in place by libsymbolicator, which also rejects
+        // blank files and translates .ips ones.
+        guard let report = try? CrashReport(path: path) else { return nil }
+        if path.pathExtension == "ips" {
+            self.ipsPath = path
         }
+        self.crashFileType = .crash
+        config(report: report)
     }
     
     init?(file: FileModel) {
@@ -74,6 +89,7 @@ public struct CrashFile {
         }
         
         if file.pathExtension == "ips" {
+            self.ipsContent = content
             content = CrashTranslator.convertFromJSON(jsonFile: content)
         }
         
@@ -117,44 +133,34 @@ public struct CrashFile {
     
     private mutating func config(content: String) {
         self.content = content
-        self.processName = content.scan(pattern: "^Process:\\s+(.+?)\\[").first?.first?.trimmed
-        self.bundleIdentifier = content.scan(pattern: "^Identifier:\\s+(.+?)$").first?.first?.trimmed
-        self.architecture = content.scan(pattern: "^Code Type:(.*?)(\\(.*\\))?$").first?.first?.trimmed
-            .components(separatedBy: " ").first.flatMap(Architecture.init)
+        
+        guard let report = try? CrashReport(content: content) else { return }
+        config(report: report)
+    }
+    
+    private mutating func config(report: CrashReport) {
+        self.report = report
+        
+        self.processName = report.processName.nonEmpty
+        self.bundleIdentifier = report.identifier.nonEmpty
+        self.responsible = report.responsible.nonEmpty
+        self.version = report.version.nonEmpty
+        self.buildVersion = report.buildVersion.nonEmpty
+        self.architecture = report.codeType.components(separatedBy: " ").first.flatMap(Architecture.init)
 
         if self.architecture?.isIncomplete == true {
-            self.architecture = (content.scan(
-                pattern: "Binary Images:.*\\s+([^\\s]+)\\s+<",
-                options: [.caseInsensitive, .anchorsMatchLines, .dotMatchesLineSeparators]
-            ).first?.first?.trimmed).flatMap(Architecture.init)
+            let architectureColumn = report.mainImage?.architecture.nonEmpty
+                ?? report.images.last(where: { !$0.architecture.isEmpty })?.architecture
+            self.architecture = architectureColumn.flatMap(Architecture.init)
         }
 
-        //pattern: "Binary Images:.*?(0x.*?)\\s",
-        self.loadAddress = content.scan(
-            pattern: "^\\s*(0x[0-9a-fA-F]+)\\s+-\\s+0x[0-9a-fA-F]+[^\\n]+(\(bundleIdentifier ?? "")|\(processName ?? ""))\\s+.*?\\n",
-            options: [.caseInsensitive, .anchorsMatchLines, .dotMatchesLineSeparators]
-        ).first?.first?.trimmed
+        self.loadAddress = report.mainImage.map { String(format: "0x%llx", $0.start) }
         
-        let crashReportAddresses = content.scan(
-            pattern: "^\\d+\\s+(\(bundleIdentifier ?? "")|\(processName ?? "")).*?(0x.*?)\\s",
-            options: [.caseInsensitive, .anchorsMatchLines, .dotMatchesLineSeparators]
-        ).compactMap { $0.last }
+        let mainFrames = report.frames.filter { $0.isMainImage }
+        self.addresses = mainFrames.filter { $0.kind == .crash }.map { $0.address }
+            + mainFrames.filter { $0.kind == .sample }.map { $0.address }
         
-        let sampleAddresses = content.scan(
-            pattern: "\\?{3}\\s+\\(in\\s.*?\\)\\s+load\\saddress.*?\\[(0x.*?)\\]",
-            options: [.caseInsensitive, .anchorsMatchLines, .dotMatchesLineSeparators]
-        ).compactMap { $0.last }
-        
-        self.addresses = crashReportAddresses + sampleAddresses
-        
-        self.responsible = content.scan(pattern: "^Responsible:\\s+(.+?)\\[").first?.first?.trimmed
-        self.version = content.scan(pattern: "^Version:\\s+(.+?)\\(").first?.first?.trimmed
-        self.buildVersion = content.scan(pattern: "^Version:.+\\((.*?)\\)").first?.first?.trimmed
-        
-        self.uuid = (content.scan(
-            pattern: "Binary Images:.*?<(.*?)>",
-            options: [.caseInsensitive, .anchorsMatchLines, .dotMatchesLineSeparators]
-        ).first?.first?.trimmed).flatMap(BinaryUUID.init)
+        self.uuid = report.images.first(where: { !$0.uuid.isEmpty }).flatMap { BinaryUUID($0.uuid) }
     }
     
 }
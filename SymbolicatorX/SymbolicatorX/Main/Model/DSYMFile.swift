@@ -14,6 +14,11 @@ public struct DSYMFile {
     let filename: String
     var uuids: [Architecture: BinaryUUID]
     var binaryPath: String {
+        return DSYMFile.binaryPath(inBundle: path)
+    }
+    
+    /// The DWARF file inside a .dSYM bundle, or the path itself when it is not a bundle.
+    static func binaryPath(inBundle path: URL) -> String {
         
         let dwarfPath = path.appendingPathComponent("Contents").appendingPathComponent("Resources").appendingPathComponent("DWARF")
         
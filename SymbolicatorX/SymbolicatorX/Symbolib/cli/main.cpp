@@ -0,0 +1,767 @@
+//
+//  main.cpp
+//  symbolicatorx
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+//  Headless front end for build farms: symbolicates crash reports against
+//  dSYM directories with no dependency on Spotlight, AppKit or atos.
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "batch_symbolicator.hpp"
+#include "dsym_catalog.hpp"
+#include "frame_cache.hpp"
+#include "image.hpp"
+#include "index_cache.hpp"
+#include "symbol_store.hpp"
+#include "work_pool.hpp"
+
+using namespace symbolicator;
+
+namespace {
+
+constexpr uint64_t kDefaultCacheBytes = 1ull << 30;
+constexpr uint64_t kDefaultFrameCacheBytes = 64ull << 20;
+constexpr unsigned long kMaxDedupFrames = 512; ///< Deeper than any crashed thread.
+constexpr unsigned long kMaxBenchLookups = 100000000; ///< 800 MB of addresses.
+
+enum class Format {
+    Text,
+    JSON,
+    NDJSON, ///< One JSON record per line, streamed as reports finish.
+};
+
+struct Options {
+    std::vector<std::string> inputs;
+    std::vector<std::string> dsymRoots;
+    std::string outputDirectory;
+    std::string cacheDirectory;
+    Format format = Format::Text;
+    unsigned jobs = 0;
+    unsigned dedupFrames = 0;
+    bool useCache = true;
+    bool expandsInlines = false;
+    bool demangles = false;
+    bool printsTimings = false;
+};
+
+void usage(FILE *stream) {
+    std::fputs("usage: symbolicatorx [options] <report|directory>...\n"
+               "       symbolicatorx bench [-a <arch>] [-n <lookups>] <binary>\n"
+               "       symbolicatorx store [-a <arch>] <binary> <output.symstore>\n"
+               "       symbolicatorx prewarm [-j <n>] [--cache <dir>] <xcarchive|dSYM|directory>...\n"
+               "\n"
+               "Symbolicates .crash, .ips and text reports; directories are searched for\n"
+               "*.crash, *.ips and *.txt files. `store` writes the symbols of a binary as a\n"
+               "compressed symbol store, which -d finds like a dSYM. `prewarm` indexes every\n"
+               "binary and architecture below its arguments into the cache ahead of the\n"
+               "first report, and registers them in the dSYM catalog.\n"
+               "\n"
+               "  -d, --dsym <path>    search <path> for dSYMs and Mach-O binaries (repeatable)\n"
+               "  -o, --output <dir>   write one file per report into <dir> instead of stdout\n"
+               "  -f, --format <fmt>   text (default), json, or ndjson for one record per line\n"
+               "  -j, --jobs <n>       worker threads (default: one per core)\n"
+               "  -i, --inline         expand frames into the calls inlined at their address\n"
+               "  -C, --demangle       demangle Swift and C++ function names\n"
+               "      --dedup <n>      symbolicate one report per crash signature of <n> frames\n"
+               "                       and list the signatures to stderr\n"
+               "      --timings        print the time spent in each stage and the frame cache\n"
+               "                       hit rate and size to stderr\n"
+               "      --cache <dir>    symbol index cache (default: $XDG_CACHE_HOME/symbolicatorx)\n"
+               "      --no-cache       neither read nor write the symbol index cache\n"
+               "  -h, --help           show this help\n",
+               stream);
+}
+
+/// Parses a decimal count no greater than `maximum`. Unlike plain strtoul,
+/// rejects signs, leading spaces, trailing text and out-of-range values.
+bool parseCount(const std::string &text, unsigned long maximum, unsigned long &count) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text.front()))) {
+        return false;
+    }
+    errno = 0;
+    char *end = nullptr;
+    const unsigned long value = std::strtoul(text.c_str(), &end, 10);
+    if (errno == ERANGE || *end != '\0' || value > maximum) {
+        return false;
+    }
+    count = value;
+    return true;
+}
+
+/// Worker threads -j accepts, 0 meaning one per core.
+unsigned long maximumJobs() {
+    return 4ul * std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool hasSuffix(const std::string &string, const char *suffix) {
+    const size_t length = std::strlen(suffix);
+    return string.size() >= length && string.compare(string.size() - length, length, suffix) == 0;
+}
+
+std::string joinPath(const std::string &directory, const std::string &name) {
+    return !directory.empty() && directory.back() == '/' ? directory + name : directory + "/" + name;
+}
+
+std::string defaultCacheDirectory() {
+    if (const char *cache = std::getenv("XDG_CACHE_HOME"); cache != nullptr && *cache != '\0') {
+        return joinPath(cache, "symbolicatorx");
+    }
+    if (const char *home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+        return joinPath(joinPath(home, ".cache"), "symbolicatorx");
+    }
+    return std::string();
+}
+
+/// Returns 0 on success, otherwise the exit status to stop with.
+int parseOptions(int argc, char **argv, Options &options) {
+    for (int index = 1; index < argc; ++index) {
+        const std::string argument = argv[index];
+        auto value = [&](std::string &out) {
+            if (index + 1 >= argc) {
+                std::fprintf(stderr, "symbolicatorx: %s requires a value\n", argument.c_str());
+                return false;
+            }
+            out = argv[++index];
+            return true;
+        };
+
+        std::string text;
+        if (argument == "-h" || argument == "--help") {
+            usage(stdout);
+            return -1;
+        } else if (argument == "-d" || argument == "--dsym") {
+            if (!value(text)) {
+                return 2;
+            }
+            options.dsymRoots.push_back(text);
+        } else if (argument == "-o" || argument == "--output") {
+            if (!value(options.outputDirectory)) {
+                return 2;
+            }
+        } else if (argument == "-f" || argument == "--format") {
+            if (!value(text)) {
+                return 2;
+            }
+            if (text == "text") {
+                options.format = Format::Text;
+            } else if (text == "json") {
+                options.format = Format::JSON;
+            } else if (text == "ndjson") {
+                options.format = Format::NDJSON;
+            } else {
+                std::fprintf(stderr, "symbolicatorx: unknown format '%s'\n", text.c_str());
+                return 2;
+            }
+        } else if (argument == "-j" || argument == "--jobs") {
+            if (!value(text)) {
+                return 2;
+            }
+            unsigned long jobs = 0;
+            if (!parseCount(text, maximumJobs(), jobs)) {
+                std::fprintf(stderr, "symbolicatorx: invalid job count '%s' (at most %lu)\n", text.c_str(),
+                             maximumJobs());
+                return 2;
+            }
+            options.jobs = static_cast<unsigned>(jobs);
+        } else if (argument == "--dedup") {
+            if (!value(text)) {
+                return 2;
+            }
+            unsigned long frames = 0;
+            if (!parseCount(text, kMaxDedupFrames, frames) || frames == 0) {
+                std::fprintf(stderr, "symbolicatorx: invalid frame count '%s'\n", text.c_str());
+                return 2;
+            }
+            options.dedupFrames = static_cast<unsigned>(frames);
+        } else if (argument == "--cache") {
+            if (!value(options.cacheDirectory)) {
+                return 2;
+            }
+        } else if (argument == "--no-cache") {
+            options.useCache = false;
+        } else if (argument == "-i" || argument == "--inline") {
+            options.expandsInlines = true;
+        } else if (argument == "-C" || argument == "--demangle") {
+            options.demangles = true;
+        } else if (argument == "--timings") {
+            options.printsTimings = true;
+        } else if (argument == "--") {
+            for (++index; index < argc; ++index) {
+                options.inputs.push_back(argv[index]);
+            }
+        } else if (argument.size() > 1 && argument.front() == '-') {
+            std::fprintf(stderr, "symbolicatorx: unknown option '%s'\n", argument.c_str());
+            usage(stderr);
+            return 2;
+        } else {
+            options.inputs.push_back(argument);
+        }
+    }
+
+    if (options.inputs.empty()) {
+        usage(stderr);
+        return 2;
+    }
+    if (options.useCache && options.cacheDirectory.empty()) {
+        options.cacheDirectory = defaultCacheDirectory();
+    }
+    return 0;
+}
+
+/// Calls `visit` for every regular file below `path`, or for `path` itself.
+/// Symbolic links to directories are not followed, which keeps the walk
+/// finite on trees that link back into themselves.
+template <typename Visit>
+bool walk(const std::string &path, const Visit &visit, bool isRoot = true) {
+    struct stat info;
+    if ((isRoot ? ::stat(path.c_str(), &info) : ::lstat(path.c_str(), &info)) != 0) {
+        if (isRoot) {
+            std::fprintf(stderr, "symbolicatorx: %s: %s\n", path.c_str(), std::strerror(errno));
+        }
+        return isRoot ? false : true;
+    }
+    if (S_ISREG(info.st_mode)) {
+        return visit(path, static_cast<uint64_t>(info.st_size));
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        return true;
+    }
+
+    DIR *directory = ::opendir(path.c_str());
+    if (directory == nullptr) {
+        return true;
+    }
+    std::vector<std::string> children;
+    while (dirent *entry = ::readdir(directory)) {
+        if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+            children.push_back(joinPath(path, entry->d_name));
+        }
+    }
+    ::closedir(directory);
+
+    // Sorted so that the binary picked for a UUID does not depend on the
+    // order the file system lists entries in.
+    std::sort(children.begin(), children.end());
+    for (const auto &child : children) {
+        if (!walk(child, visit, false)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Registers the binaries the catalog knows for `missing`, after searching
+/// the dSYM roots for those it does not know in a dSYM yet. Only runs when
+/// something is missing, so a fully cached run never touches the roots, and
+/// the search stops once every missing UUID has turned up.
+void locate(DSYMCatalog &catalog, const Options &options, WorkPool &pool, const std::vector<ImageKey> &missing,
+            BatchSymbolicator &batch) {
+    if (options.dsymRoots.empty()) {
+        return;
+    }
+    std::vector<std::array<uint8_t, 16>> uuids;
+    uuids.reserve(missing.size());
+    for (const auto &key : missing) {
+        uuids.push_back(key.uuid);
+    }
+    catalog.search(uuids, options.dsymRoots, pool);
+    for (const auto &key : missing) {
+        const std::string path = catalog.find(key.uuid, key.arch.empty() ? nullptr : key.arch.c_str());
+        if (!path.empty()) {
+            batch.addBinary(key.uuid, path);
+        }
+    }
+}
+
+/// The .ips report with the resolved symbols filled into its frames.
+std::string symbolicatedIPS(const BatchSymbolicator::Result &result) {
+    std::vector<IPSSymbol> symbols;
+    symbols.reserve(result.frames.size());
+    for (const auto &frame : result.frames) {
+        symbols.push_back(frame.ipsSymbol());
+    }
+    return result.ips->json(result.source, symbols);
+}
+
+/// Largest buckets first: "<count> reports  <hash>  <first report>" and the
+/// signature indented below.
+void printBuckets(const std::vector<BatchSymbolicator::Bucket> &buckets, size_t reports) {
+    std::vector<const BatchSymbolicator::Bucket *> sorted;
+    for (const auto &bucket : buckets) {
+        sorted.push_back(&bucket);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto *left, const auto *right) {
+        return left->names.size() > right->names.size();
+    });
+    std::fprintf(stderr, "symbolicatorx: %zu reports in %zu signatures\n", reports, buckets.size());
+    for (const auto *bucket : sorted) {
+        std::fprintf(stderr, "%6zu  %016" PRIx64 "  %s\n", bucket->names.size(), bucket->signature.hash,
+                     bucket->names.front().c_str());
+        const std::string &text = bucket->signature.text;
+        for (size_t start = 0; start <= text.size();) {
+            const size_t end = std::min(text.find('\n', start), text.size());
+            std::fprintf(stderr, "        %.*s\n", static_cast<int>(end - start), text.data() + start);
+            start = end + 1;
+        }
+    }
+}
+
+/// "<dir>/<report name without extension>_symbolicated.<ext>".
+std::string outputPath(const Options &options, const std::string &name, const char *extension) {
+    const size_t slash = name.find_last_of('/');
+    std::string base = slash == std::string::npos ? name : name.substr(slash + 1);
+    const size_t dot = base.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) {
+        base.resize(dot);
+    }
+    base.append("_symbolicated.").append(extension);
+    return joinPath(options.outputDirectory, base);
+}
+
+bool writeFile(const std::string &path, const std::string &contents) {
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "symbolicatorx: %s: %s\n", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    const bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    const bool closed = std::fclose(file) == 0;
+    if (!written || !closed) {
+        std::fprintf(stderr, "symbolicatorx: %s: write failed\n", path.c_str());
+    }
+    return written && closed;
+}
+
+/// Nanoseconds per call of `resolve` over `addresses`, best of three runs.
+/// The checksum keeps the compiler from dropping the lookups.
+template <typename Resolve>
+double measure(const std::vector<uint64_t> &addresses, uint64_t &checksum, Resolve &&resolve) {
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t address : addresses) {
+            checksum += resolve(address);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double perLookup = elapsed.count() / static_cast<double>(addresses.size());
+        best = run == 0 ? perLookup : std::min(best, perLookup);
+    }
+    return best;
+}
+
+/// `symbolicatorx bench`: times opening a binary with and without deferred
+/// line tables, then function lookups in its symbol index against a
+/// std::map keyed by function start, on random addresses across its text.
+int runBench(int argc, char **argv) {
+    std::string arch;
+    std::string path;
+    size_t count = 1000000;
+    for (int index = 1; index < argc; ++index) {
+        const std::string argument = argv[index];
+        if ((argument == "-a" || argument == "--arch") && index + 1 < argc) {
+            arch = argv[++index];
+        } else if ((argument == "-n" || argument == "--lookups") && index + 1 < argc) {
+            const std::string text = argv[++index];
+            unsigned long lookups = 0;
+            if (!parseCount(text, kMaxBenchLookups, lookups) || lookups == 0) {
+                std::fprintf(stderr, "symbolicatorx: invalid lookup count '%s'\n", text.c_str());
+                return 2;
+            }
+            count = lookups;
+        } else if (path.empty() && !argument.empty() && argument.front() != '-') {
+            path = argument;
+        } else {
+            usage(stderr);
+            return 2;
+        }
+    }
+    if (path.empty() || count == 0) {
+        usage(stderr);
+        return 2;
+    }
+
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    Image image;
+    size_t lineRows = 0;
+    Milliseconds lazyOpenTime;
+    Milliseconds eagerOpenTime;
+    try {
+        const char *archOrNull = arch.empty() ? nullptr : arch.c_str();
+        auto start = std::chrono::steady_clock::now();
+        lineRows = Image::build(path, MachOFile::open(path, archOrNull)).index().arrays().lines.size;
+        eagerOpenTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        image = Image::open(path, archOrNull);
+        lazyOpenTime = std::chrono::steady_clock::now() - start;
+    } catch (const std::exception &error) {
+        std::fprintf(stderr, "symbolicatorx: %s\n", error.what());
+        return 1;
+    }
+    const SymbolIndex &index = image.index();
+    const SymbolIndex::Arrays &arrays = index.arrays();
+    if (arrays.functionStarts.empty()) {
+        std::fprintf(stderr, "symbolicatorx: %s: no functions\n", path.c_str());
+        return 1;
+    }
+
+    std::map<uint64_t, std::pair<uint64_t, uint32_t>> baseline;
+    for (size_t function = 0; function < arrays.functionStarts.size; ++function) {
+        baseline.emplace(arrays.functionStarts[function],
+                         std::make_pair(arrays.functionEnds[function], arrays.functionNames[function]));
+    }
+
+    // The last function of a symbol table without DWARF extends to the end
+    // of the address space, so addresses are drawn up to its start.
+    const uint64_t low = arrays.functionStarts[0];
+    const uint64_t high = arrays.functionStarts[arrays.functionStarts.size - 1];
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<uint64_t> distribution(low, high);
+    std::vector<uint64_t> addresses(count);
+    for (auto &address : addresses) {
+        address = distribution(random);
+    }
+
+    // The first lookup decodes the line table of the unit it lands in.
+    const auto firstStart = std::chrono::steady_clock::now();
+    const SymbolLookup first = index.lookup(arrays.functionStarts[arrays.functionStarts.size / 2]);
+    const Milliseconds firstLookupTime = std::chrono::steady_clock::now() - firstStart;
+
+    uint64_t indexSum = 0;
+    uint64_t mapSum = 0;
+    uint64_t lineSum = first.line;
+    const double indexTime = measure(addresses, indexSum, [&](uint64_t address) -> uint64_t {
+        const size_t function = index.findFunction(address);
+        return function < index.functionCount() ? arrays.functionNames[function] : 0;
+    });
+    const double mapTime = measure(addresses, mapSum, [&](uint64_t address) -> uint64_t {
+        auto found = baseline.upper_bound(address);
+        if (found == baseline.begin()) {
+            return 0;
+        }
+        --found;
+        return address < found->second.first ? found->second.second : 0;
+    });
+    const double lookupTime = measure(addresses, lineSum, [&](uint64_t address) -> uint64_t {
+        return index.lookup(address).line;
+    });
+
+    // The batch resolves all addresses in one call; it is timed per call
+    // and checked against the single lookups.
+    std::vector<SymbolLookup> batch(addresses.size());
+    double batchTime = 0;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        index.lookup(addresses.data(), addresses.size(), batch.data());
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double perLookup = elapsed.count() / static_cast<double>(addresses.size());
+        batchTime = run == 0 ? perLookup : std::min(batchTime, perLookup);
+    }
+    bool batchMatches = true;
+    for (size_t position = 0; position < addresses.size() && batchMatches; ++position) {
+        const SymbolLookup single = index.lookup(addresses[position]);
+        batchMatches = single.function == batch[position].function && single.line == batch[position].line;
+    }
+
+    if (indexSum != mapSum || !batchMatches) {
+        std::fprintf(stderr, "symbolicatorx: lookups disagree\n");
+        return 1;
+    }
+
+    const LazyLineTable *lazyLines = index.lazyLines();
+    std::printf("%s: %zu functions, %zu line rows in %zu units, %zu lookups\n", image.name().c_str(),
+                arrays.functionStarts.size, lineRows, lazyLines != nullptr ? lazyLines->unitCount() : 0,
+                addresses.size());
+    std::printf("  open           %8.1f ms, all line tables\n", eagerOpenTime.count());
+    std::printf("  open           %8.1f ms, line tables deferred\n", lazyOpenTime.count());
+    std::printf("  first lookup   %8.1f ms\n", firstLookupTime.count());
+    std::printf("  symbol index   %8.1f ns/lookup\n", indexTime);
+    std::printf("  std::map       %8.1f ns/lookup\n", mapTime);
+    if (lineSum != 0) {
+        std::printf("  with lines     %8.1f ns/lookup\n", lookupTime);
+    }
+    std::printf("  sorted batch   %8.1f ns/lookup\n", batchTime);
+    return 0;
+}
+
+/// `symbolicatorx store`: writes the symbol index of a binary as a symbol
+/// store and prints how much smaller it is.
+int runStore(int argc, char **argv) {
+    std::string arch;
+    std::vector<std::string> paths;
+    for (int index = 1; index < argc; ++index) {
+        const std::string argument = argv[index];
+        if ((argument == "-a" || argument == "--arch") && index + 1 < argc) {
+            arch = argv[++index];
+        } else if (paths.size() < 2 && !argument.empty() && argument.front() != '-') {
+            paths.push_back(argument);
+        } else {
+            usage(stderr);
+            return 2;
+        }
+    }
+    if (paths.size() != 2) {
+        usage(stderr);
+        return 2;
+    }
+
+    try {
+        const MachOFile file = MachOFile::open(paths[0], arch.empty() ? nullptr : arch.c_str());
+        const Image image = Image::build(paths[0], file);
+        writeSymbolStore(paths[1], image);
+    } catch (const std::exception &error) {
+        std::fprintf(stderr, "symbolicatorx: %s\n", error.what());
+        return 1;
+    }
+
+    struct stat binary;
+    struct stat store;
+    if (::stat(paths[0].c_str(), &binary) == 0 && ::stat(paths[1].c_str(), &store) == 0 && binary.st_size > 0) {
+        std::printf("%s: %lld bytes, %.1f%% of %lld\n", paths[1].c_str(), static_cast<long long>(store.st_size),
+                    100.0 * static_cast<double>(store.st_size) / static_cast<double>(binary.st_size),
+                    static_cast<long long>(binary.st_size));
+    }
+    return 0;
+}
+
+/// `symbolicatorx prewarm`: registers the binaries below its arguments in
+/// the dSYM catalog and builds the cached index of each UUID and
+/// architecture in parallel, so the first report of a build finds them.
+int runPrewarm(int argc, char **argv) {
+    std::vector<std::string> roots;
+    std::string cacheDirectory;
+    unsigned jobs = 0;
+    for (int index = 1; index < argc; ++index) {
+        const std::string argument = argv[index];
+        if ((argument == "-j" || argument == "--jobs") && index + 1 < argc) {
+            const std::string text = argv[++index];
+            unsigned long count = 0;
+            if (!parseCount(text, maximumJobs(), count)) {
+                std::fprintf(stderr, "symbolicatorx: invalid job count '%s' (at most %lu)\n", text.c_str(),
+                             maximumJobs());
+                return 2;
+            }
+            jobs = static_cast<unsigned>(count);
+        } else if (argument == "--cache" && index + 1 < argc) {
+            cacheDirectory = argv[++index];
+        } else if (!argument.empty() && (argument.size() == 1 || argument.front() != '-')) {
+            roots.push_back(argument);
+        } else {
+            usage(stderr);
+            return 2;
+        }
+    }
+    if (roots.empty()) {
+        usage(stderr);
+        return 2;
+    }
+    if (cacheDirectory.empty()) {
+        cacheDirectory = defaultCacheDirectory();
+    }
+    if (cacheDirectory.empty()) {
+        std::fprintf(stderr, "symbolicatorx: no cache directory; pass --cache\n");
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    IndexCache cache(cacheDirectory, kDefaultCacheBytes);
+    DSYMCatalog catalog(joinPath(cacheDirectory, "dsym.catalog"));
+    WorkPool pool(jobs);
+    catalog.refresh(roots, pool);
+
+    std::atomic<size_t> built {0};
+    std::atomic<size_t> cached {0};
+    std::mutex errorMutex;
+    std::vector<std::string> errors;
+    for (const auto &slice : catalog.slices(roots)) {
+        const char *arch = slice.architecture.name();
+        if (arch == nullptr) {
+            continue;
+        }
+        // The catalog picks the dSYM over the binary with the same UUID.
+        const std::string path = catalog.find(slice.uuid, arch);
+        if (path.empty()) {
+            continue;
+        }
+        pool.submit([&, arch, path, uuid = slice.uuid] {
+            try {
+                if (cache.find(uuid, arch) != nullptr) {
+                    ++cached;
+                    return;
+                }
+                cache.open(path, arch);
+                ++built;
+            } catch (const std::exception &error) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                errors.push_back(path + " (" + arch + "): " + error.what());
+            }
+        });
+    }
+    pool.wait();
+
+    std::sort(errors.begin(), errors.end());
+    for (const auto &error : errors) {
+        std::fprintf(stderr, "symbolicatorx: %s\n", error.c_str());
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%zu indexes built, %zu already cached, %zu failed in %.2fs (%s)\n", built.load(), cached.load(),
+                errors.size(), elapsed.count(), cacheDirectory.c_str());
+    return errors.empty() ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::strcmp(argv[1], "bench") == 0) {
+        return runBench(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "store") == 0) {
+        return runStore(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "prewarm") == 0) {
+        return runPrewarm(argc - 1, argv + 1);
+    }
+
+    Options options;
+    if (const int status = parseOptions(argc, argv, options); status != 0) {
+        return status < 0 ? 0 : status;
+    }
+
+    std::vector<std::string> reports;
+    bool failed = false;
+    for (const auto &input : options.inputs) {
+        struct stat info;
+        const bool isDirectory = ::stat(input.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+        failed |= !walk(input, [&](const std::string &path, uint64_t) {
+            if (!isDirectory || hasSuffix(path, ".crash") || hasSuffix(path, ".ips") || hasSuffix(path, ".txt")) {
+                reports.push_back(path);
+            }
+            return true;
+        });
+    }
+
+    if (!options.outputDirectory.empty() && ::mkdir(options.outputDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::fprintf(stderr, "symbolicatorx: %s: %s\n", options.outputDirectory.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    std::shared_ptr<IndexCache> cache;
+    if (options.useCache && !options.cacheDirectory.empty()) {
+        cache = std::make_shared<IndexCache>(options.cacheDirectory, kDefaultCacheBytes);
+    }
+
+    // The catalog of the dSYM roots and the resolved frames are kept next
+    // to the indexes they lead to.
+    DSYMCatalog catalog(cache != nullptr ? joinPath(options.cacheDirectory, "dsym.catalog") : std::string());
+    auto frames = std::make_shared<FrameCache>(cache != nullptr ? joinPath(options.cacheDirectory, "frames.cache") : std::string(),
+                                               kDefaultFrameCacheBytes);
+
+    WorkPool pool(options.jobs);
+    BatchSymbolicator batch(pool, cache);
+    batch.setRendersText(options.format == Format::Text);
+    batch.setRendersJSON(options.format != Format::Text);
+    batch.setExpandsInlines(options.expandsInlines);
+    batch.setDemangles(options.demangles);
+    batch.setDeduplicates(options.dedupFrames);
+    batch.setFrameCache(frames);
+    for (const auto &path : reports) {
+        batch.addReportFile(path);
+    }
+
+    const bool toStdout = options.outputDirectory.empty();
+    const bool jsonArray = toStdout && options.format == Format::JSON;
+    size_t delivered = 0;
+    if (jsonArray) {
+        std::fputs("[", stdout);
+    }
+
+    try {
+        batch.run(
+            [&](const std::vector<ImageKey> &missing) { locate(catalog, options, pool, missing, batch); },
+            [&](BatchSymbolicator::Result &&result) {
+                if (!result.error.empty()) {
+                    std::fprintf(stderr, "symbolicatorx: %s: %s\n", result.name.c_str(), result.error.c_str());
+                    failed = true;
+                    if (options.format == Format::Text) {
+                        return;
+                    }
+                }
+
+                // Written to a file, a symbolicated .ips stays an .ips.
+                const bool isJSON = options.format != Format::Text;
+                const bool writesIPS = !toStdout && isJSON && result.ips != nullptr;
+                std::string output = writesIPS ? symbolicatedIPS(result)
+                                     : isJSON  ? std::move(result.json)
+                                               : std::move(result.output);
+                const char *extension = writesIPS ? "ips" : isJSON ? "json" : "crash";
+                if (toStdout) {
+                    if (jsonArray) {
+                        std::fputs(delivered == 0 ? "\n" : ",\n", stdout);
+                    } else if (options.format == Format::NDJSON) {
+                        output.push_back('\n');
+                    } else if (delivered > 0) {
+                        std::fputc('\n', stdout);
+                    }
+                    std::fwrite(output.data(), 1, output.size(), stdout);
+                } else if (!writeFile(outputPath(options, result.name, extension), output)) {
+                    failed = true;
+                }
+                ++delivered;
+            });
+    } catch (const std::exception &error) {
+        std::fprintf(stderr, "symbolicatorx: %s\n", error.what());
+        return 1;
+    }
+
+    if (jsonArray) {
+        std::fputs(delivered == 0 ? "]\n" : "\n]\n", stdout);
+    }
+    if (options.dedupFrames > 0) {
+        printBuckets(batch.buckets(), reports.size());
+    }
+    if (options.printsTimings) {
+        const BatchSymbolicator::Timings &timings = batch.timings();
+        std::fprintf(stderr,
+                     "symbolicatorx: parse %.3fs, locate %.3fs, load %.3fs, dedup %.3fs, resolve %.3fs (demangle %.3fs)\n",
+                     timings.parse, timings.locate, timings.load, timings.deduplicate, timings.resolve,
+                     timings.demangle);
+        const FrameCache::Stats stats = frames->stats();
+        std::fprintf(stderr, "symbolicatorx: frame cache %llu/%llu hits (%.1f%%), %zu frames, %.1f MiB\n",
+                     static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.lookups),
+                     stats.lookups > 0 ? 100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.lookups) : 0.0,
+                     stats.frames, static_cast<double>(stats.bytes) / (1 << 20));
+    }
+    if (cache != nullptr && !reports.empty()) {
+        try {
+            cache->trim();
+        } catch (const std::exception &) {
+        }
+        try {
+            frames->save();
+        } catch (const std::exception &) {
+        }
+    }
+    return failed ? 1 : 0;
+}
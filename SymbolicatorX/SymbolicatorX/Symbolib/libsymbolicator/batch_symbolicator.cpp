@@ -0,0 +1,632 @@
+//
+//  batch_symbolicator.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "batch_symbolicator.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "error.hpp"
+#include "mapped_file.hpp"
+#include "pipeline.hpp"
+#include "report_json.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+/// Builds the lookup key for the image a frame falls into, or returns false
+/// when the image table gives nothing to look symbols up by.
+bool keyFor(const CrashReport &report, const ReportImage &image, ImageKey &key) {
+    if (!parseUUID(image.uuid, key.uuid)) {
+        return false;
+    }
+    key.arch = report.architecture(image);
+    return true;
+}
+
+bool keyFor(const IPSReport &report, const IPSImage &image, ImageKey &key) {
+    if (!parseUUID(image.uuid, key.uuid)) {
+        return false;
+    }
+    key.arch = report.architecture(image);
+    return true;
+}
+
+const char *archOrNull(const ImageKey &key) {
+    return key.arch.empty() ? nullptr : key.arch.c_str();
+}
+
+/// Report files smaller than this are copied out of their mapping, which
+/// costs little next to the whole pages a mapping pins, and bounds the
+/// mappings a batch of many thousand reports holds at once.
+constexpr size_t kMinimumMappedReport = 64 * 1024;
+
+/// Report text kept parsed from the first pass to the last; the parsed
+/// tables take about twice as much again. Reports past it are read and
+/// parsed again in each pass instead, so a directory of tens of thousands
+/// of logs costs a bounded amount of memory plus what is in flight.
+constexpr size_t kRetainedReportBytes = 32 << 20;
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+BatchSymbolicator::BatchSymbolicator(WorkPool &pool, std::shared_ptr<IndexCache> cache)
+    : pool_(pool), cache_(std::move(cache)) {}
+
+void BatchSymbolicator::addReport(std::string name, std::string text) {
+    auto entry = std::make_unique<Entry>();
+    entry->name = std::move(name);
+    entry->ownedText = std::move(text);
+    entry->text = entry->ownedText;
+    entries_.push_back(std::move(entry));
+}
+
+void BatchSymbolicator::addReportFile(std::string path) {
+    auto entry = std::make_unique<Entry>();
+    entry->name = path;
+    entry->path = std::move(path);
+    entries_.push_back(std::move(entry));
+}
+
+void BatchSymbolicator::addBinary(const std::array<uint8_t, 16> &uuid, std::string path) {
+    binaries_[uuid] = std::move(path);
+}
+
+void BatchSymbolicator::read(Entry &entry) {
+    if (entry.isParsed || entry.path.empty() || !entry.error.empty()) {
+        return;
+    }
+    try {
+        entry.file = MappedFile::open(entry.path);
+        const std::string_view mapped(reinterpret_cast<const char *>(entry.file.data()), entry.file.size());
+        if (mapped.size() < kMinimumMappedReport) {
+            entry.ownedText.assign(mapped);
+            entry.file = MappedFile();
+            entry.text = entry.ownedText;
+        } else {
+            entry.file.prefetch();
+            entry.text = mapped;
+        }
+    } catch (const std::exception &error) {
+        entry.error = error.what();
+    }
+}
+
+void BatchSymbolicator::parse(Entry &entry) {
+    if (entry.isParsed || !entry.error.empty()) {
+        return;
+    }
+    try {
+        // .ips frames name their image and offset outright, so they are
+        // resolved from the payload instead of a translated text report.
+        entry.isIPS = isIPS(entry.text);
+        if (entry.isIPS) {
+            entry.ips = IPSReport::parse(entry.text);
+        } else {
+            entry.report = CrashReport::parse(entry.text);
+        }
+        entry.isParsed = true;
+    } catch (const std::exception &error) {
+        entry.error = error.what();
+    }
+}
+
+void BatchSymbolicator::unload(Entry &entry) {
+    entry.ips = IPSReport();
+    entry.report = CrashReport();
+    entry.isParsed = false;
+    if (!entry.path.empty()) {
+        entry.text = std::string_view();
+        entry.ownedText = std::string();
+        entry.file = MappedFile();
+    }
+}
+
+std::vector<ImageKey> BatchSymbolicator::usedImages(const Entry &entry) {
+    // Only images that frames actually point into are worth loading.
+    std::vector<ImageKey> keys;
+    if (!entry.isParsed) {
+        return keys;
+    }
+    if (entry.isIPS) {
+        const IPSReport &report = entry.ips;
+        std::vector<bool> used(report.images().size(), false);
+        for (const auto &frame : report.frames()) {
+            if (report.image(frame) != nullptr) {
+                used[static_cast<size_t>(frame.imageIndex)] = true;
+            }
+        }
+        for (size_t index = 0; index < report.images().size(); ++index) {
+            ImageKey key;
+            if (used[index] && keyFor(report, report.images()[index], key)) {
+                keys.push_back(std::move(key));
+            }
+        }
+        return keys;
+    }
+
+    const CrashReport &report = entry.report;
+    std::vector<bool> used(report.images.size(), false);
+    for (const auto &frame : report.frames) {
+        if (frame.image >= 0) {
+            used[frame.image] = true;
+        }
+    }
+    for (size_t index = 0; index < report.images.size(); ++index) {
+        ImageKey key;
+        if (used[index] && keyFor(report, report.images[index], key)) {
+            keys.push_back(std::move(key));
+        }
+    }
+    return keys;
+}
+
+std::shared_ptr<const Image> BatchSymbolicator::load(const ImageKey &key, const std::string &path) const {
+    try {
+        std::shared_ptr<const Image> image = cache_ != nullptr ? cache_->open(path, archOrNull(key))
+                                                               : std::make_shared<const Image>(Image::open(path, archOrNull(key)));
+        // A dSYM registered for one slice must not symbolicate another.
+        return image->uuid() == key.uuid ? image : nullptr;
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+bool BatchSymbolicator::cached(const Image &image, uint64_t fileAddress, ResolvedFrame &resolved) const {
+    CachedFrame frame;
+    if (frames_ == nullptr || !frames_->find(FrameKey(image, fileAddress, expandsInlines_), frame)) {
+        return false;
+    }
+    resolved.image = &image;
+    resolved.lookup = frame.lookup;
+    resolved.inlined = std::move(frame.inlined);
+    finish(fileAddress, resolved);
+    return true;
+}
+
+void BatchSymbolicator::finish(uint64_t fileAddress, ResolvedFrame &resolved) const {
+    resolved.symbolOffset = fileAddress - resolved.lookup.functionStart;
+    if (demangles_) {
+        demangle(resolved);
+    }
+}
+
+void BatchSymbolicator::lookup(const Image &image, uint64_t fileAddress, ResolvedFrame &resolved) const {
+    if (cached(image, fileAddress, resolved)) {
+        return;
+    }
+    resolved.image = &image;
+    if (expandsInlines_) {
+        image.index().lookupInlined(fileAddress, resolved.inlined);
+        resolved.lookup = resolved.inlined.back();
+        resolved.inlined.pop_back();
+    } else {
+        resolved.lookup = image.index().lookup(fileAddress);
+    }
+    // Cached before demangling, so the cache holds the names as the index
+    // has them whatever the batch's settings.
+    if (frames_ != nullptr) {
+        frames_->insert(FrameKey(image, fileAddress, expandsInlines_), resolved.lookup, resolved.inlined);
+    }
+    finish(fileAddress, resolved);
+}
+
+void BatchSymbolicator::lookupAll(const std::vector<const Image *> &images, const std::vector<uint64_t> &fileAddresses,
+                                  std::vector<ResolvedFrame> &frames) const {
+    if (expandsInlines_) {
+        for (size_t index = 0; index < frames.size(); ++index) {
+            if (images[index] != nullptr) {
+                lookup(*images[index], fileAddresses[index], frames[index]);
+            }
+        }
+        return;
+    }
+
+    // Each image resolves all of its frames in one call, so the big batches
+    // of sample and spindump reports take the index's sorted sweep.
+    std::map<const Image *, std::vector<size_t>> framesByImage;
+    for (size_t index = 0; index < frames.size(); ++index) {
+        if (images[index] != nullptr && !cached(*images[index], fileAddresses[index], frames[index])) {
+            framesByImage[images[index]].push_back(index);
+        }
+    }
+    std::vector<uint64_t> addresses;
+    std::vector<SymbolLookup> lookups;
+    for (const auto &group : framesByImage) {
+        addresses.clear();
+        for (size_t index : group.second) {
+            addresses.push_back(fileAddresses[index]);
+        }
+        lookups.resize(addresses.size());
+        group.first->index().lookup(addresses.data(), addresses.size(), lookups.data());
+        for (size_t position = 0; position < group.second.size(); ++position) {
+            ResolvedFrame &resolved = frames[group.second[position]];
+            resolved.image = group.first;
+            resolved.lookup = lookups[position];
+            if (frames_ != nullptr) {
+                frames_->insert(FrameKey(*group.first, addresses[position], false), resolved.lookup, {});
+            }
+            finish(addresses[position], resolved);
+        }
+    }
+}
+
+void BatchSymbolicator::demangle(ResolvedFrame &resolved) const {
+    const Clock::time_point start = Clock::now();
+    if (resolved.lookup.function != nullptr) {
+        resolved.lookup.function = demangled_.demangle(resolved.lookup.function);
+    }
+    for (auto &call : resolved.inlined) {
+        if (call.function != nullptr) {
+            call.function = demangled_.demangle(call.function);
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    demangleNanoseconds_.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+}
+
+std::vector<const Image *> BatchSymbolicator::symbolsFor(const CrashReport &report) const {
+    std::vector<const Image *> symbols(report.images.size(), nullptr);
+    for (size_t index = 0; index < report.images.size(); ++index) {
+        ImageKey key;
+        if (keyFor(report, report.images[index], key)) {
+            auto found = images_.find(key);
+            symbols[index] = found != images_.end() ? found->second.get() : nullptr;
+        }
+    }
+    return symbols;
+}
+
+std::vector<const Image *> BatchSymbolicator::symbolsFor(const IPSReport &report) const {
+    std::vector<const Image *> symbols(report.images().size(), nullptr);
+    for (size_t index = 0; index < report.images().size(); ++index) {
+        ImageKey key;
+        if (keyFor(report, report.images()[index], key)) {
+            auto found = images_.find(key);
+            symbols[index] = found != images_.end() ? found->second.get() : nullptr;
+        }
+    }
+    return symbols;
+}
+
+void BatchSymbolicator::addSignatureFrame(SignatureBuilder &builder, std::string_view imageName, const Image *image,
+                                          uint64_t fileAddress, std::string_view reported, uint64_t offset) const {
+    // The outermost function: which calls were inlined into it is a detail
+    // of the build, not of the crash.
+    if (image != nullptr) {
+        const char *function = image->index().lookup(fileAddress).function;
+        if (function != nullptr && builder.addFunction(imageName, demangles_ ? demangled_.demangle(function) : function)) {
+            return;
+        }
+    }
+    if (!builder.addFunction(imageName, reported)) {
+        builder.addOffset(imageName, offset);
+    }
+}
+
+bool BatchSymbolicator::signature(const Entry &entry, CrashSignature &signature) const {
+    if (entry.isIPS) {
+        const IPSReport &report = entry.ips;
+        const IPSHeader &header = report.header();
+        std::string exceptionType(header.exceptionType);
+        if (!header.exceptionSignal.empty()) {
+            exceptionType.append(" (").append(header.exceptionSignal).append(")");
+        }
+        // Reports without a triggered thread fall back to the first one.
+        const IPSThread *crashed = nullptr;
+        for (const auto &thread : report.threads()) {
+            if (crashed == nullptr || (thread.triggered && !crashed->triggered)) {
+                crashed = &thread;
+            }
+        }
+        if (crashed == nullptr) {
+            return false;
+        }
+
+        const std::vector<const Image *> symbols = symbolsFor(report);
+        SignatureBuilder builder(exceptionType);
+        const size_t count = std::min(crashed->frameCount, deduplicates_);
+        for (size_t index = crashed->firstFrame; index < crashed->firstFrame + count; ++index) {
+            const IPSFrame &frame = report.frames()[index];
+            const IPSImage *reportImage = frame.hasMembers ? report.image(frame) : nullptr;
+            const Image *image = reportImage != nullptr ? symbols[static_cast<size_t>(frame.imageIndex)] : nullptr;
+            addSignatureFrame(builder, reportImage != nullptr ? reportImage->name : "???", image,
+                              image != nullptr ? image->textAddress() + frame.imageOffset : 0,
+                              frame.hasSymbolName ? frame.symbol : std::string_view(), frame.imageOffset);
+        }
+        if (builder.frameCount() == 0) {
+            return false;
+        }
+        signature = builder.finish();
+        return true;
+    }
+
+    const CrashReport &report = entry.report;
+    int32_t crashed = report.crashedThread;
+    for (size_t index = 0; crashed < 0 && index < report.frames.size(); ++index) {
+        crashed = report.frames[index].thread;
+    }
+    if (crashed < 0) {
+        return false;
+    }
+
+    const std::vector<const Image *> symbols = symbolsFor(report);
+    SignatureBuilder builder(report.exceptionType);
+    for (size_t index = 0; index < report.frames.size() && builder.frameCount() < deduplicates_; ++index) {
+        const ReportFrame &frame = report.frames[index];
+        if (frame.thread != crashed || frame.kind != ReportFrameKind::Crash) {
+            continue;
+        }
+        const Image *image = frame.image >= 0 ? symbols[frame.image] : nullptr;
+        const uint64_t offset = frame.image >= 0 ? frame.addressValue - report.images[frame.image].start : frame.addressValue;
+        addSignatureFrame(builder, frame.imageName, image, image != nullptr ? offset + image->textAddress() : 0,
+                          entry.text.substr(frame.symbolOffset, frame.symbolLength), offset);
+    }
+    if (builder.frameCount() == 0) {
+        return false;
+    }
+    signature = builder.finish();
+    return true;
+}
+
+void BatchSymbolicator::deduplicate() {
+    SignatureBuckets buckets;
+    runPipeline<size_t, bool>(
+        pool_, entries_.size(),
+        [this](size_t index) {
+            read(*entries_[index]);
+            return index;
+        },
+        [this, &buckets](size_t index) {
+            Entry &entry = *entries_[index];
+            parse(entry);
+            CrashSignature found;
+            try {
+                if (entry.isParsed && signature(entry, found)) {
+                    buckets.add(std::move(found), index);
+                }
+            } catch (const std::exception &) {
+                // Left in no bucket; the resolve pass reports the failure.
+            }
+            if (!entry.isRetained) {
+                unload(entry);
+            }
+            return true;
+        },
+        [](bool) {});
+
+    for (auto &bucket : buckets.take()) {
+        Bucket &taken = buckets_.emplace_back();
+        taken.signature = std::move(bucket.signature);
+        for (size_t member : bucket.members) {
+            Entry &entry = *entries_[member];
+            taken.names.push_back(entry.name);
+            entry.isDuplicate = member != bucket.members.front();
+        }
+        entries_[bucket.members.front()]->bucket = static_cast<ptrdiff_t>(buckets_.size() - 1);
+    }
+}
+
+void BatchSymbolicator::resolveReport(const Entry &entry, Result &result) const {
+    const CrashReport &report = entry.report;
+    const std::vector<const Image *> symbols = symbolsFor(report);
+
+    std::vector<const Image *> frameImages(report.frames.size(), nullptr);
+    std::vector<uint64_t> fileAddresses(report.frames.size(), 0);
+    for (size_t index = 0; index < report.frames.size(); ++index) {
+        const ReportFrame &frame = report.frames[index];
+        const Image *image = frame.image >= 0 ? symbols[frame.image] : nullptr;
+        if (image != nullptr) {
+            frameImages[index] = image;
+            fileAddresses[index] = frame.addressValue - report.images[frame.image].start + image->textAddress();
+        }
+    }
+    result.frames.resize(report.frames.size());
+    lookupAll(frameImages, fileAddresses, result.frames);
+
+    std::vector<std::string> descriptions(rendersText_ ? report.frames.size() : 0);
+    std::vector<std::string_view> replacements(descriptions.size());
+    for (size_t index = 0; index < report.frames.size(); ++index) {
+        const ReportFrame &frame = report.frames[index];
+        const Image *image = frameImages[index];
+        if (image == nullptr) {
+            continue;
+        }
+        const uint64_t loadAddress = report.images[frame.image].start;
+        const ResolvedFrame &resolved = result.frames[index];
+        if (rendersText_) {
+            // One '\n' separated entry per inlined call; `render` repeats the line.
+            std::string &description = descriptions[index];
+            for (const auto &call : resolved.inlined) {
+                description += image->describe(call, loadAddress, frame.addressValue, frame.address);
+                description.push_back('\n');
+            }
+            description += image->describe(resolved.lookup, loadAddress, frame.addressValue, frame.address);
+            replacements[index] = description;
+        }
+        ++result.resolvedFrames;
+    }
+    if (rendersText_) {
+        result.output = report.render(entry.text, replacements);
+    }
+    result.report = &report;
+}
+
+void BatchSymbolicator::resolveIPS(const Entry &entry, Result &result) const {
+    const IPSReport &report = entry.ips;
+    const std::vector<const Image *> symbols = symbolsFor(report);
+
+    std::vector<const Image *> frameImages(report.frames().size(), nullptr);
+    std::vector<uint64_t> fileAddresses(report.frames().size(), 0);
+    for (size_t index = 0; index < report.frames().size(); ++index) {
+        const IPSFrame &frame = report.frames()[index];
+        const IPSImage *reportImage = frame.hasMembers ? report.image(frame) : nullptr;
+        const Image *image = reportImage != nullptr ? symbols[static_cast<size_t>(frame.imageIndex)] : nullptr;
+        if (image != nullptr) {
+            frameImages[index] = image;
+            fileAddresses[index] = image->textAddress() + frame.imageOffset;
+        }
+    }
+    result.frames.resize(report.frames().size());
+    lookupAll(frameImages, fileAddresses, result.frames);
+
+    std::vector<IPSSymbol> frameSymbols(rendersText_ ? report.frames().size() : 0);
+    for (size_t index = 0; index < report.frames().size(); ++index) {
+        if (frameImages[index] == nullptr) {
+            continue;
+        }
+        if (rendersText_) {
+            frameSymbols[index] = result.frames[index].ipsSymbol();
+        }
+        ++result.resolvedFrames;
+    }
+    if (rendersText_) {
+        result.output = report.text(frameSymbols);
+    }
+    result.ips = &report;
+}
+
+BatchSymbolicator::Result BatchSymbolicator::resolve(const Entry &entry) const {
+    Result result;
+    result.name = entry.name;
+    result.bucket = entry.bucket >= 0 ? &buckets_[static_cast<size_t>(entry.bucket)] : nullptr;
+
+    if (entry.error.empty()) {
+        try {
+            result.source = entry.text;
+            if (entry.isIPS) {
+                resolveIPS(entry, result);
+            } else {
+                resolveReport(entry, result);
+            }
+        } catch (const std::exception &error) {
+            result.error = error.what();
+        }
+    } else {
+        result.error = entry.error;
+    }
+    if (rendersJSON_) {
+        JSONWriter writer(result.json);
+        writeReportJSON(writer, result);
+    }
+    return result;
+}
+
+void BatchSymbolicator::release(Entry &entry) {
+    // Reports added as text keep it, and the rest of the state goes, so the
+    // next run reads and parses every report again.
+    unload(entry);
+    entry.error.clear();
+    entry.bucket = -1;
+    entry.isDuplicate = false;
+}
+
+void BatchSymbolicator::run(const Locate &locate, const Deliver &deliver) {
+    timings_ = Timings();
+    demangleNanoseconds_ = 0;
+
+    // First pass: the images every report needs, collected on the calling
+    // thread as reports come out of the parser.
+    Clock::time_point start = Clock::now();
+    size_t retainedBytes = 0;
+    runPipeline<Entry *, std::pair<Entry *, std::vector<ImageKey>>>(
+        pool_, entries_.size(),
+        [this](size_t index) {
+            read(*entries_[index]);
+            return entries_[index].get();
+        },
+        [](Entry *entry) {
+            parse(*entry);
+            return std::make_pair(entry, usedImages(*entry));
+        },
+        [this, &retainedBytes](std::pair<Entry *, std::vector<ImageKey>> &&scanned) {
+            for (auto &key : scanned.second) {
+                images_.emplace(std::move(key), nullptr);
+            }
+            Entry &entry = *scanned.first;
+            entry.isRetained = retainedBytes + entry.text.size() <= kRetainedReportBytes;
+            if (entry.isRetained) {
+                retainedBytes += entry.text.size();
+            } else {
+                unload(entry);
+            }
+        });
+    timings_.parse = secondsSince(start);
+
+    start = Clock::now();
+    std::vector<ImageKey> missing;
+    for (auto &image : images_) {
+        if (cache_ != nullptr) {
+            image.second = cache_->find(image.first.uuid, archOrNull(image.first));
+        }
+        if (image.second == nullptr && binaries_.count(image.first.uuid) == 0) {
+            missing.push_back(image.first);
+        }
+    }
+    if (!missing.empty() && locate) {
+        locate(missing);
+    }
+    timings_.locate = secondsSince(start);
+
+    // Each slot is written by exactly one task; the map itself is not modified.
+    start = Clock::now();
+    for (auto &image : images_) {
+        auto binary = binaries_.find(image.first.uuid);
+        if (image.second == nullptr && binary != binaries_.end()) {
+            auto *slot = &image;
+            const std::string *path = &binary->second;
+            pool_.submit([this, slot, path] { slot->second = load(slot->first, *path); });
+        }
+    }
+    pool_.wait();
+    timings_.load = secondsSince(start);
+
+    buckets_.clear();
+    if (deduplicates_ > 0) {
+        start = Clock::now();
+        deduplicate();
+        timings_.deduplicate = secondsSince(start);
+    }
+
+    // Last pass: each report is delivered, then released, as soon as it is
+    // resolved. Duplicates are dropped unread.
+    start = Clock::now();
+    runPipeline<Entry *, std::pair<Entry *, Result>>(
+        pool_, entries_.size(),
+        [this](size_t index) {
+            Entry &entry = *entries_[index];
+            if (!entry.isDuplicate) {
+                read(entry);
+            }
+            return &entry;
+        },
+        [this](Entry *entry) {
+            if (entry->isDuplicate) {
+                return std::make_pair(entry, Result());
+            }
+            parse(*entry);
+            return std::make_pair(entry, resolve(*entry));
+        },
+        [&deliver](std::pair<Entry *, Result> &&resolved) {
+            Entry &entry = *resolved.first;
+            if (!entry.isDuplicate) {
+                deliver(std::move(resolved.second));
+            }
+            release(entry);
+        });
+    timings_.resolve = secondsSince(start);
+    timings_.demangle = static_cast<double>(demangleNanoseconds_.load()) * 1e-9;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,231 @@
+//
+//  batch_symbolicator.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_BATCH_SYMBOLICATOR_HPP
+#define SYMBOLICATOR_BATCH_SYMBOLICATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "crash_report.hpp"
+#include "crash_signature.hpp"
+#include "demangler.hpp"
+#include "frame_cache.hpp"
+#include "image.hpp"
+#include "index_cache.hpp"
+#include "ips_report.hpp"
+#include "mapped_file.hpp"
+#include "work_pool.hpp"
+
+namespace symbolicator {
+
+/// Identifies the symbols one group of frames is resolved against.
+struct ImageKey {
+    std::array<uint8_t, 16> uuid {};
+    std::string arch; ///< Empty for "the only slice".
+
+    bool operator<(const ImageKey &other) const {
+        return std::tie(uuid, arch) < std::tie(other.uuid, other.arch);
+    }
+};
+
+/// Symbolicates many reports at once. Reports are parsed in parallel, the
+/// images their frames fall into are collected across all of them, each
+/// distinct UUID is loaded once, and every report is then resolved and
+/// rendered, delivered as soon as it is done. Each pass over the reports
+/// is a pipeline of bounded queues (see `runPipeline`) that reads ahead of
+/// the workers by a few reports only, and reports beyond a fixed budget
+/// are read again rather than kept, so memory stays flat however many
+/// reports a batch holds.
+class BatchSymbolicator {
+public:
+    /// Lookup of one frame; `image` is null when its image had no symbols.
+    struct ResolvedFrame {
+        const Image *image = nullptr;
+        SymbolLookup lookup;
+        uint64_t symbolOffset = 0; ///< Offset of the address into `lookup.function`.
+        /// Calls inlined into `lookup.function` at the address, innermost
+        /// first; only filled in when inline expansion is on.
+        std::vector<SymbolLookup> inlined;
+
+        IPSSymbol ipsSymbol() const {
+            if (lookup.function == nullptr) {
+                return IPSSymbol();
+            }
+            IPSSymbol symbol {lookup.function, symbolOffset, lookup.file, lookup.line, {}};
+            for (const auto &call : inlined) {
+                if (call.function != nullptr) {
+                    symbol.inlined.push_back({call.function, symbolOffset, call.file, call.line, {}});
+                }
+            }
+            return symbol;
+        }
+    };
+
+    /// Reports that share a crash signature. Only the first, `names[0]`, is
+    /// resolved and delivered; the others are merely counted in.
+    struct Bucket {
+        CrashSignature signature;
+        std::vector<std::string> names;
+    };
+
+    struct Result {
+        std::string name;
+        std::string output;      ///< Symbolicated report; empty when `error` is set or rendering is off.
+        std::string json;        ///< The report as one JSON record, when `setRendersJSON` is on.
+        std::string error;
+        size_t resolvedFrames = 0;
+        /// The parsed report, text or .ips, the text it was parsed from and
+        /// one entry per frame of it. Only valid during the delivery call.
+        const CrashReport *report = nullptr;
+        const IPSReport *ips = nullptr;
+        std::string_view source;
+        std::vector<ResolvedFrame> frames;
+        /// The bucket this report stands for when deduplicating, else null.
+        const Bucket *bucket = nullptr;
+    };
+
+    /// Called once with every image that is neither cached nor registered,
+    /// so the caller can find dSYMs for all of them in one go and register
+    /// them with `addBinary`.
+    using Locate = std::function<void(const std::vector<ImageKey> &missing)>;
+    /// Called on the thread running `run`, one report at a time.
+    using Deliver = std::function<void(Result &&result)>;
+
+    /// Wall-clock seconds spent in each stage of the last `run`. Demangling
+    /// happens inside the resolve stage, so `demangle` is the time summed
+    /// over all workers and also counted in `resolve`.
+    struct Timings {
+        double parse = 0;
+        double locate = 0;
+        double load = 0;
+        double resolve = 0;
+        double demangle = 0;
+        double deduplicate = 0; ///< Computing signatures, between load and resolve.
+    };
+
+    /// `cache` may be null; indexes are then built in memory only.
+    BatchSymbolicator(WorkPool &pool, std::shared_ptr<IndexCache> cache);
+
+    /// Adds a text or .ips report. Frames of .ips reports are resolved from
+    /// their image offsets and rendered in the text format.
+    void addReport(std::string name, std::string text);
+    /// Queues a report to be read from `path` by a worker.
+    void addReportFile(std::string path);
+    /// Registers the Mach-O file holding the symbols for `uuid`.
+    void addBinary(const std::array<uint8_t, 16> &uuid, std::string path);
+
+    /// Whether results carry the rendered text report. On by default;
+    /// callers producing structured output can skip the rendering.
+    void setRendersText(bool rendersText) { rendersText_ = rendersText; }
+
+    /// Whether results carry the report as a structured JSON record (see
+    /// `writeReportJSON`), written by the worker that resolved it. Off by
+    /// default.
+    void setRendersJSON(bool rendersJSON) { rendersJSON_ = rendersJSON; }
+
+    /// Whether frames are expanded into the calls inlined at their address,
+    /// from the DWARF inlined subroutine records. Off by default: expanded
+    /// text reports have one line per call rather than one per frame.
+    void setExpandsInlines(bool expandsInlines) { expandsInlines_ = expandsInlines; }
+
+    /// Whether Swift and C++ function names are demangled. Off by default.
+    /// Each distinct name is demangled once per batch symbolicator, however
+    /// many frames and reports it appears in.
+    void setDemangles(bool demangles) { demangles_ = demangles; }
+
+    /// Resolved frames to reuse and to add to, shared with other batches and
+    /// possibly persisted; null, the default, resolves every frame afresh.
+    void setFrameCache(std::shared_ptr<FrameCache> frames) { frames_ = std::move(frames); }
+
+    /// Groups reports by a signature of their exception type and the top
+    /// `frames` frames of the crashing thread, and resolves and delivers
+    /// one report per group; `buckets` then lists the groups. 0, the
+    /// default, turns grouping off. Reports that fail to parse or have no
+    /// crashing thread frames are delivered on their own, in no bucket.
+    void setDeduplicates(size_t frames) { deduplicates_ = frames; }
+
+    /// Buckets of the last `run`, ordered by their first report.
+    const std::vector<Bucket> &buckets() const { return buckets_; }
+
+    void run(const Locate &locate, const Deliver &deliver);
+
+    const Timings &timings() const { return timings_; }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string path;
+        /// The report as read: a view of `file` for report files large enough
+        /// to be left mapped, otherwise of `ownedText`.
+        std::string_view text;
+        std::string ownedText;
+        MappedFile file;
+        CrashReport report;
+        IPSReport ips;
+        bool isIPS = false;
+        std::string error;
+        ptrdiff_t bucket = -1; ///< Index into `buckets_` when this report stands for one.
+        bool isDuplicate = false;
+        bool isParsed = false;
+        /// Kept parsed between passes rather than read again in each.
+        bool isRetained = false;
+    };
+
+    static void read(Entry &entry);
+    static void parse(Entry &entry);
+    static void unload(Entry &entry);
+    static void release(Entry &entry);
+    static std::vector<ImageKey> usedImages(const Entry &entry);
+    std::shared_ptr<const Image> load(const ImageKey &key, const std::string &path) const;
+    Result resolve(const Entry &entry) const;
+    bool cached(const Image &image, uint64_t fileAddress, ResolvedFrame &resolved) const;
+    void finish(uint64_t fileAddress, ResolvedFrame &resolved) const;
+    void lookup(const Image &image, uint64_t fileAddress, ResolvedFrame &resolved) const;
+    void lookupAll(const std::vector<const Image *> &images, const std::vector<uint64_t> &fileAddresses,
+                   std::vector<ResolvedFrame> &frames) const;
+    void demangle(ResolvedFrame &resolved) const;
+    std::vector<const Image *> symbolsFor(const CrashReport &report) const;
+    std::vector<const Image *> symbolsFor(const IPSReport &report) const;
+    void addSignatureFrame(SignatureBuilder &builder, std::string_view imageName, const Image *image,
+                           uint64_t fileAddress, std::string_view reported, uint64_t offset) const;
+    bool signature(const Entry &entry, CrashSignature &signature) const;
+    void deduplicate();
+    void resolveReport(const Entry &entry, Result &result) const;
+    void resolveIPS(const Entry &entry, Result &result) const;
+
+    WorkPool &pool_;
+    std::shared_ptr<IndexCache> cache_;
+    std::shared_ptr<FrameCache> frames_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::map<std::array<uint8_t, 16>, std::string> binaries_;
+    std::map<ImageKey, std::shared_ptr<const Image>> images_;
+    bool rendersText_ = true;
+    bool rendersJSON_ = false;
+    bool expandsInlines_ = false;
+    bool demangles_ = false;
+    size_t deduplicates_ = 0;
+    std::vector<Bucket> buckets_;
+    /// Shared by all resolve tasks; names point into it, so it outlives results.
+    mutable DemangleCache demangled_;
+    mutable std::atomic<uint64_t> demangleNanoseconds_ {0};
+    Timings timings_;
+};
+
+} // namespace symbolicator
+
+#endif
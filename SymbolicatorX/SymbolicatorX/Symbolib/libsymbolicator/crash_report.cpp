@@ -0,0 +1,493 @@
+//
+//  crash_report.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "crash_report.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "macho_file.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+bool isSpace(char character) {
+    return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+}
+
+bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+int hexValue(char character) {
+    if (character >= '0' && character <= '9') {
+        return character - '0';
+    }
+    if (character >= 'a' && character <= 'f') {
+        return character - 'a' + 10;
+    }
+    if (character >= 'A' && character <= 'F') {
+        return character - 'A' + 10;
+    }
+    return -1;
+}
+
+char lower(char character) {
+    return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+}
+
+std::string_view trimmed(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+void skipSpaces(std::string_view &text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool startsWithIgnoringCase(std::string_view text, std::string_view prefix) {
+    if (text.size() < prefix.size()) {
+        return false;
+    }
+    for (size_t index = 0; index < prefix.size(); ++index) {
+        if (lower(text[index]) != lower(prefix[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Finds `needle` followed by whitespace, ignoring case.
+bool containsWord(std::string_view text, std::string_view needle) {
+    if (needle.empty()) {
+        return false;
+    }
+    for (size_t index = 0; index + needle.size() < text.size(); ++index) {
+        if (isSpace(text[index + needle.size()]) && startsWithIgnoringCase(text.substr(index), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Consumes a "0x..." literal from the front of `text`.
+bool consumeHex(std::string_view &text, uint64_t &value) {
+    if (text.size() < 3 || text[0] != '0' || (text[1] != 'x' && text[1] != 'X') || hexValue(text[2]) < 0) {
+        return false;
+    }
+    value = 0;
+    size_t index = 2;
+    for (int digit; index < text.size() && (digit = hexValue(text[index])) >= 0; ++index) {
+        value = (value << 4) | static_cast<uint64_t>(digit);
+    }
+    text.remove_prefix(index);
+    return true;
+}
+
+/// Value of a "Key:   value" header line, or an empty view.
+std::string_view headerValue(std::string_view line, std::string_view key) {
+    return startsWith(line, key) ? trimmed(line.substr(key.size())) : std::string_view();
+}
+
+class Parser {
+public:
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    CrashReport run() {
+        size_t position = 0;
+        while (position < text_.size()) {
+            const char *newline = static_cast<const char *>(
+                std::memchr(text_.data() + position, '\n', text_.size() - position));
+            const size_t end = newline != nullptr ? static_cast<size_t>(newline - text_.data()) : text_.size();
+            line(text_.substr(position, end - position), position);
+            position = end + 1;
+        }
+        finish();
+        return std::move(report_);
+    }
+
+private:
+    void line(std::string_view line, size_t offset) {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            return;
+        }
+
+        if (isDigit(line.front()) && frame(line, offset)) {
+            return;
+        }
+
+        if (inImages_ && (image(line) || isSpace(line.front()))) {
+            // Still inside the table; indented lines that are not images
+            // belong to it too (spindump wraps long paths).
+        } else if (startsWith(line, "Binary Images:")) {
+            inImages_ = true;
+            return;
+        } else if (!isSpace(line.front())) {
+            inImages_ = false;
+            header(line);
+        }
+
+        // Sample reports interleave "???" frames with indentation, so they
+        // can only be recognized by their content.
+        const size_t unknown = line.find("???");
+        if (unknown != std::string_view::npos) {
+            sample(line.substr(unknown), offset + unknown);
+        }
+    }
+
+    void header(std::string_view line) {
+        std::string_view value;
+        if (startsWith(line, "Thread ")) {
+            std::string_view number = line.substr(7);
+            int32_t thread = 0;
+            bool hasDigits = false;
+            while (!number.empty() && isDigit(number.front())) {
+                thread = thread * 10 + (number.front() - '0');
+                number.remove_prefix(1);
+                hasDigits = true;
+            }
+            if (hasDigits) {
+                thread_ = thread;
+                if (report_.crashedThread < 0 && startsWith(number, " Crashed")) {
+                    report_.crashedThread = thread;
+                }
+            }
+        } else if (startsWith(line, "Last Exception Backtrace:")) {
+            thread_ = -1;
+        } else if (report_.exceptionType.empty() && !(value = headerValue(line, "Exception Type:")).empty()) {
+            report_.exceptionType = value;
+        } else if (report_.crashedThread < 0 && (!(value = headerValue(line, "Crashed Thread:")).empty() ||
+                                                 !(value = headerValue(line, "Triggered by Thread:")).empty())) {
+            int32_t thread = 0;
+            bool hasDigits = false;
+            for (; !value.empty() && isDigit(value.front()); value.remove_prefix(1)) {
+                thread = thread * 10 + (value.front() - '0');
+                hasDigits = true;
+            }
+            if (hasDigits) {
+                report_.crashedThread = thread;
+            }
+        } else if (report_.processName.empty() && !(value = headerValue(line, "Process:")).empty()) {
+            report_.processName = trimmed(value.substr(0, value.find('[')));
+        } else if (report_.identifier.empty() && !(value = headerValue(line, "Identifier:")).empty()) {
+            report_.identifier = value;
+        } else if (report_.responsible.empty() && !(value = headerValue(line, "Responsible:")).empty()) {
+            report_.responsible = trimmed(value.substr(0, value.find('[')));
+        } else if (report_.codeType.empty() && !(value = headerValue(line, "Code Type:")).empty()) {
+            report_.codeType = trimmed(value.substr(0, value.find('(')));
+        } else if (report_.version.empty() && !(value = headerValue(line, "Version:")).empty()) {
+            const size_t open = value.find('(');
+            report_.version = trimmed(value.substr(0, open));
+            const size_t lastOpen = value.rfind('(');
+            if (lastOpen != std::string_view::npos) {
+                const size_t close = value.find(')', lastOpen);
+                if (close != std::string_view::npos) {
+                    report_.buildVersion = trimmed(value.substr(lastOpen + 1, close - lastOpen - 1));
+                }
+            }
+        }
+    }
+
+    /// "0   MyApp                0x0000000100012345 0x100000000 + 74565"
+    bool frame(std::string_view line, size_t offset) {
+        size_t index = 0;
+        while (index < line.size() && isDigit(line[index])) {
+            ++index;
+        }
+        if (index == line.size() || !isSpace(line[index])) {
+            return false;
+        }
+
+        const size_t imageStart = index;
+        size_t addressStart = std::string_view::npos;
+        for (size_t cursor = imageStart + 1; cursor + 1 < line.size(); ++cursor) {
+            if (line[cursor] == '0' && line[cursor + 1] == 'x' && isSpace(line[cursor - 1])) {
+                addressStart = cursor;
+                break;
+            }
+        }
+        if (addressStart == std::string_view::npos) {
+            return false;
+        }
+
+        std::string_view rest = line.substr(addressStart);
+        ReportFrame frame;
+        if (!consumeHex(rest, frame.addressValue)) {
+            return false;
+        }
+        frame.imageName = trimmed(line.substr(imageStart, addressStart - imageStart));
+        frame.address = line.substr(addressStart, line.size() - addressStart - rest.size());
+        frame.addressOffset = offset + addressStart;
+        frame.symbolOffset = frame.addressOffset + frame.address.size();
+        frame.symbolLength = rest.size();
+        frame.thread = thread_;
+        frame.kind = ReportFrameKind::Crash;
+        if (frame.imageName.empty()) {
+            return false;
+        }
+        report_.frames.push_back(frame);
+        return true;
+    }
+
+    /// "??? (in MyApp)  load address 0x100000000 + 0x1234  [0x100001234]"
+    void sample(std::string_view line, size_t offset) {
+        const size_t in = line.find("(in ");
+        if (in == std::string_view::npos) {
+            return;
+        }
+        const size_t close = line.find(')', in);
+        const size_t load = line.find("load address", in);
+        if (close == std::string_view::npos || load == std::string_view::npos) {
+            return;
+        }
+        const size_t bracket = line.find('[', load);
+        if (bracket == std::string_view::npos) {
+            return;
+        }
+
+        std::string_view rest = line.substr(bracket + 1);
+        ReportFrame frame;
+        if (!consumeHex(rest, frame.addressValue) || rest.empty() || rest.front() != ']') {
+            return;
+        }
+        frame.imageName = trimmed(line.substr(in + 4, close - in - 4));
+        frame.address = line.substr(bracket + 1, line.size() - bracket - 1 - rest.size());
+        frame.addressOffset = offset + bracket + 1;
+        frame.symbolOffset = offset;
+        frame.symbolLength = bracket;
+        frame.thread = thread_;
+        frame.kind = ReportFrameKind::Sample;
+        report_.frames.push_back(frame);
+    }
+
+    /// "0x100000000 - 0x100ffffff +MyApp arm64  <uuid> /path/to/MyApp"
+    /// "0x7fff2000 - 0x7fff2fff  com.apple.AppKit (6.9 - 2022) <UUID> /System/..."
+    bool image(std::string_view line) {
+        std::string_view rest = line;
+        skipSpaces(rest);
+        ReportImage image;
+        if (!consumeHex(rest, image.start)) {
+            return false;
+        }
+        skipSpaces(rest);
+        if (rest.empty() || rest.front() != '-') {
+            return false;
+        }
+        rest.remove_prefix(1);
+        skipSpaces(rest);
+        if (!consumeHex(rest, image.end)) {
+            return false;
+        }
+        image.remainder = rest;
+
+        std::string_view middle = trimmed(rest);
+        const size_t open = middle.find('<');
+        const size_t close = open != std::string_view::npos ? middle.find('>', open) : std::string_view::npos;
+        if (close != std::string_view::npos) {
+            image.uuid = trimmed(middle.substr(open + 1, close - open - 1));
+            image.path = trimmed(middle.substr(close + 1));
+            middle = trimmed(middle.substr(0, open));
+        } else {
+            const size_t slash = middle.find(" /");
+            if (slash != std::string_view::npos) {
+                image.path = trimmed(middle.substr(slash));
+                middle = trimmed(middle.substr(0, slash));
+            }
+        }
+
+        if (!middle.empty() && middle.front() == '+') {
+            middle = trimmed(middle.substr(1));
+        }
+        // An architecture column only exists in iOS style reports; macOS
+        // reports put "(version - build)" there instead.
+        const size_t lastSpace = middle.find_last_of(" \t");
+        if (lastSpace != std::string_view::npos && middle.back() != ')') {
+            image.arch = middle.substr(lastSpace + 1);
+            middle = trimmed(middle.substr(0, lastSpace));
+        }
+        if (!middle.empty() && middle.back() == ')') {
+            const size_t version = middle.rfind(" (");
+            if (version != std::string_view::npos) {
+                middle = trimmed(middle.substr(0, version));
+            }
+        }
+        image.name = middle;
+        report_.images.push_back(image);
+        return true;
+    }
+
+    void finish() {
+        const std::string_view needles[] = {report_.identifier, report_.processName};
+        for (size_t index = 0; index < report_.images.size() && report_.mainImage < 0; ++index) {
+            for (const auto &needle : needles) {
+                if (containsWord(report_.images[index].remainder, needle)) {
+                    report_.mainImage = static_cast<ptrdiff_t>(index);
+                    break;
+                }
+            }
+        }
+
+        // Attribute every frame to the image whose range holds its address.
+        std::vector<size_t> byStart(report_.images.size());
+        for (size_t index = 0; index < byStart.size(); ++index) {
+            byStart[index] = index;
+        }
+        std::sort(byStart.begin(), byStart.end(), [this](size_t lhs, size_t rhs) {
+            return report_.images[lhs].start < report_.images[rhs].start;
+        });
+
+        for (auto &frame : report_.frames) {
+            auto next = std::upper_bound(byStart.begin(), byStart.end(), frame.addressValue, [this](uint64_t address, size_t index) {
+                return address < report_.images[index].start;
+            });
+            if (next != byStart.begin() && frame.addressValue <= report_.images[*std::prev(next)].end) {
+                frame.image = static_cast<ptrdiff_t>(*std::prev(next));
+            }
+
+            if (frame.image >= 0 && report_.mainImage >= 0) {
+                frame.isMainImage = frame.image == report_.mainImage;
+                continue;
+            }
+            // Without an image table, fall back to matching the image column.
+            if (frame.kind == ReportFrameKind::Sample) {
+                frame.isMainImage = true;
+                continue;
+            }
+            for (const auto &needle : needles) {
+                if (!needle.empty() && startsWithIgnoringCase(frame.imageName, needle)) {
+                    frame.isMainImage = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::string_view text_;
+    CrashReport report_;
+    bool inImages_ = false;
+    int32_t thread_ = -1;
+};
+
+/// The start of the line `frame` is on, up to its unresolved symbol.
+std::string_view linePrefix(std::string_view text, const ReportFrame &frame) {
+    const size_t end = std::min(frame.symbolOffset, text.size());
+    const size_t newline = end > 0 ? text.rfind('\n', end - 1) : std::string_view::npos;
+    const size_t start = newline == std::string_view::npos ? 0 : newline + 1;
+    return text.substr(start, end - start);
+}
+
+} // namespace
+
+CrashReport CrashReport::parse(std::string_view text) {
+    return Parser(text).run();
+}
+
+std::string CrashReport::render(std::string_view text, const std::vector<std::string_view> &replacements) const {
+    const size_t count = std::min(frames.size(), replacements.size());
+    size_t size = text.size();
+    for (size_t index = 0; index < count; ++index) {
+        const std::string_view replacement = replacements[index];
+        size += replacement.size() + 1;
+        if (frames[index].kind == ReportFrameKind::Crash && replacement.find('\n') != std::string_view::npos) {
+            const size_t copies = static_cast<size_t>(std::count(replacement.begin(), replacement.end(), '\n'));
+            size += copies * (linePrefix(text, frames[index]).size() + 1);
+        }
+    }
+
+    std::string output;
+    output.reserve(size);
+    size_t cursor = 0;
+    for (size_t index = 0; index < count; ++index) {
+        const ReportFrame &frame = frames[index];
+        const std::string_view replacement = replacements[index];
+        if (replacement.empty() || frame.symbolOffset < cursor || frame.symbolOffset + frame.symbolLength > text.size()) {
+            continue;
+        }
+
+        output.append(text.data() + cursor, frame.symbolOffset - cursor);
+        // "0x... <symbol>" for backtraces, "<symbol> [0x...]" for samples.
+        if (frame.kind == ReportFrameKind::Crash) {
+            // Inlined calls get a copy of the line each, like symbolicatecrash prints them.
+            const std::string_view prefix = linePrefix(text, frame);
+            std::string_view rest = replacement;
+            for (size_t separator = rest.find('\n'); separator != std::string_view::npos; separator = rest.find('\n')) {
+                output.push_back(' ');
+                output.append(rest.data(), separator);
+                output.push_back('\n');
+                output.append(prefix.data(), prefix.size());
+                rest.remove_prefix(separator + 1);
+            }
+            output.push_back(' ');
+            output.append(rest.data(), rest.size());
+        } else {
+            const std::string_view last = replacement.substr(replacement.rfind('\n') + 1);
+            output.append(last.data(), last.size());
+            output.push_back(' ');
+        }
+        cursor = frame.symbolOffset + frame.symbolLength;
+    }
+    output.append(text.data() + cursor, text.size() - cursor);
+    return output;
+}
+
+std::string CrashReport::architecture(const ReportImage &image) const {
+    return architectureName(image.arch, codeType);
+}
+
+std::string architectureName(std::string_view arch, std::string_view codeType) {
+    CpuArchitecture parsed;
+    if (!arch.empty() && CpuArchitecture::parse(arch, parsed)) {
+        return std::string(arch);
+    }
+
+    // "ARM-64", "X86-64 (Native)", "ARM64E"...
+    std::string name;
+    for (char character : codeType.substr(0, codeType.find(' '))) {
+        name.push_back(character == '-' ? '_' : lower(character));
+    }
+    if (name == "arm_64") {
+        name = "arm64";
+    } else if (name == "x86") {
+        name = "i386";
+    }
+    return CpuArchitecture::parse(name, parsed) && name != "arm" ? name : std::string();
+}
+
+bool parseUUID(std::string_view text, std::array<uint8_t, 16> &uuid) {
+    size_t digits = 0;
+    for (char character : text) {
+        if (character == '-') {
+            continue;
+        }
+        const int value = hexValue(character);
+        if (value < 0 || digits == 32) {
+            return false;
+        }
+        uint8_t &byte = uuid[digits / 2];
+        byte = digits % 2 == 0 ? static_cast<uint8_t>(value << 4) : static_cast<uint8_t>(byte | value);
+        ++digits;
+    }
+    return digits == 32;
+}
+
+} // namespace symbolicator
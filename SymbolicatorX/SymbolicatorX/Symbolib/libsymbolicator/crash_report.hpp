@@ -0,0 +1,93 @@
+//
+//  crash_report.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_CRASH_REPORT_HPP
+#define SYMBOLICATOR_CRASH_REPORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace symbolicator {
+
+/// One line of the "Binary Images:" table.
+struct ReportImage {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    std::string_view name;
+    std::string_view arch;
+    std::string_view uuid;      ///< Text between the angle brackets, empty when absent.
+    std::string_view path;
+    std::string_view remainder; ///< Everything after the end address.
+};
+
+enum class ReportFrameKind : uint8_t {
+    Crash,  ///< "12  MyApp  0x0000000100012345 ..." backtrace line.
+    Sample, ///< "??? (in MyApp)  load address 0x... + 0x...  [0x...]" sample line.
+};
+
+struct ReportFrame {
+    std::string_view imageName; ///< Image column, or the name after "(in" of a sample line.
+    std::string_view address;  ///< Address token exactly as written in the report.
+    uint64_t addressValue = 0;
+    size_t addressOffset = 0;  ///< Byte offset of `address` in the report text.
+    size_t symbolOffset = 0;   ///< Start of the unresolved text rendering replaces: the
+    size_t symbolLength = 0;   ///< rest of a crash line, or the "??? ..." of a sample line.
+    int32_t thread = -1;       ///< Thread number, -1 outside a "Thread N" section.
+    ptrdiff_t image = -1;      ///< Index into `images` of the image holding the address.
+    ReportFrameKind kind = ReportFrameKind::Crash;
+    bool isMainImage = false;  ///< Frame belongs to the process' own binary.
+};
+
+/// Structured view of a text crash, spindump or sample report. Every
+/// string_view points into the text the report was parsed from.
+struct CrashReport {
+    std::string_view processName;
+    std::string_view identifier;
+    std::string_view responsible;
+    std::string_view codeType;
+    std::string_view version;
+    std::string_view buildVersion;
+    std::string_view exceptionType; ///< "EXC_BAD_ACCESS (SIGSEGV)".
+    std::vector<ReportImage> images;
+    std::vector<ReportFrame> frames;
+    ptrdiff_t mainImage = -1; ///< Index into `images` of the process' binary.
+    int32_t crashedThread = -1; ///< From "Thread N Crashed:" or "Crashed Thread:", -1 when absent.
+
+    /// Tokenizes `text` line by line in a single pass; never throws on
+    /// malformed input, unrecognized lines are simply skipped.
+    static CrashReport parse(std::string_view text);
+
+    /// Rewrites `text`, which must be the text the report was parsed from,
+    /// with `replacements[i]` in place of the unresolved symbol of frame i.
+    /// Empty replacements leave the frame untouched. A replacement holding
+    /// several '\n' separated entries (an inline chain, innermost first)
+    /// repeats a backtrace line once per entry; sample lines only take the
+    /// last one. Runs in one pass over the text into a buffer sized up front.
+    std::string render(std::string_view text, const std::vector<std::string_view> &replacements) const;
+
+    /// Architecture name `image` should be looked up with, as understood by
+    /// `CpuArchitecture::parse`: the image's own column when it has one,
+    /// otherwise the report's "Code Type". Empty when neither is usable.
+    std::string architecture(const ReportImage &image) const;
+};
+
+/// Architecture name for `CpuArchitecture::parse` from an image's own
+/// architecture column, falling back to a report's code type ("ARM-64",
+/// "X86-64 (Native)"). Empty when neither is usable.
+std::string architectureName(std::string_view arch, std::string_view codeType);
+
+/// Parses a UUID written as 32 hex digits, with or without dashes.
+bool parseUUID(std::string_view text, std::array<uint8_t, 16> &uuid);
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,151 @@
+//
+//  crash_signature.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "crash_signature.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace symbolicator {
+
+namespace {
+
+bool isSpace(char character) {
+    return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+}
+
+bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+std::string_view trimmed(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/// Appends `text` with each run of whitespace turned into a single space.
+void appendCollapsed(std::string &out, std::string_view text) {
+    text = trimmed(text);
+    bool inSpace = false;
+    for (char character : text) {
+        if (isSpace(character)) {
+            inSpace = true;
+            continue;
+        }
+        if (inSpace) {
+            out.push_back(' ');
+            inSpace = false;
+        }
+        out.push_back(character);
+    }
+}
+
+/// "foo + 42 (File.swift:12)", "foo (in MyApp) + 42" or "foo (File.m:7)"
+/// down to "foo".
+std::string_view functionName(std::string_view symbol) {
+    symbol = trimmed(symbol);
+    for (size_t plus = symbol.find(" + "); plus != std::string_view::npos; plus = symbol.find(" + ", plus + 1)) {
+        if (plus + 3 < symbol.size() && isDigit(symbol[plus + 3])) {
+            symbol = symbol.substr(0, plus);
+            break;
+        }
+    }
+    const size_t in = symbol.find(" (in ");
+    if (in != std::string_view::npos) {
+        symbol = symbol.substr(0, in);
+    }
+    const size_t open = symbol.rfind(" (");
+    if (open != std::string_view::npos && symbol.back() == ')') {
+        const std::string_view location = symbol.substr(open + 2, symbol.size() - open - 3);
+        const size_t colon = location.rfind(':');
+        if (colon != std::string_view::npos && colon + 1 < location.size() &&
+            std::all_of(location.begin() + colon + 1, location.end(), isDigit)) {
+            symbol = symbol.substr(0, open);
+        }
+    }
+    return trimmed(symbol);
+}
+
+} // namespace
+
+uint64_t fnv1a(std::string_view data) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char byte : data) {
+        hash = (hash ^ byte) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+SignatureBuilder::SignatureBuilder(std::string_view exceptionType) {
+    appendCollapsed(text_, exceptionType);
+}
+
+bool SignatureBuilder::addFunction(std::string_view image, std::string_view function) {
+    function = functionName(function);
+    if (function.empty() || function == "???" || function.substr(0, 2) == "0x") {
+        return false;
+    }
+    text_.push_back('\n');
+    appendCollapsed(text_, image);
+    text_.push_back('!');
+    appendCollapsed(text_, function);
+    ++frameCount_;
+    return true;
+}
+
+void SignatureBuilder::addOffset(std::string_view image, uint64_t offset) {
+    char hex[24];
+    std::snprintf(hex, sizeof(hex), "+0x%" PRIx64, offset);
+    text_.push_back('\n');
+    appendCollapsed(text_, image);
+    text_.append(hex);
+    ++frameCount_;
+}
+
+CrashSignature SignatureBuilder::finish() {
+    CrashSignature signature;
+    signature.hash = fnv1a(text_);
+    signature.text = std::move(text_);
+    text_.clear();
+    frameCount_ = 0;
+    return signature;
+}
+
+void SignatureBuckets::add(CrashSignature signature, size_t item) {
+    Shard &shard = shards_[signature.hash % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.buckets.find(signature.text);
+    if (found == shard.buckets.end()) {
+        std::string key = signature.text;
+        found = shard.buckets.emplace(std::move(key), Bucket {std::move(signature), {}}).first;
+    }
+    found->second.members.push_back(item);
+}
+
+std::vector<SignatureBuckets::Bucket> SignatureBuckets::take() {
+    std::vector<Bucket> buckets;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto &entry : shard.buckets) {
+            std::sort(entry.second.members.begin(), entry.second.members.end());
+            buckets.push_back(std::move(entry.second));
+        }
+        shard.buckets.clear();
+    }
+    std::sort(buckets.begin(), buckets.end(),
+              [](const Bucket &left, const Bucket &right) { return left.members.front() < right.members.front(); });
+    return buckets;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,88 @@
+//
+//  crash_signature.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_CRASH_SIGNATURE_HPP
+#define SYMBOLICATOR_CRASH_SIGNATURE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace symbolicator {
+
+/// 64-bit FNV-1a of `data`. Unlike std::hash its value is fixed, so it can
+/// be stored and compared across runs and machines.
+uint64_t fnv1a(std::string_view data);
+
+/// What makes two reports the same crash: the exception type and the top
+/// frames of the crashing thread, one "image!function" line each. Offsets,
+/// source locations and load addresses are left out, so reports of one
+/// crash from different launches and devices come out equal.
+struct CrashSignature {
+    std::string text;
+    uint64_t hash = 0; ///< `fnv1a(text)`.
+};
+
+/// Puts a signature together one frame at a time, innermost first.
+class SignatureBuilder {
+public:
+    explicit SignatureBuilder(std::string_view exceptionType);
+
+    /// Adds a frame in `image` symbolicated to `function`. A report's own
+    /// symbol text may be passed as is: its "+ offset", "(in Image)" and
+    /// "(File.swift:12)" parts are dropped. Returns false, adding nothing,
+    /// when `function` names no symbol ("???", an address or nothing).
+    bool addFunction(std::string_view image, std::string_view function);
+    /// Adds a frame nothing was resolved for by its offset into `image`.
+    void addOffset(std::string_view image, uint64_t offset);
+
+    size_t frameCount() const { return frameCount_; }
+    CrashSignature finish();
+
+private:
+    std::string text_;
+    size_t frameCount_ = 0;
+};
+
+/// Groups items by signature; safe to fill from several threads at once.
+class SignatureBuckets {
+public:
+    struct Bucket {
+        CrashSignature signature;
+        std::vector<size_t> members; ///< Item indexes, ascending once taken.
+    };
+
+    SignatureBuckets() = default;
+    SignatureBuckets(const SignatureBuckets &) = delete;
+    SignatureBuckets &operator=(const SignatureBuckets &) = delete;
+
+    void add(CrashSignature signature, size_t item);
+
+    /// Empties the buckets into a list ordered by their first member, so the
+    /// result does not depend on the order the items were added in.
+    std::vector<Bucket> take();
+
+private:
+    /// Signatures hash to one of several independently locked shards, so
+    /// threads adding different items rarely wait for each other.
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Bucket> buckets; ///< Keyed by signature text.
+    };
+
+    std::array<Shard, 16> shards_;
+};
+
+} // namespace symbolicator
+
+#endif
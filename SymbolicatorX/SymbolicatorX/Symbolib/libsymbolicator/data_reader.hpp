@@ -0,0 +1,147 @@
+//
+//  data_reader.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_DATA_READER_HPP
+#define SYMBOLICATOR_DATA_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "error.hpp"
+
+namespace symbolicator {
+
+/// Bounds-checked little-endian cursor over a mapped byte range.
+class DataReader {
+public:
+    DataReader() = default;
+    DataReader(const uint8_t *data, size_t size) : begin_(data), cursor_(data), end_(data + size) {}
+
+    size_t offset() const { return static_cast<size_t>(cursor_ - begin_); }
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    size_t remaining() const { return static_cast<size_t>(end_ - cursor_); }
+    bool atEnd() const { return cursor_ >= end_; }
+    const uint8_t *data() const { return begin_; }
+    const uint8_t *current() const { return cursor_; }
+
+    void seek(size_t offset) {
+        if (offset > size()) {
+            throwBadFormat("seek past end of section");
+        }
+        cursor_ = begin_ + offset;
+    }
+
+    void skip(size_t count) {
+        need(count);
+        cursor_ += count;
+    }
+
+    template <typename T>
+    T read() {
+        need(sizeof(T));
+        T value;
+        std::memcpy(&value, cursor_, sizeof(T));
+        cursor_ += sizeof(T);
+        return value;
+    }
+
+    uint8_t u8() { return read<uint8_t>(); }
+    uint16_t u16() { return read<uint16_t>(); }
+    uint32_t u32() { return read<uint32_t>(); }
+    uint64_t u64() { return read<uint64_t>(); }
+
+    uint64_t unsignedOfSize(size_t size) {
+        switch (size) {
+        case 1: return u8();
+        case 2: return u16();
+        case 3: {
+            need(3);
+            uint64_t value = cursor_[0] | (cursor_[1] << 8) | (cursor_[2] << 16);
+            cursor_ += 3;
+            return value;
+        }
+        case 4: return u32();
+        case 8: return u64();
+        default: throwBadFormat("unsupported integer size");
+        }
+    }
+
+    uint64_t uleb128() {
+        uint64_t result = 0;
+        unsigned shift = 0;
+        while (true) {
+            uint8_t byte = u8();
+            if (shift < 64) {
+                result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            }
+            shift += 7;
+            if ((byte & 0x80) == 0) {
+                return result;
+            }
+        }
+    }
+
+    int64_t sleb128() {
+        int64_t result = 0;
+        unsigned shift = 0;
+        uint8_t byte = 0;
+        do {
+            byte = u8();
+            if (shift < 64) {
+                result |= static_cast<int64_t>(byte & 0x7f) << shift;
+            }
+            shift += 7;
+        } while (byte & 0x80);
+        if (shift < 64 && (byte & 0x40)) {
+            result |= -(static_cast<int64_t>(1) << shift);
+        }
+        return result;
+    }
+
+    std::string_view cstring() {
+        const void *terminator = std::memchr(cursor_, 0, remaining());
+        if (terminator == nullptr) {
+            throwBadFormat("unterminated string");
+        }
+        std::string_view value(reinterpret_cast<const char *>(cursor_),
+                               static_cast<const uint8_t *>(terminator) - cursor_);
+        cursor_ += value.size() + 1;
+        return value;
+    }
+
+    /// Reads a NUL-terminated string at `offset` without moving the cursor.
+    std::string_view cstringAt(uint64_t offset) const {
+        if (offset >= size()) {
+            return {};
+        }
+        const uint8_t *start = begin_ + offset;
+        const void *terminator = std::memchr(start, 0, static_cast<size_t>(end_ - start));
+        if (terminator == nullptr) {
+            return {};
+        }
+        return std::string_view(reinterpret_cast<const char *>(start),
+                                static_cast<const uint8_t *>(terminator) - start);
+    }
+
+private:
+    void need(size_t count) const {
+        if (count > remaining()) {
+            throwBadFormat("unexpected end of data");
+        }
+    }
+
+    const uint8_t *begin_ = nullptr;
+    const uint8_t *cursor_ = nullptr;
+    const uint8_t *end_ = nullptr;
+};
+
+} // namespace symbolicator
+
+#endif
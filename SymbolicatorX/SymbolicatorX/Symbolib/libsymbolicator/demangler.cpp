@@ -0,0 +1,94 @@
+//
+//  demangler.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "demangler.hpp"
+
+#include <functional>
+#include <mutex>
+
+#include "itanium_demangler.hpp"
+#include "swift_demangler.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+bool isSwift(std::string_view name) {
+    if (!name.empty() && name.front() == '_') {
+        name.remove_prefix(1);
+    }
+    return name.size() > 2 && name[0] == '$' && (name[1] == 's' || name[1] == 'S');
+}
+
+bool isItanium(std::string_view name) {
+    for (int underscores = 0; underscores < 3 && !name.empty() && name.front() == '_'; ++underscores) {
+        name.remove_prefix(1);
+        if (name.size() > 1 && name.front() == 'Z') {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool isMangled(std::string_view name) {
+    return isSwift(name) || isItanium(name);
+}
+
+bool demangle(std::string_view name, std::string &out) {
+    if (isSwift(name)) {
+        return demangleSwift(name, out);
+    }
+    return isItanium(name) && demangleItanium(name, out);
+}
+
+const char *DemangleCache::demangle(const char *name) {
+    const std::string_view mangled(name);
+    if (!isMangled(mangled)) {
+        return name;
+    }
+
+    Shard &shard = shards_[std::hash<std::string_view>()(mangled) % shards_.size()];
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.names.find(mangled);
+        if (found != shard.names.end()) {
+            return found->second;
+        }
+    }
+
+    // Demangled outside the lock; a thread racing on the same name does
+    // the work twice and the first to insert wins.
+    std::string demangled;
+    const bool succeeded = symbolicator::demangle(mangled, demangled);
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto found = shard.names.find(mangled);
+    if (found != shard.names.end()) {
+        return found->second;
+    }
+    const std::string &key = shard.strings.emplace_back(mangled);
+    const char *value = key.c_str();
+    if (succeeded) {
+        value = shard.strings.emplace_back(std::move(demangled)).c_str();
+    }
+    shard.names.emplace(key, value);
+    return value;
+}
+
+size_t DemangleCache::size() const {
+    size_t size = 0;
+    for (const auto &shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        size += shard.names.size();
+    }
+    return size;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,60 @@
+//
+//  demangler.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_DEMANGLER_HPP
+#define SYMBOLICATOR_DEMANGLER_HPP
+
+#include <array>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace symbolicator {
+
+/// Whether `name` looks like a Swift or Itanium C++ mangled name, as either
+/// appears in DWARF or, with one more leading underscore, in Mach-O symbols.
+bool isMangled(std::string_view name);
+
+/// Demangles a Swift or Itanium C++ name. Returns false and leaves `out`
+/// alone for anything else and for manglings the demanglers do not cover.
+bool demangle(std::string_view name, std::string &out);
+
+/// Memo table from mangled to demangled names, safe to share between
+/// threads. A crash batch sees the same few thousand functions over and
+/// over, so each is demangled once; names that fail to demangle are
+/// remembered too and come back unchanged.
+class DemangleCache {
+public:
+    DemangleCache() = default;
+    DemangleCache(const DemangleCache &) = delete;
+    DemangleCache &operator=(const DemangleCache &) = delete;
+
+    /// Returns the demangled form of `name`, or `name` itself when it is not
+    /// mangled. Returned strings other than `name` live as long as the cache.
+    const char *demangle(const char *name);
+
+    /// Number of distinct mangled names seen.
+    size_t size() const;
+
+private:
+    /// Names hash to one of several independently locked shards, so
+    /// threads resolving different reports rarely wait for each other.
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, const char *> names; ///< Keys view `strings`.
+        std::deque<std::string> strings;
+    };
+
+    std::array<Shard, 16> shards_;
+};
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,238 @@
+//
+//  directory_watcher.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "directory_watcher.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include "error.hpp"
+
+#if defined(__APPLE__)
+#include <CoreServices/CoreServices.h>
+#include <dispatch/dispatch.h>
+#elif defined(__linux__)
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <sys/inotify.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#endif
+
+namespace symbolicator {
+
+namespace {
+
+std::string withoutTrailingSlash(std::string path) {
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+} // namespace
+
+#if defined(__APPLE__)
+
+/// One FSEvents stream over all roots, delivering on a serial queue. The
+/// stream's latency does the coalescing; events name the directory whose
+/// entries changed, which is what the owner rescans anyway.
+struct DirectoryWatcher::Backend {
+    Changed changed;
+    std::vector<std::string> roots;
+    FSEventStreamRef stream = nullptr;
+    dispatch_queue_t queue = nullptr;
+
+    static void callback(ConstFSEventStreamRef, void *info, size_t count, void *eventPaths,
+                         const FSEventStreamEventFlags flags[], const FSEventStreamEventId[]) {
+        auto *backend = static_cast<Backend *>(info);
+        auto **paths = static_cast<char **>(eventPaths);
+        std::vector<std::string> directories;
+        for (size_t index = 0; index < count; ++index) {
+            if (flags[index] & kFSEventStreamEventFlagRootChanged) {
+                directories.insert(directories.end(), backend->roots.begin(), backend->roots.end());
+            } else {
+                directories.push_back(withoutTrailingSlash(paths[index]));
+            }
+        }
+        if (!directories.empty()) {
+            backend->changed(directories);
+        }
+    }
+
+    ~Backend() {
+        if (stream != nullptr) {
+            FSEventStreamStop(stream);
+            FSEventStreamInvalidate(stream);
+            FSEventStreamRelease(stream);
+        }
+        if (queue != nullptr) {
+            // Waits out a callback that is already running.
+            dispatch_sync_f(queue, nullptr, [](void *) {});
+            dispatch_release(queue);
+        }
+    }
+};
+
+DirectoryWatcher::DirectoryWatcher(const std::vector<std::string> &roots, Changed changed)
+    : backend_(std::make_unique<Backend>()) {
+    backend_->changed = std::move(changed);
+    CFMutableArrayRef paths = CFArrayCreateMutable(nullptr, 0, &kCFTypeArrayCallBacks);
+    for (const auto &root : roots) {
+        backend_->roots.push_back(withoutTrailingSlash(root));
+        CFStringRef path = CFStringCreateWithCString(nullptr, root.c_str(), kCFStringEncodingUTF8);
+        if (path != nullptr) {
+            CFArrayAppendValue(paths, path);
+            CFRelease(path);
+        }
+    }
+
+    FSEventStreamContext context {0, backend_.get(), nullptr, nullptr, nullptr};
+    backend_->stream = FSEventStreamCreate(nullptr, &Backend::callback, &context, paths, kFSEventStreamEventIdSinceNow,
+                                           0.5, kFSEventStreamCreateFlagWatchRoot);
+    CFRelease(paths);
+    if (backend_->stream == nullptr) {
+        throw Error(SYMBOLICATOR_E_IO_ERROR, "could not create an FSEvents stream");
+    }
+    backend_->queue = dispatch_queue_create("symbolicator.directory-watcher", DISPATCH_QUEUE_SERIAL);
+    FSEventStreamSetDispatchQueue(backend_->stream, backend_->queue);
+    if (!FSEventStreamStart(backend_->stream)) {
+        throw Error(SYMBOLICATOR_E_IO_ERROR, "could not start the FSEvents stream");
+    }
+}
+
+void DirectoryWatcher::add(const std::string &) {}
+
+#elif defined(__linux__)
+
+/// One inotify instance with a watch per directory, read by a thread that
+/// collects the changed directories for `kSettleTime` after the first
+/// notification, so copying a whole bundle in comes out as one call.
+struct DirectoryWatcher::Backend {
+    static constexpr uint32_t kMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+                                      IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+    static constexpr std::chrono::milliseconds kSettleTime {300};
+
+    Changed changed;
+    std::vector<std::string> roots;
+    int notify = -1;
+    int wake[2] = {-1, -1}; ///< Written to once, to stop the thread.
+    std::mutex mutex;
+    std::unordered_map<int, std::string> directories; ///< By watch descriptor.
+    std::thread thread;
+
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        std::set<std::string> pending;
+        Clock::time_point deadline;
+        alignas(inotify_event) char buffer[64 * 1024];
+        for (;;) {
+            int timeout = -1;
+            if (!pending.empty()) {
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+                timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(0, left.count()));
+            }
+            pollfd fds[2] = {{notify, POLLIN, 0}, {wake[0], POLLIN, 0}};
+            if (::poll(fds, 2, timeout) < 0 && errno != EINTR) {
+                return;
+            }
+            if (fds[1].revents != 0) {
+                return;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                const ssize_t length = ::read(notify, buffer, sizeof(buffer));
+                const bool wasIdle = pending.empty();
+                std::lock_guard<std::mutex> lock(mutex);
+                for (ssize_t offset = 0; length > 0 && offset < length;) {
+                    const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        pending.insert(roots.begin(), roots.end());
+                        continue;
+                    }
+                    auto found = directories.find(event->wd);
+                    if (found == directories.end()) {
+                        continue;
+                    }
+                    if (event->mask & IN_IGNORED) {
+                        directories.erase(found);
+                    } else {
+                        pending.insert(found->second);
+                    }
+                }
+                if (wasIdle && !pending.empty()) {
+                    deadline = Clock::now() + kSettleTime;
+                }
+            }
+
+            if (!pending.empty() && Clock::now() >= deadline) {
+                changed(std::vector<std::string>(pending.begin(), pending.end()));
+                pending.clear();
+            }
+        }
+    }
+
+    ~Backend() {
+        if (thread.joinable()) {
+            const char stop = 0;
+            (void)!::write(wake[1], &stop, 1);
+            thread.join();
+        }
+        for (int fd : {notify, wake[0], wake[1]}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+};
+
+DirectoryWatcher::DirectoryWatcher(const std::vector<std::string> &roots, Changed changed)
+    : backend_(std::make_unique<Backend>()) {
+    backend_->changed = std::move(changed);
+    backend_->notify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (backend_->notify < 0 || ::pipe2(backend_->wake, O_CLOEXEC) != 0) {
+        throw Error(SYMBOLICATOR_E_IO_ERROR, std::string("inotify: ") + std::strerror(errno));
+    }
+    for (const auto &root : roots) {
+        backend_->roots.push_back(withoutTrailingSlash(root));
+        add(backend_->roots.back());
+    }
+    backend_->thread = std::thread([backend = backend_.get()] { backend->run(); });
+}
+
+void DirectoryWatcher::add(const std::string &directory) {
+    std::lock_guard<std::mutex> lock(backend_->mutex);
+    // Running out of watches (fs.inotify.max_user_watches) leaves that
+    // directory to the next full refresh.
+    const int watch = ::inotify_add_watch(backend_->notify, directory.c_str(), Backend::kMask);
+    if (watch >= 0) {
+        backend_->directories[watch] = withoutTrailingSlash(directory);
+    }
+}
+
+#else
+
+struct DirectoryWatcher::Backend {};
+
+DirectoryWatcher::DirectoryWatcher(const std::vector<std::string> &, Changed) {
+    throw Error(SYMBOLICATOR_E_IO_ERROR, "directory change notifications are not supported on this system");
+}
+
+void DirectoryWatcher::add(const std::string &) {}
+
+#endif
+
+DirectoryWatcher::~DirectoryWatcher() = default;
+
+} // namespace symbolicator
@@ -0,0 +1,51 @@
+//
+//  directory_watcher.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_DIRECTORY_WATCHER_HPP
+#define SYMBOLICATOR_DIRECTORY_WATCHER_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace symbolicator {
+
+/// Reports which directories below a set of roots had entries added,
+/// removed or rewritten, through FSEvents on macOS and inotify on Linux.
+///
+/// Notifications arriving close together are coalesced into one call of
+/// `changed` with every affected directory, on a thread of the watcher's
+/// own. A directory may be reported that no longer exists; when the system
+/// dropped notifications, the roots themselves are reported.
+class DirectoryWatcher {
+public:
+    using Changed = std::function<void(const std::vector<std::string> &directories)>;
+
+    /// Starts watching. Throws `Error` when change notifications are not
+    /// available on this system.
+    DirectoryWatcher(const std::vector<std::string> &roots, Changed changed);
+    /// Stops watching; once it returns, `changed` is no longer running.
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher &) = delete;
+    DirectoryWatcher &operator=(const DirectoryWatcher &) = delete;
+
+    /// Watches `directory` too. inotify watches one directory at a time, so
+    /// the owner passes each one below the roots as it learns of it; FSEvents
+    /// covers whole trees and ignores this. May be called from `changed`.
+    void add(const std::string &directory);
+
+private:
+    struct Backend;
+    std::unique_ptr<Backend> backend_;
+};
+
+} // namespace symbolicator
+
+#endif
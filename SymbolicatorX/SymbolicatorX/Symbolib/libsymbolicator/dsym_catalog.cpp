@@ -0,0 +1,675 @@
+//
+//  dsym_catalog.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "dsym_catalog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+
+#include "data_reader.hpp"
+#include "directory_watcher.hpp"
+#include "error.hpp"
+#include "mapped_file.hpp"
+#include "symbol_store.hpp"
+#include "work_pool.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+constexpr char kCatalogMagic[8] = {'S', 'X', 'C', 'A', 'T', 'L', 'O', 'G'};
+constexpr uint32_t kCatalogVersion = 1;
+
+/// Smallest file that can hold a Mach-O header.
+constexpr uint64_t kMinimumMachOSize = 28;
+
+int64_t modificationTime(const struct stat &info) {
+#ifdef __APPLE__
+    return static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+}
+
+std::string joinPath(const std::string &directory, const std::string &name) {
+    return !directory.empty() && directory.back() == '/' ? directory + name : directory + "/" + name;
+}
+
+bool isBelow(const std::string &path, const std::string &root) {
+    return path.compare(0, root.size(), root) == 0 &&
+           (path.size() == root.size() || path[root.size()] == '/' || root == "/");
+}
+
+/// Sorted `paths` without trailing slashes and without those below another.
+std::vector<std::string> outermost(std::vector<std::string> paths) {
+    for (auto &path : paths) {
+        while (path.size() > 1 && path.back() == '/') {
+            path.pop_back();
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    std::vector<std::string> result;
+    for (auto &path : paths) {
+        if (!path.empty() && (result.empty() || !isBelow(path, result.back()))) {
+            result.push_back(std::move(path));
+        }
+    }
+    return result;
+}
+
+bool looksLikeMachO(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    uint8_t magic[4] = {};
+    const bool read = ::read(fd, magic, sizeof(magic)) == static_cast<ssize_t>(sizeof(magic));
+    ::close(fd);
+    if (!read) {
+        return false;
+    }
+    const uint32_t little = magic[0] | (magic[1] << 8) | (magic[2] << 16) | (static_cast<uint32_t>(magic[3]) << 24);
+    const uint32_t big = (static_cast<uint32_t>(magic[0]) << 24) | (magic[1] << 16) | (magic[2] << 8) | magic[3];
+    return little == 0xfeedface || little == 0xfeedfacf || big == 0xcafebabe || big == 0xcafebabf;
+}
+
+/// Slices with a UUID of the Mach-O file or symbol store at `path`; empty
+/// for anything else.
+std::vector<MachOSlice> readSlices(const std::string &path, uint64_t size) {
+    std::vector<MachOSlice> slices;
+    MachOSlice store;
+    if (readSymbolStoreSlice(path, store)) {
+        slices.push_back(store);
+        return slices;
+    }
+    if (size < kMinimumMachOSize || !looksLikeMachO(path)) {
+        return slices;
+    }
+    try {
+        slices = MachOFile::slices(path);
+    } catch (const Error &) {
+        return {};
+    }
+    slices.erase(std::remove_if(slices.begin(), slices.end(), [](const MachOSlice &slice) { return !slice.hasUUID; }),
+                 slices.end());
+    return slices;
+}
+
+/// Whether `path` holds debug symbols: a file in a .dSYM bundle, or a
+/// symbol store, which is named like one.
+bool isInDSYM(const std::string &path) {
+    constexpr std::string_view kStoreSuffix = ".symstore";
+    return path.find(".dSYM/") != std::string::npos ||
+           (path.size() >= kStoreSuffix.size() &&
+            path.compare(path.size() - kStoreSuffix.size(), kStoreSuffix.size(), kStoreSuffix) == 0);
+}
+
+template <typename T>
+void put(std::string &out, T value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void putString(std::string &out, const std::string &value) {
+    put<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+std::string getString(DataReader &reader) {
+    const uint32_t size = reader.u32();
+    const auto *data = reinterpret_cast<const char *>(reader.current());
+    reader.skip(size);
+    return std::string(data, size);
+}
+
+} // namespace
+
+/// Directories listed by one update, filled in by the scan tasks.
+struct DSYMCatalog::Scan {
+    std::vector<std::string> relisted; ///< Listed even with an unchanged mtime; sorted.
+    /// With a search, the UUIDs searched for, sorted; the scan is cancelled
+    /// once a dSYM holding each of them has been seen.
+    std::vector<std::array<uint8_t, 16>> wanted;
+    std::atomic<bool> cancelled {false};
+
+    std::mutex mutex;
+    std::map<std::string, Directory> visited;
+    std::vector<bool> matched; ///< Parallel to `wanted`.
+    size_t unmatched = 0;
+
+    explicit Scan(std::vector<std::string> relisted = {}) : relisted(std::move(relisted)) {
+        std::sort(this->relisted.begin(), this->relisted.end());
+    }
+
+    /// Notes the UUIDs of those `files` in `directory` that hold debug
+    /// symbols.
+    void match(const std::string &directory, const std::vector<File> &files) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &file : files) {
+            if (!isInDSYM(joinPath(directory, file.name))) {
+                continue;
+            }
+            for (const auto &slice : file.slices) {
+                auto found = std::lower_bound(wanted.begin(), wanted.end(), slice.uuid);
+                if (found == wanted.end() || *found != slice.uuid || matched[found - wanted.begin()]) {
+                    continue;
+                }
+                matched[found - wanted.begin()] = true;
+                if (--unmatched == 0) {
+                    cancelled.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+};
+
+DSYMCatalog::DSYMCatalog(std::string file) : file_(std::move(file)) {
+    load();
+}
+
+DSYMCatalog::~DSYMCatalog() = default;
+
+void DSYMCatalog::load() {
+    if (file_.empty()) {
+        return;
+    }
+
+    MappedFile mapping;
+    try {
+        mapping = MappedFile::open(file_);
+    } catch (const Error &) {
+        return;
+    }
+
+    // A damaged or outdated catalog is dropped and rebuilt by the next refresh.
+    try {
+        DataReader reader(mapping.data(), mapping.size());
+        char magic[sizeof(kCatalogMagic)];
+        for (char &character : magic) {
+            character = static_cast<char>(reader.u8());
+        }
+        if (std::memcmp(magic, kCatalogMagic, sizeof(magic)) != 0 || reader.u32() != kCatalogVersion) {
+            return;
+        }
+
+        std::map<std::string, Directory> directories;
+        for (uint64_t count = reader.u64(); count > 0; --count) {
+            std::string path = getString(reader);
+            Directory &directory = directories[std::move(path)];
+            directory.modified = static_cast<int64_t>(reader.u64());
+            for (uint32_t subdirectories = reader.u32(); subdirectories > 0; --subdirectories) {
+                directory.subdirectories.push_back(getString(reader));
+            }
+            for (uint32_t files = reader.u32(); files > 0; --files) {
+                File file;
+                file.name = getString(reader);
+                file.modified = static_cast<int64_t>(reader.u64());
+                file.size = reader.u64();
+                for (uint32_t slices = reader.u32(); slices > 0; --slices) {
+                    MachOSlice slice;
+                    slice.architecture.type = reader.u32();
+                    slice.architecture.subtype = reader.u32();
+                    slice.hasUUID = true;
+                    for (uint8_t &byte : slice.uuid) {
+                        byte = reader.u8();
+                    }
+                    file.slices.push_back(slice);
+                }
+                directory.files.push_back(std::move(file));
+            }
+        }
+        directories_ = std::move(directories);
+    } catch (const Error &) {
+        return;
+    }
+    rebuildIndex();
+}
+
+void DSYMCatalog::save() const {
+    if (file_.empty()) {
+        return;
+    }
+
+    std::string out;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out.append(kCatalogMagic, sizeof(kCatalogMagic));
+        put<uint32_t>(out, kCatalogVersion);
+        put<uint64_t>(out, directories_.size());
+        for (const auto &entry : directories_) {
+            const Directory &directory = entry.second;
+            putString(out, entry.first);
+            put<uint64_t>(out, static_cast<uint64_t>(directory.modified));
+            put<uint32_t>(out, static_cast<uint32_t>(directory.subdirectories.size()));
+            for (const auto &name : directory.subdirectories) {
+                putString(out, name);
+            }
+            put<uint32_t>(out, static_cast<uint32_t>(directory.files.size()));
+            for (const auto &file : directory.files) {
+                putString(out, file.name);
+                put<uint64_t>(out, static_cast<uint64_t>(file.modified));
+                put<uint64_t>(out, file.size);
+                put<uint32_t>(out, static_cast<uint32_t>(file.slices.size()));
+                for (const auto &slice : file.slices) {
+                    put<uint32_t>(out, slice.architecture.type);
+                    put<uint32_t>(out, slice.architecture.subtype);
+                    out.append(reinterpret_cast<const char *>(slice.uuid.data()), slice.uuid.size());
+                }
+            }
+        }
+    }
+
+    const size_t slash = file_.find_last_of('/');
+    if (slash != std::string::npos && slash > 0) {
+        createDirectories(file_.substr(0, slash));
+    }
+    writeFileAtomically(file_, out);
+}
+
+void DSYMCatalog::scan(const std::string &path, int64_t modified, Scan &state, WorkPool &pool) const {
+    if (state.cancelled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    Directory current;
+    current.modified = modified;
+
+    auto found = directories_.find(path);
+    const Directory *previous = found != directories_.end() ? &found->second : nullptr;
+    auto reused = [&](const std::string &name, const struct stat &info) -> const File * {
+        if (previous == nullptr) {
+            return nullptr;
+        }
+        auto file = std::lower_bound(previous->files.begin(), previous->files.end(), name,
+                                     [](const File &lhs, const std::string &rhs) { return lhs.name < rhs; });
+        if (file == previous->files.end() || file->name != name || file->modified != modificationTime(info) ||
+            file->size != static_cast<uint64_t>(info.st_size)) {
+            return nullptr;
+        }
+        return &*file;
+    };
+    auto addFile = [&](const std::string &name, const struct stat &info) {
+        if (const File *file = reused(name, info)) {
+            current.files.push_back(*file);
+            return;
+        }
+        File file;
+        file.name = name;
+        file.modified = modificationTime(info);
+        file.size = static_cast<uint64_t>(info.st_size);
+        file.slices = readSlices(joinPath(path, name), file.size);
+        if (!file.slices.empty()) {
+            current.files.push_back(std::move(file));
+        }
+    };
+
+    struct stat info;
+    if (previous != nullptr && previous->modified == modified &&
+        !std::binary_search(state.relisted.begin(), state.relisted.end(), path)) {
+        // Same entries as last time: only files rewritten in place can differ.
+        current.subdirectories = previous->subdirectories;
+        for (const auto &file : previous->files) {
+            if (::lstat(joinPath(path, file.name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+                addFile(file.name, info);
+            }
+        }
+    } else {
+        DIR *directory = ::opendir(path.c_str());
+        if (directory == nullptr) {
+            return;
+        }
+        while (const dirent *entry = ::readdir(directory)) {
+            const std::string name = entry->d_name;
+            if (name.front() == '.' || ::lstat(joinPath(path, name).c_str(), &info) != 0) {
+                continue;
+            }
+            if (S_ISDIR(info.st_mode)) {
+                current.subdirectories.push_back(name);
+            } else if (S_ISREG(info.st_mode)) {
+                addFile(name, info);
+            }
+        }
+        ::closedir(directory);
+        std::sort(current.subdirectories.begin(), current.subdirectories.end());
+        std::sort(current.files.begin(), current.files.end(),
+                  [](const File &lhs, const File &rhs) { return lhs.name < rhs.name; });
+    }
+
+    if (!state.wanted.empty()) {
+        state.match(path, current.files);
+    }
+
+    for (const auto &name : current.subdirectories) {
+        if (state.cancelled.load(std::memory_order_relaxed)) {
+            break;
+        }
+        std::string child = joinPath(path, name);
+        if (::lstat(child.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+            const int64_t childModified = modificationTime(info);
+            pool.submit([this, child = std::move(child), childModified, &state, &pool] {
+                try {
+                    scan(child, childModified, state, pool);
+                } catch (const std::exception &) {
+                    // An unreadable directory is retried by the next refresh.
+                }
+            });
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.visited.emplace(path, std::move(current));
+}
+
+void DSYMCatalog::classify(const std::vector<std::string> &roots, std::vector<std::string> &directories,
+                           std::vector<std::pair<std::string, File>> &files) {
+    for (std::string root : roots) {
+        while (root.size() > 1 && root.back() == '/') {
+            root.pop_back();
+        }
+        struct stat info;
+        if (root.empty() || ::stat(root.c_str(), &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            directories.push_back(root);
+        } else if (S_ISREG(info.st_mode)) {
+            File file;
+            file.modified = modificationTime(info);
+            file.size = static_cast<uint64_t>(info.st_size);
+            file.slices = readSlices(root, file.size);
+            if (!file.slices.empty()) {
+                files.emplace_back(root, std::move(file));
+            }
+        }
+    }
+}
+
+void DSYMCatalog::refresh(const std::vector<std::string> &roots, WorkPool &pool) {
+    {
+        std::lock_guard<std::mutex> updating(updateMutex_);
+
+        std::vector<std::string> directoryRoots;
+        std::vector<std::pair<std::string, File>> looseFiles;
+        classify(roots, directoryRoots, looseFiles);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            looseFiles_ = std::move(looseFiles);
+        }
+        Scan state;
+        catchUp(directoryRoots, state, pool);
+    }
+
+    try {
+        save();
+    } catch (const Error &) {
+        // A read-only cache directory must not fail the search itself.
+    }
+}
+
+size_t DSYMCatalog::search(const std::vector<std::array<uint8_t, 16>> &uuids, const std::vector<std::string> &roots,
+                           WorkPool &pool) {
+    Scan state;
+    {
+        std::lock_guard<std::mutex> updating(updateMutex_);
+
+        std::vector<std::string> directoryRoots;
+        std::vector<std::pair<std::string, File>> looseFiles;
+        classify(roots, directoryRoots, looseFiles);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &entry : looseFiles) {
+                auto same = std::find_if(looseFiles_.begin(), looseFiles_.end(),
+                                         [&](const auto &loose) { return loose.first == entry.first; });
+                if (same != looseFiles_.end()) {
+                    same->second = std::move(entry.second);
+                } else {
+                    looseFiles_.push_back(std::move(entry));
+                }
+            }
+            rebuildIndex();
+
+            for (const auto &uuid : uuids) {
+                if (!hasDSYM(uuid)) {
+                    state.wanted.push_back(uuid);
+                }
+            }
+        }
+        std::sort(state.wanted.begin(), state.wanted.end());
+        state.wanted.erase(std::unique(state.wanted.begin(), state.wanted.end()), state.wanted.end());
+        state.matched.assign(state.wanted.size(), false);
+        state.unmatched = state.wanted.size();
+        if (!state.wanted.empty()) {
+            catchUp(directoryRoots, state, pool);
+        }
+    }
+
+    if (!state.wanted.empty()) {
+        try {
+            save();
+        } catch (const Error &) {
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(
+        std::count_if(uuids.begin(), uuids.end(), [this](const auto &uuid) { return hasDSYM(uuid); }));
+}
+
+bool DSYMCatalog::watch(const std::vector<std::string> &roots, unsigned threads) {
+    std::vector<std::string> directoryRoots;
+    for (const auto &root : outermost(roots)) {
+        struct stat info;
+        if (::stat(root.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+            directoryRoots.push_back(root);
+        }
+    }
+
+    {
+        // Held until the watcher and the first update are in place, so
+        // notifications arriving meanwhile wait for them.
+        std::lock_guard<std::mutex> updating(updateMutex_);
+        if (!watchPool_) {
+            watchPool_ = std::make_unique<WorkPool>(threads);
+        }
+        if (!watcher_) {
+            try {
+                watcher_ = std::make_unique<DirectoryWatcher>(
+                    directoryRoots, [this](const std::vector<std::string> &directories) { changed(directories); });
+            } catch (const Error &) {
+            }
+            if (watcher_) {
+                for (const auto &entry : directories_) {
+                    for (const auto &root : directoryRoots) {
+                        if (isBelow(entry.first, root)) {
+                            watcher_->add(entry.first);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        Scan state;
+        catchUp(directoryRoots, state, *watchPool_);
+    }
+
+    try {
+        save();
+    } catch (const Error &) {
+    }
+    return watcher_ != nullptr;
+}
+
+void DSYMCatalog::changed(const std::vector<std::string> &directories) {
+    std::lock_guard<std::mutex> updating(updateMutex_);
+    try {
+        // Reported directories are listed whatever their mtime says: a file
+        // may have been half written when its directory was last listed.
+        Scan state(outermost(directories));
+        catchUp(directories, state, *watchPool_);
+        save();
+    } catch (const std::exception &) {
+        // Retried with the next change below the same directory.
+    }
+}
+
+void DSYMCatalog::catchUp(const std::vector<std::string> &directories, Scan &state, WorkPool &pool) {
+    std::vector<std::string> added = update(directories, state, pool);
+    // Entries created in a new directory before its watch was added went
+    // unreported, so new directories are listed once more after it is. A
+    // search that was cancelled leaves that to the next refresh.
+    while (watcher_ && !added.empty()) {
+        for (const auto &directory : added) {
+            watcher_->add(directory);
+        }
+        if (state.cancelled) {
+            break;
+        }
+        Scan next(added);
+        added = update(added, next, pool);
+    }
+}
+
+std::vector<std::string> DSYMCatalog::update(const std::vector<std::string> &directories, Scan &state,
+                                             WorkPool &pool) {
+    const std::vector<std::string> scanned = outermost(directories);
+    for (const auto &directory : scanned) {
+        struct stat info;
+        if (::stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+            continue;
+        }
+        const int64_t modified = modificationTime(info);
+        pool.submit([this, &directory, modified, &state, &pool] {
+            try {
+                scan(directory, modified, state, pool);
+            } catch (const std::exception &) {
+            }
+        });
+    }
+    pool.wait();
+
+    std::vector<std::string> added;
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Directories below a scanned one that the scan did not reach are gone,
+    // unless the scan was cancelled before reaching them.
+    for (const auto &directory : state.cancelled ? std::vector<std::string>() : scanned) {
+        for (auto entry = directories_.lower_bound(directory); entry != directories_.end();) {
+            const std::string &path = entry->first;
+            if (path.compare(0, directory.size(), directory) != 0) {
+                break;
+            }
+            entry = isBelow(path, directory) && state.visited.count(path) == 0 ? directories_.erase(entry)
+                                                                               : std::next(entry);
+        }
+    }
+    for (auto &entry : state.visited) {
+        auto found = directories_.find(entry.first);
+        if (found == directories_.end()) {
+            added.push_back(entry.first);
+            directories_.emplace(entry.first, std::move(entry.second));
+        } else {
+            found->second = std::move(entry.second);
+        }
+    }
+    rebuildIndex();
+    return added;
+}
+
+void DSYMCatalog::rebuildIndex() {
+    index_.clear();
+    auto add = [&](const std::string &path, const File &file) {
+        const bool inDSYM = isInDSYM(path);
+        for (const auto &slice : file.slices) {
+            index_.push_back({slice.uuid, slice.architecture.type, inDSYM, path});
+        }
+    };
+    for (const auto &entry : directories_) {
+        for (const auto &file : entry.second.files) {
+            add(joinPath(entry.first, file.name), file);
+        }
+    }
+    for (const auto &entry : looseFiles_) {
+        add(entry.first, entry.second);
+    }
+    std::sort(index_.begin(), index_.end(), [](const Slot &lhs, const Slot &rhs) {
+        return std::tie(lhs.uuid, rhs.inDSYM, lhs.path) < std::tie(rhs.uuid, lhs.inDSYM, rhs.path);
+    });
+}
+
+bool DSYMCatalog::hasDSYM(const std::array<uint8_t, 16> &uuid) const {
+    auto slot = std::lower_bound(index_.begin(), index_.end(), uuid,
+                                 [](const Slot &lhs, const std::array<uint8_t, 16> &rhs) { return lhs.uuid < rhs; });
+    // Slots in a dSYM come first.
+    for (; slot != index_.end() && slot->uuid == uuid && slot->inDSYM; ++slot) {
+        if (::access(slot->path.c_str(), R_OK) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string DSYMCatalog::find(const std::array<uint8_t, 16> &uuid, const char *arch) const {
+    CpuArchitecture architecture;
+    const bool matchesArchitecture = arch != nullptr && CpuArchitecture::parse(arch, architecture);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto slot = std::lower_bound(index_.begin(), index_.end(), uuid,
+                                 [](const Slot &lhs, const std::array<uint8_t, 16> &rhs) { return lhs.uuid < rhs; });
+    for (; slot != index_.end() && slot->uuid == uuid; ++slot) {
+        if (matchesArchitecture && slot->cpuType != architecture.type) {
+            continue;
+        }
+        // Entries of roots that were not refreshed lately may be stale.
+        if (::access(slot->path.c_str(), R_OK) == 0) {
+            return slot->path;
+        }
+    }
+    return std::string();
+}
+
+std::vector<MachOSlice> DSYMCatalog::slices(const std::vector<std::string> &roots) const {
+    const std::vector<std::string> normalized = outermost(roots);
+    auto below = [&](const std::string &path) {
+        return std::any_of(normalized.begin(), normalized.end(),
+                           [&](const std::string &root) { return isBelow(path, root); });
+    };
+
+    std::vector<MachOSlice> slices;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &entry : directories_) {
+            if (!below(entry.first)) {
+                continue;
+            }
+            for (const auto &file : entry.second.files) {
+                slices.insert(slices.end(), file.slices.begin(), file.slices.end());
+            }
+        }
+        for (const auto &entry : looseFiles_) {
+            if (below(entry.first)) {
+                slices.insert(slices.end(), entry.second.slices.begin(), entry.second.slices.end());
+            }
+        }
+    }
+
+    auto key = [](const MachOSlice &slice) {
+        return std::tie(slice.uuid, slice.architecture.type, slice.architecture.subtype);
+    };
+    std::sort(slices.begin(), slices.end(), [&](const MachOSlice &lhs, const MachOSlice &rhs) { return key(lhs) < key(rhs); });
+    slices.erase(std::unique(slices.begin(), slices.end(),
+                             [&](const MachOSlice &lhs, const MachOSlice &rhs) { return key(lhs) == key(rhs); }),
+                 slices.end());
+    return slices;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,135 @@
+//
+//  dsym_catalog.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_DSYM_CATALOG_HPP
+#define SYMBOLICATOR_DSYM_CATALOG_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "macho_file.hpp"
+
+namespace symbolicator {
+
+class DirectoryWatcher;
+class WorkPool;
+
+/// Persistent map from LC_UUID to the Mach-O files below a set of search
+/// roots, such as dSYM stores or Xcode's Archives folder.
+///
+/// UUIDs are read from the load commands of every Mach-O file and the header
+/// of every symbol store, with one task per directory on a `WorkPool`. The catalog remembers the mtime of
+/// each directory it listed: on a refresh, a directory whose mtime has not
+/// changed is not listed again and only its known Mach-O files are stat'ed,
+/// so an unchanged tree costs one stat per directory and no file reads.
+///
+/// Roots passed to `watch` are kept up to date in the background from
+/// filesystem change notifications, one directory at a time, so bundles
+/// copied in can be found within a second or so without any refresh.
+class DSYMCatalog {
+public:
+    /// Loads `file` when it holds a compatible catalog. An empty `file`
+    /// keeps the catalog in memory only.
+    explicit DSYMCatalog(std::string file);
+    ~DSYMCatalog();
+
+    DSYMCatalog(const DSYMCatalog &) = delete;
+    DSYMCatalog &operator=(const DSYMCatalog &) = delete;
+
+    /// Brings the part of the catalog below `roots` up to date, then saves
+    /// it. Roots may be directories or single Mach-O files. Symbolic links
+    /// below a root and names starting with a dot are not followed.
+    void refresh(const std::vector<std::string> &roots, WorkPool &pool);
+
+    /// Refreshes the directories among `roots` with `threads` scanning
+    /// threads (0 for one per core), then keeps following their changes
+    /// until the catalog is destroyed, saving after each update. Returns
+    /// false, after the refresh, when this system has no change
+    /// notifications. Later calls only refresh.
+    bool watch(const std::vector<std::string> &roots, unsigned threads);
+
+    /// Scans `roots` concurrently for dSYM bundles or symbol stores (files
+    /// named *.symstore) holding `uuids`, and stops as soon as one has been
+    /// seen for each of them. The directories listed on the way join the
+    /// catalog, and the catalog is saved. UUIDs already found in a dSYM are
+    /// not searched for. Returns how many of
+    /// `uuids` `find` can now locate in a dSYM.
+    size_t search(const std::vector<std::array<uint8_t, 16>> &uuids, const std::vector<std::string> &roots,
+                  WorkPool &pool);
+
+    /// Path of a Mach-O file or symbol store with `uuid` and, unless `arch`
+    /// is null, a slice for `arch`. DWARF files inside a .dSYM bundle and
+    /// symbol stores win over other binaries with the same UUID. Empty when
+    /// no existing file is known.
+    std::string find(const std::array<uint8_t, 16> &uuid, const char *arch) const;
+
+    /// Slices with a UUID of the Mach-O files and symbol stores the catalog
+    /// knows below `roots`, one per UUID and architecture.
+    std::vector<MachOSlice> slices(const std::vector<std::string> &roots) const;
+
+    /// Writes the catalog to its file. Throws `Error`.
+    void save() const;
+
+    const std::string &file() const { return file_; }
+
+private:
+    struct File {
+        std::string name;
+        int64_t modified = 0;
+        uint64_t size = 0;
+        std::vector<MachOSlice> slices;
+    };
+
+    struct Directory {
+        int64_t modified = 0;
+        std::vector<std::string> subdirectories;
+        std::vector<File> files; ///< Mach-O files only, sorted by name.
+    };
+
+    struct Slot {
+        std::array<uint8_t, 16> uuid;
+        uint32_t cpuType;
+        bool inDSYM;
+        std::string path;
+    };
+
+    struct Scan;
+
+    void load();
+    void scan(const std::string &path, int64_t modified, Scan &state, WorkPool &pool) const;
+    static void classify(const std::vector<std::string> &roots, std::vector<std::string> &directories,
+                         std::vector<std::pair<std::string, File>> &files);
+    std::vector<std::string> update(const std::vector<std::string> &directories, Scan &state, WorkPool &pool);
+    void catchUp(const std::vector<std::string> &directories, Scan &state, WorkPool &pool);
+    void changed(const std::vector<std::string> &directories);
+    void rebuildIndex();
+    bool hasDSYM(const std::array<uint8_t, 16> &uuid) const; ///< With `mutex_` held.
+
+    std::string file_;
+
+    /// Serializes updates. Scans read `directories_` holding only this one;
+    /// changes to it take `mutex_` as well, which lookups take.
+    std::mutex updateMutex_;
+    mutable std::mutex mutex_;
+    std::map<std::string, Directory> directories_; ///< Keyed by path.
+    std::vector<std::pair<std::string, File>> looseFiles_; ///< Roots that are files; not saved.
+    std::vector<Slot> index_; ///< Sorted by UUID, preferred path first.
+
+    std::unique_ptr<WorkPool> watchPool_;
+    std::unique_ptr<DirectoryWatcher> watcher_; ///< Last, so it stops first.
+};
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,919 @@
+//
+//  dwarf_reader.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "dwarf_reader.hpp"
+
+#include <algorithm>
+
+#include "error.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+enum : uint16_t {
+    DW_TAG_inlined_subroutine = 0x1d,
+    DW_TAG_subprogram = 0x2e,
+    DW_TAG_compile_unit = 0x11,
+    DW_TAG_partial_unit = 0x3c,
+    DW_TAG_skeleton_unit = 0x4a,
+};
+
+enum : uint16_t {
+    DW_AT_name = 0x03,
+    DW_AT_stmt_list = 0x10,
+    DW_AT_low_pc = 0x11,
+    DW_AT_high_pc = 0x12,
+    DW_AT_comp_dir = 0x1b,
+    DW_AT_abstract_origin = 0x31,
+    DW_AT_specification = 0x47,
+    DW_AT_ranges = 0x55,
+    DW_AT_call_file = 0x58,
+    DW_AT_call_line = 0x59,
+    DW_AT_linkage_name = 0x6e,
+    DW_AT_str_offsets_base = 0x72,
+    DW_AT_addr_base = 0x73,
+    DW_AT_rnglists_base = 0x74,
+    DW_AT_MIPS_linkage_name = 0x2007,
+};
+
+enum : uint16_t {
+    DW_FORM_addr = 0x01,
+    DW_FORM_block2 = 0x03,
+    DW_FORM_block4 = 0x04,
+    DW_FORM_data2 = 0x05,
+    DW_FORM_data4 = 0x06,
+    DW_FORM_data8 = 0x07,
+    DW_FORM_string = 0x08,
+    DW_FORM_block = 0x09,
+    DW_FORM_block1 = 0x0a,
+    DW_FORM_data1 = 0x0b,
+    DW_FORM_flag = 0x0c,
+    DW_FORM_sdata = 0x0d,
+    DW_FORM_strp = 0x0e,
+    DW_FORM_udata = 0x0f,
+    DW_FORM_ref_addr = 0x10,
+    DW_FORM_ref1 = 0x11,
+    DW_FORM_ref2 = 0x12,
+    DW_FORM_ref4 = 0x13,
+    DW_FORM_ref8 = 0x14,
+    DW_FORM_ref_udata = 0x15,
+    DW_FORM_indirect = 0x16,
+    DW_FORM_sec_offset = 0x17,
+    DW_FORM_exprloc = 0x18,
+    DW_FORM_flag_present = 0x19,
+    DW_FORM_strx = 0x1a,
+    DW_FORM_addrx = 0x1b,
+    DW_FORM_ref_sup4 = 0x1c,
+    DW_FORM_strp_sup = 0x1d,
+    DW_FORM_data16 = 0x1e,
+    DW_FORM_line_strp = 0x1f,
+    DW_FORM_ref_sig8 = 0x20,
+    DW_FORM_implicit_const = 0x21,
+    DW_FORM_loclistx = 0x22,
+    DW_FORM_rnglistx = 0x23,
+    DW_FORM_ref_sup8 = 0x24,
+    DW_FORM_strx1 = 0x25,
+    DW_FORM_strx2 = 0x26,
+    DW_FORM_strx3 = 0x27,
+    DW_FORM_strx4 = 0x28,
+    DW_FORM_addrx1 = 0x29,
+    DW_FORM_addrx2 = 0x2a,
+    DW_FORM_addrx3 = 0x2b,
+    DW_FORM_addrx4 = 0x2c,
+    DW_FORM_GNU_addr_index = 0x1f01,
+    DW_FORM_GNU_str_index = 0x1f02,
+    DW_FORM_GNU_ref_alt = 0x1f20,
+    DW_FORM_GNU_strp_alt = 0x1f21,
+};
+
+enum : uint8_t {
+    DW_LNS_copy = 1,
+    DW_LNS_advance_pc = 2,
+    DW_LNS_advance_line = 3,
+    DW_LNS_set_file = 4,
+    DW_LNS_const_add_pc = 8,
+    DW_LNS_fixed_advance_pc = 9,
+    DW_LNE_end_sequence = 1,
+    DW_LNE_set_address = 2,
+};
+
+enum : uint64_t {
+    DW_LNCT_path = 1,
+    DW_LNCT_directory_index = 2,
+};
+
+enum : uint8_t {
+    DW_RLE_end_of_list = 0,
+    DW_RLE_base_addressx = 1,
+    DW_RLE_startx_endx = 2,
+    DW_RLE_startx_length = 3,
+    DW_RLE_offset_pair = 4,
+    DW_RLE_base_address = 5,
+    DW_RLE_start_end = 6,
+    DW_RLE_start_length = 7,
+};
+
+bool isStringIndexForm(uint16_t form) {
+    switch (form) {
+    case DW_FORM_strx:
+    case DW_FORM_strx1:
+    case DW_FORM_strx2:
+    case DW_FORM_strx3:
+    case DW_FORM_strx4:
+    case DW_FORM_GNU_str_index:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isAddressIndexForm(uint16_t form) {
+    switch (form) {
+    case DW_FORM_addrx:
+    case DW_FORM_addrx1:
+    case DW_FORM_addrx2:
+    case DW_FORM_addrx3:
+    case DW_FORM_addrx4:
+    case DW_FORM_GNU_addr_index:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Reads a value of `size` bytes at `offset` without disturbing `reader`.
+uint64_t peekUnsigned(DataReader reader, uint64_t offset, size_t size) {
+    if (offset + size > reader.size()) {
+        throwBadFormat("index points past end of section");
+    }
+    reader.seek(static_cast<size_t>(offset));
+    return reader.unsignedOfSize(size);
+}
+
+} // namespace
+
+DwarfReader::DwarfReader(const MachOFile &file, LazyLineTable *lazyLines)
+    : info_(file.sectionData("__debug_info")),
+      abbrev_(file.sectionData("__debug_abbrev")),
+      str_(file.sectionData("__debug_str")),
+      line_(file.sectionData("__debug_line")),
+      lineStr_(file.sectionData("__debug_line_str")),
+      strOffsets_(file.sectionData("__debug_str_offs")),
+      addr_(file.sectionData("__debug_addr")),
+      ranges_(file.sectionData("__debug_ranges")),
+      rnglists_(file.sectionData("__debug_rnglists")),
+      aranges_(file.sectionData("__debug_aranges")),
+      lazyLines_(lazyLines) {}
+
+void DwarfReader::read(SymbolIndexBuilder &builder) {
+    DataReader info = info_;
+    while (!info.atEnd()) {
+        readUnit(info, builder);
+    }
+
+    for (const auto &function : pending_) {
+        builder.addFunction(function.start, function.end, builder.intern(functionName(function.die)));
+    }
+    pending_.clear();
+
+    // Abstract origins may live in a later unit, so names wait until all
+    // subprograms are known.
+    for (const auto &site : pendingSites_) {
+        builder.nameInlineSite(site.site, builder.intern(functionName(site.origin)));
+    }
+    pendingSites_.clear();
+}
+
+const DwarfReader::AbbreviationTable &DwarfReader::abbreviations(uint64_t offset) {
+    auto found = abbreviationTables_.find(offset);
+    if (found != abbreviationTables_.end()) {
+        return *found->second;
+    }
+
+    auto table = std::make_unique<AbbreviationTable>();
+    DataReader reader = abbrev_;
+    reader.seek(static_cast<size_t>(offset));
+    while (true) {
+        const uint64_t code = reader.uleb128();
+        if (code == 0) {
+            break;
+        }
+        if (code > 0xffff) {
+            throwBadFormat("abbreviation code out of range");
+        }
+        if (table->size() <= code) {
+            table->resize(code + 1);
+        }
+
+        Abbreviation &abbreviation = (*table)[code];
+        abbreviation.tag = static_cast<uint16_t>(reader.uleb128());
+        abbreviation.hasChildren = reader.u8() != 0;
+        while (true) {
+            const auto name = static_cast<uint16_t>(reader.uleb128());
+            const auto form = static_cast<uint16_t>(reader.uleb128());
+            if (name == 0 && form == 0) {
+                break;
+            }
+            const int64_t implicitConst = form == DW_FORM_implicit_const ? reader.sleb128() : 0;
+            abbreviation.attributes.push_back({name, form, implicitConst});
+        }
+    }
+
+    const AbbreviationTable &result = *table;
+    abbreviationTables_.emplace(offset, std::move(table));
+    return result;
+}
+
+void DwarfReader::readUnit(DataReader &info, SymbolIndexBuilder &builder) {
+    Unit unit;
+    unit.offset = info.offset();
+
+    uint64_t length = info.u32();
+    if (length == 0xffffffff) {
+        unit.offsetSize = 8;
+        length = info.u64();
+    }
+    if (length > info.remaining()) {
+        throwBadFormat("compile unit extends past end of .debug_info");
+    }
+    unit.end = info.offset() + length;
+
+    unit.version = info.u16();
+    if (unit.version < 2 || unit.version > 5) {
+        info.seek(static_cast<size_t>(unit.end));
+        return;
+    }
+
+    uint64_t abbreviationOffset = 0;
+    if (unit.version >= 5) {
+        const uint8_t unitType = info.u8();
+        unit.addressSize = info.u8();
+        abbreviationOffset = info.unsignedOfSize(unit.offsetSize);
+        // Type units (and split units) carry no code ranges we can use.
+        if (unitType != 0x01 && unitType != 0x03 && unitType != 0x04) {
+            info.seek(static_cast<size_t>(unit.end));
+            return;
+        }
+        if (unitType == 0x04) {
+            info.skip(8); // dwo_id
+        }
+    } else {
+        abbreviationOffset = info.unsignedOfSize(unit.offsetSize);
+        unit.addressSize = info.u8();
+    }
+    unit.abbreviations = &abbreviations(abbreviationOffset);
+
+    DataReader reader(info.data(), static_cast<size_t>(unit.end));
+    reader.seek(info.offset());
+    info.seek(static_cast<size_t>(unit.end));
+
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    std::vector<std::pair<uint16_t, FormValue>> unitAttributes;
+    // Enclosing DIEs with children that start an inline scope, as (depth,
+    // inline site); subprograms reset the chain.
+    std::vector<std::pair<int, uint32_t>> scopes;
+    bool isUnitDie = true;
+    int depth = 0;
+
+    while (!reader.atEnd()) {
+        const uint64_t dieOffset = reader.offset();
+        const uint64_t code = reader.uleb128();
+        if (code == 0) {
+            if (--depth <= 0) {
+                break;
+            }
+            continue;
+        }
+        if (code >= unit.abbreviations->size() || (*unit.abbreviations)[code].tag == 0) {
+            throwBadFormat("unknown abbreviation code");
+        }
+
+        const Abbreviation &abbreviation = (*unit.abbreviations)[code];
+        const int dieDepth = depth;
+        if (abbreviation.hasChildren) {
+            ++depth;
+        }
+
+        if (isUnitDie) {
+            isUnitDie = false;
+            const bool isUnit = abbreviation.tag == DW_TAG_compile_unit ||
+                                abbreviation.tag == DW_TAG_partial_unit ||
+                                abbreviation.tag == DW_TAG_skeleton_unit;
+            for (const auto &spec : abbreviation.attributes) {
+                unitAttributes.emplace_back(spec.name, readForm(reader, spec.form, spec.implicitConst, unit));
+            }
+            if (!isUnit) {
+                continue;
+            }
+
+            // The base offsets have to be known before any indexed form on
+            // the unit DIE itself can be resolved.
+            FormValue lowPc;
+            FormValue highPc;
+            FormValue rangesValue;
+            const FormValue *stmtList = nullptr;
+            for (const auto &attribute : unitAttributes) {
+                switch (attribute.first) {
+                case DW_AT_str_offsets_base: unit.strOffsetsBase = attribute.second.value; break;
+                case DW_AT_addr_base: unit.addrBase = attribute.second.value; break;
+                case DW_AT_rnglists_base: unit.rnglistsBase = attribute.second.value; break;
+                case DW_AT_low_pc: lowPc = attribute.second; break;
+                case DW_AT_high_pc: highPc = attribute.second; break;
+                case DW_AT_ranges: rangesValue = attribute.second; break;
+                case DW_AT_stmt_list: stmtList = &attribute.second; break;
+                default: break;
+                }
+            }
+            for (const auto &attribute : unitAttributes) {
+                if (attribute.first == DW_AT_comp_dir) {
+                    unit.compDir = stringValue(attribute.second, unit);
+                }
+            }
+            if (lowPc.form != 0) {
+                unit.baseAddress = addressValue(lowPc, unit);
+            }
+            const LineTable *lineTable = stmtList != nullptr ? readLineProgram(stmtList->value, unit, builder) : nullptr;
+            if (lineTable == nullptr) {
+                continue;
+            }
+            unit.files = &lineTable->files;
+            if (lineTable->lazyUnit == UINT32_MAX) {
+                continue;
+            }
+
+            // The deferred line program covers the unit's code ranges. Units
+            // that record none anywhere are decoded now instead.
+            ranges.clear();
+            codeRanges(lowPc, highPc, rangesValue, unit, ranges);
+            if (ranges.empty()) {
+                if (const auto *known = addressRanges(unit.offset)) {
+                    ranges = *known;
+                }
+            }
+            if (ranges.empty()) {
+                lazyLines_->addDecodedRanges(lineTable->lazyUnit);
+            }
+            for (const auto &range : ranges) {
+                if (range.first != 0 || unit.baseAddress == 0) {
+                    lazyLines_->addRange(range.first, range.second, lineTable->lazyUnit);
+                }
+            }
+            continue;
+        }
+
+        while (!scopes.empty() && scopes.back().first >= dieDepth) {
+            scopes.pop_back();
+        }
+
+        if (abbreviation.tag == DW_TAG_inlined_subroutine) {
+            const uint32_t parent = scopes.empty() ? kNoInlineSite : scopes.back().second;
+            const uint32_t site = readInlinedSubroutine(reader, abbreviation, unit, parent, builder);
+            if (abbreviation.hasChildren) {
+                // Calls nested in one without code attach to its parent.
+                scopes.emplace_back(dieDepth, site != kNoInlineSite ? site : parent);
+            }
+            continue;
+        }
+
+        if (abbreviation.tag != DW_TAG_subprogram) {
+            for (const auto &spec : abbreviation.attributes) {
+                readForm(reader, spec.form, spec.implicitConst, unit);
+            }
+            continue;
+        }
+
+        Subprogram subprogram;
+        FormValue lowPc;
+        FormValue highPc;
+        FormValue rangesValue;
+        for (const auto &spec : abbreviation.attributes) {
+            FormValue value = readForm(reader, spec.form, spec.implicitConst, unit);
+            switch (spec.name) {
+            case DW_AT_name: subprogram.name = stringValue(value, unit); break;
+            case DW_AT_linkage_name:
+            case DW_AT_MIPS_linkage_name: subprogram.linkageName = stringValue(value, unit); break;
+            case DW_AT_specification:
+            case DW_AT_abstract_origin: subprogram.reference = referenceValue(value, unit); break;
+            case DW_AT_low_pc: lowPc = value; break;
+            case DW_AT_high_pc: highPc = value; break;
+            case DW_AT_ranges: rangesValue = value; break;
+            default: break;
+            }
+        }
+        subprograms_.emplace(dieOffset, subprogram);
+        if (abbreviation.hasChildren) {
+            scopes.emplace_back(dieDepth, kNoInlineSite);
+        }
+
+        ranges.clear();
+        codeRanges(lowPc, highPc, rangesValue, unit, ranges);
+        for (const auto &range : ranges) {
+            pending_.push_back({range.first, range.second, dieOffset});
+        }
+    }
+}
+
+void DwarfReader::codeRanges(const FormValue &lowPc, const FormValue &highPc, const FormValue &ranges,
+                             const Unit &unit, std::vector<std::pair<uint64_t, uint64_t>> &result) const {
+    if (lowPc.form != 0 && highPc.form != 0) {
+        const uint64_t start = addressValue(lowPc, unit);
+        const bool isOffset = highPc.form != DW_FORM_addr && !isAddressIndexForm(highPc.form);
+        const uint64_t end = isOffset ? start + highPc.value : addressValue(highPc, unit);
+        result.emplace_back(start, end);
+    } else if (ranges.form != 0) {
+        readRanges(ranges, unit, result);
+    }
+}
+
+uint32_t DwarfReader::readInlinedSubroutine(DataReader &reader, const Abbreviation &abbreviation, const Unit &unit,
+                                            uint32_t parent, SymbolIndexBuilder &builder) {
+    FormValue lowPc;
+    FormValue highPc;
+    FormValue rangesValue;
+    uint64_t origin = 0;
+    uint64_t callFile = 0;
+    uint64_t callLine = 0;
+    for (const auto &spec : abbreviation.attributes) {
+        FormValue value = readForm(reader, spec.form, spec.implicitConst, unit);
+        switch (spec.name) {
+        case DW_AT_abstract_origin: origin = referenceValue(value, unit); break;
+        case DW_AT_low_pc: lowPc = value; break;
+        case DW_AT_high_pc: highPc = value; break;
+        case DW_AT_ranges: rangesValue = value; break;
+        case DW_AT_call_file: callFile = value.value; break;
+        case DW_AT_call_line: callLine = value.value; break;
+        default: break;
+        }
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    codeRanges(lowPc, highPc, rangesValue, unit, ranges);
+    if (origin == 0 || ranges.empty()) {
+        return kNoInlineSite;
+    }
+
+    // File number 0 means "unknown" before DWARF 5.
+    uint32_t file = kUnknownFile;
+    uint32_t line = 0;
+    if (unit.files != nullptr && callFile < unit.files->size() && (callFile != 0 || unit.version >= 5)) {
+        file = (*unit.files)[static_cast<size_t>(callFile)];
+        line = static_cast<uint32_t>(callLine);
+    }
+
+    const uint32_t site = builder.addInlineSite(file, line, parent);
+    pendingSites_.push_back({site, origin});
+    for (const auto &range : ranges) {
+        // Like line sequences, code removed by the linker starts at address 0.
+        if (range.first != 0 || unit.baseAddress == 0) {
+            builder.addInlineRange(range.first, range.second, site);
+        }
+    }
+    return site;
+}
+
+DwarfReader::FormValue DwarfReader::readForm(DataReader &reader, uint16_t form, int64_t implicitConst,
+                                             const Unit &unit) {
+    FormValue value;
+    value.form = form;
+    switch (form) {
+    case DW_FORM_addr: value.value = reader.unsignedOfSize(unit.addressSize); break;
+    case DW_FORM_block2: reader.skip(reader.u16()); break;
+    case DW_FORM_block4: reader.skip(reader.u32()); break;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:
+    case DW_FORM_strx2:
+    case DW_FORM_addrx2: value.value = reader.u16(); break;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:
+    case DW_FORM_ref_sup4:
+    case DW_FORM_strx4:
+    case DW_FORM_addrx4: value.value = reader.u32(); break;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:
+    case DW_FORM_ref_sup8: value.value = reader.u64(); break;
+    case DW_FORM_data16: reader.skip(16); break;
+    case DW_FORM_string: value.string = reader.cstring(); break;
+    case DW_FORM_block:
+    case DW_FORM_exprloc: reader.skip(static_cast<size_t>(reader.uleb128())); break;
+    case DW_FORM_block1: reader.skip(reader.u8()); break;
+    case DW_FORM_data1:
+    case DW_FORM_ref1:
+    case DW_FORM_flag:
+    case DW_FORM_strx1:
+    case DW_FORM_addrx1: value.value = reader.u8(); break;
+    case DW_FORM_strx3:
+    case DW_FORM_addrx3: value.value = reader.unsignedOfSize(3); break;
+    case DW_FORM_sdata: value.value = static_cast<uint64_t>(reader.sleb128()); break;
+    case DW_FORM_udata:
+    case DW_FORM_ref_udata:
+    case DW_FORM_strx:
+    case DW_FORM_addrx:
+    case DW_FORM_loclistx:
+    case DW_FORM_rnglistx:
+    case DW_FORM_GNU_addr_index:
+    case DW_FORM_GNU_str_index: value.value = reader.uleb128(); break;
+    case DW_FORM_ref_addr:
+        value.value = reader.unsignedOfSize(unit.version <= 2 ? unit.addressSize : unit.offsetSize);
+        break;
+    case DW_FORM_strp:
+    case DW_FORM_line_strp:
+    case DW_FORM_sec_offset:
+    case DW_FORM_strp_sup:
+    case DW_FORM_GNU_ref_alt:
+    case DW_FORM_GNU_strp_alt: value.value = reader.unsignedOfSize(unit.offsetSize); break;
+    case DW_FORM_flag_present: value.value = 1; break;
+    case DW_FORM_implicit_const: value.value = static_cast<uint64_t>(implicitConst); break;
+    case DW_FORM_indirect: {
+        const auto actual = static_cast<uint16_t>(reader.uleb128());
+        return readForm(reader, actual, 0, unit);
+    }
+    default: throwBadFormat("unsupported DWARF form");
+    }
+    return value;
+}
+
+std::string_view DwarfReader::stringValue(const FormValue &value, const Unit &unit) const {
+    switch (value.form) {
+    case DW_FORM_string: return value.string;
+    case DW_FORM_strp: return str_.cstringAt(value.value);
+    case DW_FORM_line_strp: return lineStr_.cstringAt(value.value);
+    default: break;
+    }
+    if (isStringIndexForm(value.form)) {
+        const uint64_t offset = peekUnsigned(strOffsets_, unit.strOffsetsBase + value.value * unit.offsetSize,
+                                             unit.offsetSize);
+        return str_.cstringAt(offset);
+    }
+    return {};
+}
+
+uint64_t DwarfReader::addressValue(const FormValue &value, const Unit &unit) const {
+    if (isAddressIndexForm(value.form)) {
+        return peekUnsigned(addr_, unit.addrBase + value.value * unit.addressSize, unit.addressSize);
+    }
+    return value.value;
+}
+
+uint64_t DwarfReader::referenceValue(const FormValue &value, const Unit &unit) const {
+    switch (value.form) {
+    case DW_FORM_ref1:
+    case DW_FORM_ref2:
+    case DW_FORM_ref4:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_udata: return unit.offset + value.value;
+    case DW_FORM_ref_addr: return value.value;
+    default: return 0;
+    }
+}
+
+void DwarfReader::readRanges(const FormValue &value, const Unit &unit,
+                             std::vector<std::pair<uint64_t, uint64_t>> &ranges) const {
+    uint64_t base = unit.baseAddress;
+
+    if (unit.version < 5) {
+        DataReader reader = ranges_;
+        reader.seek(static_cast<size_t>(value.value));
+        const uint64_t selector = unit.addressSize == 4 ? UINT32_MAX : UINT64_MAX;
+        while (true) {
+            const uint64_t start = reader.unsignedOfSize(unit.addressSize);
+            const uint64_t end = reader.unsignedOfSize(unit.addressSize);
+            if (start == 0 && end == 0) {
+                return;
+            }
+            if (start == selector) {
+                base = end;
+            } else {
+                ranges.emplace_back(base + start, base + end);
+            }
+        }
+    }
+
+    uint64_t offset = value.value;
+    if (value.form == DW_FORM_rnglistx) {
+        offset = unit.rnglistsBase +
+                 peekUnsigned(rnglists_, unit.rnglistsBase + value.value * unit.offsetSize, unit.offsetSize);
+    }
+
+    DataReader reader = rnglists_;
+    reader.seek(static_cast<size_t>(offset));
+    auto indexed = [&](uint64_t index) {
+        return peekUnsigned(addr_, unit.addrBase + index * unit.addressSize, unit.addressSize);
+    };
+    while (true) {
+        const uint8_t kind = reader.u8();
+        switch (kind) {
+        case DW_RLE_end_of_list: return;
+        case DW_RLE_base_addressx: base = indexed(reader.uleb128()); break;
+        case DW_RLE_startx_endx: {
+            const uint64_t start = indexed(reader.uleb128());
+            ranges.emplace_back(start, indexed(reader.uleb128()));
+            break;
+        }
+        case DW_RLE_startx_length: {
+            const uint64_t start = indexed(reader.uleb128());
+            ranges.emplace_back(start, start + reader.uleb128());
+            break;
+        }
+        case DW_RLE_offset_pair: {
+            const uint64_t start = reader.uleb128();
+            ranges.emplace_back(base + start, base + reader.uleb128());
+            break;
+        }
+        case DW_RLE_base_address: base = reader.unsignedOfSize(unit.addressSize); break;
+        case DW_RLE_start_end: {
+            const uint64_t start = reader.unsignedOfSize(unit.addressSize);
+            ranges.emplace_back(start, reader.unsignedOfSize(unit.addressSize));
+            break;
+        }
+        case DW_RLE_start_length: {
+            const uint64_t start = reader.unsignedOfSize(unit.addressSize);
+            ranges.emplace_back(start, start + reader.uleb128());
+            break;
+        }
+        default: throwBadFormat("unknown range list entry");
+        }
+    }
+}
+
+std::string_view DwarfReader::functionName(uint64_t die) const {
+    // Out-of-line copies and definitions of class members carry their names
+    // on the declaration they point at; follow a bounded chain of references.
+    std::string_view name;
+    for (int hop = 0; hop < 8 && die != 0; ++hop) {
+        auto found = subprograms_.find(die);
+        if (found == subprograms_.end()) {
+            break;
+        }
+        if (!found->second.linkageName.empty()) {
+            return found->second.linkageName;
+        }
+        if (name.empty()) {
+            name = found->second.name;
+        }
+        die = found->second.reference;
+    }
+    return name;
+}
+
+const std::vector<std::pair<uint64_t, uint64_t>> *DwarfReader::addressRanges(uint64_t unitOffset) {
+    if (!hasReadAddressRanges_) {
+        hasReadAddressRanges_ = true;
+        DataReader reader = aranges_;
+        while (!reader.atEnd()) {
+            const size_t setStart = reader.offset();
+            uint8_t offsetSize = 4;
+            uint64_t length = reader.u32();
+            if (length == 0xffffffff) {
+                offsetSize = 8;
+                length = reader.u64();
+            }
+            if (length > reader.remaining()) {
+                throwBadFormat("address range set extends past end of .debug_aranges");
+            }
+            const size_t setEnd = reader.offset() + static_cast<size_t>(length);
+
+            const uint16_t version = reader.u16();
+            const uint64_t offset = reader.unsignedOfSize(offsetSize);
+            const uint8_t addressSize = reader.u8();
+            const uint8_t segmentSize = reader.u8();
+            if (version == 2 && segmentSize == 0 && (addressSize == 4 || addressSize == 8)) {
+                // Tuples are aligned to their own size from the start of the set.
+                const size_t tupleSize = 2 * addressSize;
+                reader.seek(setStart + (reader.offset() - setStart + tupleSize - 1) / tupleSize * tupleSize);
+                auto &ranges = addressRanges_[offset];
+                while (reader.offset() + tupleSize <= setEnd) {
+                    const uint64_t start = reader.unsignedOfSize(addressSize);
+                    const uint64_t size = reader.unsignedOfSize(addressSize);
+                    if (start == 0 && size == 0) {
+                        break;
+                    }
+                    ranges.emplace_back(start, start + size);
+                }
+            }
+            reader.seek(setEnd);
+        }
+    }
+
+    auto found = addressRanges_.find(unitOffset);
+    return found != addressRanges_.end() ? &found->second : nullptr;
+}
+
+const DwarfReader::LineTable *DwarfReader::readLineProgram(uint64_t offset, const Unit &unit,
+                                                            SymbolIndexBuilder &builder) {
+    if (line_.size() == 0) {
+        return nullptr;
+    }
+    // Units sharing a line program only read it once.
+    auto inserted = lineTables_.try_emplace(offset);
+    LineTable &table = inserted.first->second;
+    if (!inserted.second) {
+        return &table;
+    }
+
+    LineProgram program;
+    std::vector<uint32_t> &files = program.files;
+
+    DataReader reader = line_;
+    reader.seek(static_cast<size_t>(offset));
+
+    uint8_t offsetSize = 4;
+    uint64_t length = reader.u32();
+    if (length == 0xffffffff) {
+        offsetSize = 8;
+        length = reader.u64();
+    }
+    if (length > reader.remaining()) {
+        throwBadFormat("line program extends past end of .debug_line");
+    }
+    const size_t programEnd = reader.offset() + static_cast<size_t>(length);
+
+    const uint16_t version = reader.u16();
+    if (version < 2 || version > 5) {
+        return &table;
+    }
+    uint8_t addressSize = unit.addressSize;
+    if (version >= 5) {
+        addressSize = reader.u8();
+        reader.skip(1); // segment_selector_size
+    }
+    const uint64_t headerLength = reader.unsignedOfSize(offsetSize);
+    const size_t programStart = reader.offset() + static_cast<size_t>(headerLength);
+
+    program.minimumInstructionLength = reader.u8();
+    if (version >= 4) {
+        reader.skip(1); // maximum_operations_per_instruction
+    }
+    reader.skip(1); // default_is_stmt
+    program.lineBase = static_cast<int8_t>(reader.u8());
+    program.lineRange = reader.u8();
+    program.opcodeBase = reader.u8();
+    if (program.lineRange == 0) {
+        throwBadFormat("line program has zero line_range");
+    }
+    program.standardOpcodeLengths.resize(program.opcodeBase > 0 ? program.opcodeBase - 1 : 0);
+    for (auto &length : program.standardOpcodeLengths) {
+        length = reader.u8();
+    }
+
+    std::vector<std::string_view> directories;
+    if (version < 5) {
+        directories.push_back(unit.compDir);
+        while (true) {
+            std::string_view directory = reader.cstring();
+            if (directory.empty()) {
+                break;
+            }
+            directories.push_back(directory);
+        }
+        files.push_back(kUnknownFile); // file numbers are 1-based before DWARF 5
+        while (true) {
+            std::string_view name = reader.cstring();
+            if (name.empty()) {
+                break;
+            }
+            const uint64_t directory = reader.uleb128();
+            reader.uleb128(); // modification time
+            reader.uleb128(); // length
+            files.push_back(builder.file(directory < directories.size() ? directories[directory] : std::string_view(),
+                                         name));
+        }
+    } else {
+        Unit lineUnit = unit;
+        lineUnit.offsetSize = offsetSize;
+        lineUnit.addressSize = addressSize;
+
+        auto readEntries = [&](auto &&consume) {
+            const uint8_t formatCount = reader.u8();
+            std::vector<std::pair<uint64_t, uint16_t>> format(formatCount);
+            for (auto &entry : format) {
+                entry.first = reader.uleb128();
+                entry.second = static_cast<uint16_t>(reader.uleb128());
+            }
+            const uint64_t count = reader.uleb128();
+            for (uint64_t index = 0; index < count; ++index) {
+                std::string_view path;
+                uint64_t directory = 0;
+                for (const auto &entry : format) {
+                    FormValue value = readForm(reader, entry.second, 0, lineUnit);
+                    if (entry.first == DW_LNCT_path) {
+                        path = stringValue(value, lineUnit);
+                    } else if (entry.first == DW_LNCT_directory_index) {
+                        directory = value.value;
+                    }
+                }
+                consume(path, directory);
+            }
+        };
+        readEntries([&](std::string_view path, uint64_t) { directories.push_back(path); });
+        readEntries([&](std::string_view path, uint64_t directory) {
+            files.push_back(builder.file(directory < directories.size() ? directories[directory] : std::string_view(),
+                                         path));
+        });
+    }
+
+    if (programStart > programEnd) {
+        throwBadFormat("line program header extends past its end");
+    }
+    program.start = programStart;
+    program.end = programEnd;
+    program.keepsZeroAddresses = unit.baseAddress == 0;
+    table.files = files;
+
+    if (lazyLines_ != nullptr) {
+        table.lazyUnit = lazyLines_->addUnit(
+            [section = line_, program = std::move(program)](std::vector<std::vector<LineRow>> &sequences) {
+                runLineProgram(section, program, sequences);
+            });
+        return &table;
+    }
+
+    std::vector<std::vector<LineRow>> sequences;
+    runLineProgram(line_, program, sequences);
+    for (auto &sequence : sequences) {
+        builder.addLineSequence(std::move(sequence));
+    }
+    return &table;
+}
+
+void DwarfReader::runLineProgram(const DataReader &section, const LineProgram &header,
+                                 std::vector<std::vector<LineRow>> &sequences) {
+    DataReader program(section.data(), header.end);
+    program.seek(header.start);
+
+    const std::vector<uint32_t> &files = header.files;
+    const uint8_t minimumInstructionLength = header.minimumInstructionLength;
+    const int8_t lineBase = header.lineBase;
+    const uint8_t lineRange = header.lineRange;
+    const uint8_t opcodeBase = header.opcodeBase;
+
+    std::vector<LineRow> rows;
+    uint64_t address = 0;
+    uint64_t file = 1;
+    int64_t line = 1;
+    auto emit = [&](uint32_t rowLine) {
+        const uint32_t fileId = file < files.size() ? files[file] : kUnknownFile;
+        rows.push_back({address, fileId, rowLine});
+    };
+    auto reset = [&]() {
+        address = 0;
+        file = 1;
+        line = 1;
+    };
+
+    while (!program.atEnd()) {
+        const uint8_t opcode = program.u8();
+        if (opcode >= opcodeBase) {
+            const uint8_t adjusted = opcode - opcodeBase;
+            address += static_cast<uint64_t>(adjusted / lineRange) * minimumInstructionLength;
+            line += lineBase + adjusted % lineRange;
+            emit(static_cast<uint32_t>(line));
+            continue;
+        }
+
+        switch (opcode) {
+        case 0: {
+            const uint64_t length = program.uleb128();
+            if (length == 0) {
+                break;
+            }
+            const size_t next = program.offset() + static_cast<size_t>(length);
+            const uint8_t extended = program.u8();
+            if (extended == DW_LNE_end_sequence) {
+                emit(0);
+                // Sequences of code removed by the linker start at address 0.
+                if (rows.front().address != 0 || header.keepsZeroAddresses) {
+                    sequences.push_back(std::move(rows));
+                }
+                rows = {};
+                reset();
+            } else if (extended == DW_LNE_set_address) {
+                address = program.unsignedOfSize(static_cast<size_t>(length - 1));
+            }
+            program.seek(next);
+            break;
+        }
+        case DW_LNS_copy: emit(static_cast<uint32_t>(line)); break;
+        case DW_LNS_advance_pc: address += program.uleb128() * minimumInstructionLength; break;
+        case DW_LNS_advance_line: line += program.sleb128(); break;
+        case DW_LNS_set_file: file = program.uleb128(); break;
+        case DW_LNS_const_add_pc:
+            address += static_cast<uint64_t>((255 - opcodeBase) / lineRange) * minimumInstructionLength;
+            break;
+        case DW_LNS_fixed_advance_pc: address += program.u16(); break;
+        default:
+            for (uint8_t argument = 0; argument < header.standardOpcodeLengths[opcode - 1]; ++argument) {
+                program.uleb128();
+            }
+            break;
+        }
+    }
+}
+
+} // namespace symbolicator
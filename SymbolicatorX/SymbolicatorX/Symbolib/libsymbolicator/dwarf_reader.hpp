@@ -0,0 +1,152 @@
+//
+//  dwarf_reader.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_DWARF_READER_HPP
+#define SYMBOLICATOR_DWARF_READER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "data_reader.hpp"
+#include "macho_file.hpp"
+#include "symbol_index.hpp"
+
+namespace symbolicator {
+
+/// Reads DWARF 2-5 debug information from the __DWARF segment of a Mach-O
+/// slice: subprogram and inlined subroutine address ranges from
+/// .debug_info and the line programs from .debug_line.
+class DwarfReader {
+public:
+    /// With `lazyLines`, line programs are not run by `read`: each becomes a
+    /// unit of `lazyLines`, covering the code ranges of its compilation unit
+    /// as given by the unit DIE or .debug_aranges. The table must not outlive
+    /// the sections of `file`.
+    explicit DwarfReader(const MachOFile &file, LazyLineTable *lazyLines = nullptr);
+
+    /// Feeds every function range, inlined call and line sequence to `builder`.
+    void read(SymbolIndexBuilder &builder);
+
+private:
+    struct AttributeSpec {
+        uint16_t name;
+        uint16_t form;
+        int64_t implicitConst;
+    };
+
+    struct Abbreviation {
+        uint16_t tag = 0;
+        bool hasChildren = false;
+        std::vector<AttributeSpec> attributes;
+    };
+
+    using AbbreviationTable = std::vector<Abbreviation>;
+
+    struct Unit {
+        uint64_t offset = 0;
+        uint64_t end = 0;
+        uint16_t version = 0;
+        uint8_t offsetSize = 4;
+        uint8_t addressSize = 8;
+        const AbbreviationTable *abbreviations = nullptr;
+        uint64_t baseAddress = 0;
+        uint64_t strOffsetsBase = 8;
+        uint64_t addrBase = 8;
+        uint64_t rnglistsBase = 12;
+        std::string_view compDir;
+        const std::vector<uint32_t> *files = nullptr; ///< File ids by line table file number.
+    };
+
+    /// Header of a line program: everything needed to run its opcodes.
+    struct LineProgram {
+        size_t start = 0; ///< First opcode, as an offset into .debug_line.
+        size_t end = 0;
+        uint8_t minimumInstructionLength = 1;
+        int8_t lineBase = 0;
+        uint8_t lineRange = 1;
+        uint8_t opcodeBase = 1;
+        bool keepsZeroAddresses = false; ///< Whether sequences at address 0 are live code.
+        std::vector<uint8_t> standardOpcodeLengths;
+        std::vector<uint32_t> files; ///< File ids by line table file number.
+    };
+
+    /// A line program read for some unit, possibly shared with others.
+    struct LineTable {
+        std::vector<uint32_t> files;
+        uint32_t lazyUnit = UINT32_MAX; ///< Its unit of `lazyLines_`, if any.
+    };
+
+    struct FormValue {
+        uint16_t form = 0;
+        uint64_t value = 0;
+        std::string_view string;
+    };
+
+    struct Subprogram {
+        std::string_view name;
+        std::string_view linkageName;
+        uint64_t reference = 0;
+    };
+
+    struct PendingFunction {
+        uint64_t start;
+        uint64_t end;
+        uint64_t die;
+    };
+
+    struct PendingInlineSite {
+        uint32_t site;
+        uint64_t origin;
+    };
+
+    const AbbreviationTable &abbreviations(uint64_t offset);
+    void readUnit(DataReader &info, SymbolIndexBuilder &builder);
+    FormValue readForm(DataReader &reader, uint16_t form, int64_t implicitConst, const Unit &unit);
+    std::string_view stringValue(const FormValue &value, const Unit &unit) const;
+    uint64_t addressValue(const FormValue &value, const Unit &unit) const;
+    uint64_t referenceValue(const FormValue &value, const Unit &unit) const;
+    void readRanges(const FormValue &value, const Unit &unit,
+                    std::vector<std::pair<uint64_t, uint64_t>> &ranges) const;
+    std::string_view functionName(uint64_t die) const;
+    void codeRanges(const FormValue &lowPc, const FormValue &highPc, const FormValue &ranges, const Unit &unit,
+                    std::vector<std::pair<uint64_t, uint64_t>> &result) const;
+    uint32_t readInlinedSubroutine(DataReader &reader, const Abbreviation &abbreviation, const Unit &unit,
+                                   uint32_t parent, SymbolIndexBuilder &builder);
+    const LineTable *readLineProgram(uint64_t offset, const Unit &unit, SymbolIndexBuilder &builder);
+    static void runLineProgram(const DataReader &section, const LineProgram &program,
+                               std::vector<std::vector<LineRow>> &sequences);
+    const std::vector<std::pair<uint64_t, uint64_t>> *addressRanges(uint64_t unitOffset);
+
+    DataReader info_;
+    DataReader abbrev_;
+    DataReader str_;
+    DataReader line_;
+    DataReader lineStr_;
+    DataReader strOffsets_;
+    DataReader addr_;
+    DataReader ranges_;
+    DataReader rnglists_;
+    DataReader aranges_;
+    LazyLineTable *lazyLines_;
+
+    std::unordered_map<uint64_t, std::unique_ptr<AbbreviationTable>> abbreviationTables_;
+    std::unordered_map<uint64_t, Subprogram> subprograms_;
+    std::vector<PendingFunction> pending_;
+    std::vector<PendingInlineSite> pendingSites_;
+    std::unordered_map<uint64_t, LineTable> lineTables_; ///< Keyed by .debug_line offset.
+    /// .debug_aranges by .debug_info offset of the unit, read when first needed.
+    std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, uint64_t>>> addressRanges_;
+    bool hasReadAddressRanges_ = false;
+};
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,37 @@
+//
+//  error.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_ERROR_HPP
+#define SYMBOLICATOR_ERROR_HPP
+
+#include <stdexcept>
+#include <string>
+
+#include "symbolicator.h"
+
+namespace symbolicator {
+
+/// Internal failure carrying the C error code it is reported as across the C API.
+class Error : public std::runtime_error {
+public:
+    Error(symbolicator_error_t code, const std::string &message)
+        : std::runtime_error(message), code_(code) {}
+
+    symbolicator_error_t code() const { return code_; }
+
+private:
+    symbolicator_error_t code_;
+};
+
+[[noreturn]] inline void throwBadFormat(const std::string &message) {
+    throw Error(SYMBOLICATOR_E_BAD_FORMAT, message);
+}
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,284 @@
+//
+//  frame_cache.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "frame_cache.hpp"
+
+#include <cstring>
+#include <mutex>
+
+#include "data_reader.hpp"
+#include "error.hpp"
+#include "mapped_file.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+constexpr char kFrameCacheMagic[8] = {'S', 'X', 'F', 'R', 'A', 'M', 'E', 'S'};
+constexpr uint32_t kFrameCacheVersion = 2;
+
+/// Flags of a stored key.
+constexpr uint8_t kExpandsInlines = 1;
+
+/// Flags of a stored lookup.
+constexpr uint8_t kHasFunction = 1;
+constexpr uint8_t kHasFile = 2;
+
+template <typename T>
+void put(std::string &out, T value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void putLookup(std::string &out, const SymbolLookup &lookup) {
+    put<uint64_t>(out, lookup.functionStart);
+    put<uint32_t>(out, lookup.line);
+    put<uint8_t>(out, (lookup.function != nullptr ? kHasFunction : 0) | (lookup.file != nullptr ? kHasFile : 0));
+    // Names go out NUL-terminated, so reading them back can point into the
+    // mapped file until they are interned.
+    if (lookup.function != nullptr) {
+        out.append(lookup.function).push_back('\0');
+    }
+    if (lookup.file != nullptr) {
+        out.append(lookup.file).push_back('\0');
+    }
+}
+
+SymbolLookup getLookup(DataReader &reader) {
+    SymbolLookup lookup;
+    lookup.functionStart = reader.u64();
+    lookup.line = reader.u32();
+    const uint8_t flags = reader.u8();
+    if (flags & kHasFunction) {
+        lookup.function = reader.cstring().data();
+    }
+    if (flags & kHasFile) {
+        lookup.file = reader.cstring().data();
+    }
+    return lookup;
+}
+
+/// Approximate heap footprint of a cached frame, hash node included.
+uint64_t frameBytes(const CachedFrame &frame) {
+    return sizeof(std::pair<const FrameKey, CachedFrame>) + 2 * sizeof(void *) +
+           frame.inlined.capacity() * sizeof(SymbolLookup);
+}
+
+} // namespace
+
+size_t FrameCache::KeyHash::operator()(const FrameKey &key) const {
+    uint64_t low;
+    uint64_t high;
+    std::memcpy(&low, key.uuid.data(), sizeof(low));
+    std::memcpy(&high, key.uuid.data() + sizeof(low), sizeof(high));
+    uint64_t hash = low ^ (high * 0x9e3779b97f4a7c15ull) ^ (static_cast<uint64_t>(key.cpuType) << 32 | key.cpuSubtype);
+    hash ^= (key.offset * 2 + (key.expandsInlines ? 1 : 0)) * 0xc2b2ae3d27d4eb4full;
+    hash ^= hash >> 29;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 32;
+    return static_cast<size_t>(hash);
+}
+
+FrameCache::FrameCache(std::string file, uint64_t maxBytes)
+    : file_(std::move(file)), shardBytes_(maxBytes / shards_.size()) {
+    load();
+}
+
+FrameCache::Shard &FrameCache::shardFor(const FrameKey &key) {
+    // The top bits, since the maps themselves bucket by the low ones.
+    return shards_[(static_cast<uint64_t>(KeyHash()(key)) >> 60) % shards_.size()];
+}
+
+const char *FrameCache::intern(Shard &shard, const char *name) {
+    if (name == nullptr) {
+        return nullptr;
+    }
+    auto found = shard.names.find(name);
+    if (found != shard.names.end()) {
+        return found->data();
+    }
+    const std::string &copy = shard.strings.emplace_back(name);
+    shard.names.insert(copy);
+    shard.nameBytes += sizeof(std::string) + copy.size() + 1 + 2 * sizeof(void *);
+    return copy.c_str();
+}
+
+SymbolLookup FrameCache::interned(Shard &shard, const SymbolLookup &lookup) {
+    SymbolLookup copy = lookup;
+    copy.function = intern(shard, lookup.function);
+    copy.file = intern(shard, lookup.file);
+    return copy;
+}
+
+void FrameCache::store(Shard &shard, const FrameKey &key, CachedFrame frame) {
+    auto older = shard.older.find(key);
+    if (older != shard.older.end()) {
+        shard.olderBytes -= frameBytes(older->second);
+        shard.older.erase(older);
+    }
+    auto recent = shard.recent.find(key);
+    if (recent != shard.recent.end()) {
+        shard.recentBytes -= frameBytes(recent->second);
+        shard.recent.erase(recent);
+    }
+
+    const uint64_t bytes = frameBytes(frame);
+    if (!shard.recent.empty() && shard.recentBytes + bytes > shardBytes_ / 2) {
+        shard.older = std::move(shard.recent);
+        shard.olderBytes = shard.recentBytes;
+        shard.recent.clear();
+        shard.recentBytes = 0;
+    }
+    shard.recent.emplace(key, std::move(frame));
+    shard.recentBytes += bytes;
+}
+
+bool FrameCache::find(const FrameKey &key, CachedFrame &frame) {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    Shard &shard = shardFor(key);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.recent.find(key);
+        if (found != shard.recent.end()) {
+            frame = found->second;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (shard.older.count(key) == 0) {
+            return false;
+        }
+    }
+
+    // Found in the older generation: moved back into the recent one, unless
+    // another thread got there first.
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto found = shard.recent.find(key);
+    if (found == shard.recent.end()) {
+        auto older = shard.older.find(key);
+        if (older == shard.older.end()) {
+            return false;
+        }
+        CachedFrame promoted = std::move(older->second);
+        store(shard, key, std::move(promoted));
+        found = shard.recent.find(key);
+    }
+    frame = found->second;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameCache::insert(const FrameKey &key, const SymbolLookup &lookup, const std::vector<SymbolLookup> &inlined) {
+    Shard &shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    CachedFrame frame;
+    frame.lookup = interned(shard, lookup);
+    frame.inlined.reserve(inlined.size());
+    for (const auto &call : inlined) {
+        frame.inlined.push_back(interned(shard, call));
+    }
+    store(shard, key, std::move(frame));
+}
+
+FrameCache::Stats FrameCache::stats() const {
+    Stats stats;
+    stats.lookups = lookups_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    for (const auto &shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        stats.frames += shard.recent.size() + shard.older.size();
+        stats.bytes += shard.recentBytes + shard.olderBytes + shard.nameBytes;
+    }
+    return stats;
+}
+
+void FrameCache::load() {
+    if (file_.empty()) {
+        return;
+    }
+
+    MappedFile mapping;
+    try {
+        mapping = MappedFile::open(file_);
+    } catch (const Error &) {
+        return;
+    }
+
+    // A damaged or outdated file is ignored and replaced by the next save.
+    // Frames read before the damage are kept: each stands on its own.
+    try {
+        DataReader reader(mapping.data(), mapping.size());
+        char magic[sizeof(kFrameCacheMagic)];
+        for (char &character : magic) {
+            character = static_cast<char>(reader.u8());
+        }
+        if (std::memcmp(magic, kFrameCacheMagic, sizeof(magic)) != 0 || reader.u32() != kFrameCacheVersion) {
+            return;
+        }
+
+        std::vector<SymbolLookup> inlined;
+        for (uint64_t count = reader.u64(); count > 0; --count) {
+            FrameKey key;
+            for (uint8_t &byte : key.uuid) {
+                byte = reader.u8();
+            }
+            key.cpuType = reader.u32();
+            key.cpuSubtype = reader.u32();
+            key.offset = reader.u64();
+            key.expandsInlines = (reader.u8() & kExpandsInlines) != 0;
+            const SymbolLookup lookup = getLookup(reader);
+            inlined.clear();
+            for (uint32_t calls = reader.u32(); calls > 0; --calls) {
+                inlined.push_back(getLookup(reader));
+            }
+            insert(key, lookup, inlined);
+        }
+    } catch (const Error &) {
+        return;
+    }
+}
+
+void FrameCache::save() const {
+    if (file_.empty()) {
+        return;
+    }
+
+    std::string out;
+    out.append(kFrameCacheMagic, sizeof(kFrameCacheMagic));
+    put<uint32_t>(out, kFrameCacheVersion);
+    const size_t countOffset = out.size();
+    put<uint64_t>(out, 0);
+    uint64_t count = 0;
+    for (const auto &shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const Generation *generation : {&shard.recent, &shard.older}) {
+            for (const auto &entry : *generation) {
+                const FrameKey &key = entry.first;
+                const CachedFrame &frame = entry.second;
+                out.append(reinterpret_cast<const char *>(key.uuid.data()), key.uuid.size());
+                put<uint32_t>(out, key.cpuType);
+                put<uint32_t>(out, key.cpuSubtype);
+                put<uint64_t>(out, key.offset);
+                put<uint8_t>(out, key.expandsInlines ? kExpandsInlines : 0);
+                putLookup(out, frame.lookup);
+                put<uint32_t>(out, static_cast<uint32_t>(frame.inlined.size()));
+                for (const auto &call : frame.inlined) {
+                    putLookup(out, call);
+                }
+                ++count;
+            }
+        }
+    }
+    std::memcpy(&out[countOffset], &count, sizeof(count));
+
+    const size_t slash = file_.find_last_of('/');
+    if (slash != std::string::npos && slash > 0) {
+        createDirectories(file_.substr(0, slash));
+    }
+    writeFileAtomically(file_, out);
+}
+
+} // namespace symbolicator
@@ -0,0 +1,133 @@
+//
+//  frame_cache.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_FRAME_CACHE_HPP
+#define SYMBOLICATOR_FRAME_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "image.hpp"
+
+namespace symbolicator {
+
+/// Identifies one frame across reports and runs: the image's build, the
+/// address as an offset from the image's __TEXT base, and whether inlined
+/// calls were expanded, which changes the line the frame itself reports
+/// (the call site in its function rather than the innermost location).
+struct FrameKey {
+    std::array<uint8_t, 16> uuid {};
+    uint32_t cpuType = 0;
+    uint32_t cpuSubtype = 0;
+    uint64_t offset = 0;
+    bool expandsInlines = false;
+
+    FrameKey() = default;
+    FrameKey(const Image &image, uint64_t fileAddress, bool expandsInlines)
+        : uuid(image.uuid()), cpuType(image.architecture().type), cpuSubtype(image.architecture().subtype),
+          offset(fileAddress - image.textAddress()), expandsInlines(expandsInlines) {}
+
+    bool operator==(const FrameKey &other) const {
+        return offset == other.offset && uuid == other.uuid && cpuType == other.cpuType &&
+               cpuSubtype == other.cpuSubtype && expandsInlines == other.expandsInlines;
+    }
+};
+
+/// A frame as resolved against its image's index. `functionStart` is kept
+/// as a file address, like the index returns it.
+struct CachedFrame {
+    SymbolLookup lookup;
+    std::vector<SymbolLookup> inlined; ///< Calls inlined at the address, innermost first.
+};
+
+/// Memo table from frames to what they resolve to, safe to share between
+/// threads and batches. Repeated batches over one build keep hitting the
+/// same frames (run loops, crash handlers, common framework calls); a hit
+/// skips the index search and, with inline expansion, the walk over the
+/// inline tree.
+///
+/// Frames are kept up to `maxBytes`. Each shard holds a recent and an older
+/// generation: once the recent one fills half the shard's share, the older
+/// one is dropped and the recent one takes its place, and a hit in the older
+/// generation moves the frame back. Function and file names are interned
+/// for the life of the cache, so pointers handed out stay valid after their
+/// frame is evicted; they grow with the distinct names seen, not with the
+/// frames.
+class FrameCache {
+public:
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        size_t frames = 0;
+        uint64_t bytes = 0; ///< Frames and interned names together.
+    };
+
+    /// Loads `file` when it holds a compatible cache. An empty `file` keeps
+    /// the cache in memory only.
+    FrameCache(std::string file, uint64_t maxBytes);
+
+    FrameCache(const FrameCache &) = delete;
+    FrameCache &operator=(const FrameCache &) = delete;
+
+    /// Copies the frame cached for `key` into `frame`.
+    bool find(const FrameKey &key, CachedFrame &frame);
+
+    /// Caches what `key` resolved to. Names are interned, so `lookup` and
+    /// `inlined` may point into an image that is freed afterwards.
+    void insert(const FrameKey &key, const SymbolLookup &lookup, const std::vector<SymbolLookup> &inlined);
+
+    Stats stats() const;
+
+    /// Writes the cached frames to the cache's file. Throws `Error`.
+    void save() const;
+
+    const std::string &file() const { return file_; }
+
+private:
+    struct KeyHash {
+        size_t operator()(const FrameKey &key) const;
+    };
+
+    using Generation = std::unordered_map<FrameKey, CachedFrame, KeyHash>;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        Generation recent;
+        Generation older;
+        uint64_t recentBytes = 0;
+        uint64_t olderBytes = 0;
+        std::unordered_set<std::string_view> names; ///< Views `strings`.
+        std::deque<std::string> strings;
+        uint64_t nameBytes = 0;
+    };
+
+    void load();
+    Shard &shardFor(const FrameKey &key);
+    const char *intern(Shard &shard, const char *name);
+    SymbolLookup interned(Shard &shard, const SymbolLookup &lookup);
+    void store(Shard &shard, const FrameKey &key, CachedFrame frame);
+
+    std::string file_;
+    uint64_t shardBytes_;
+    std::array<Shard, 16> shards_;
+    std::atomic<uint64_t> lookups_ {0};
+    std::atomic<uint64_t> hits_ {0};
+};
+
+} // namespace symbolicator
+
+#endif
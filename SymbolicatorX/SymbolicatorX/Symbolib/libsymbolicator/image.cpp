@@ -0,0 +1,65 @@
+//
+//  image.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "image.hpp"
+
+#include <cstring>
+#include <memory>
+
+#include "symbol_store.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+std::string imageName(const std::string &path) {
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+} // namespace
+
+Image Image::open(const std::string &path, const char *arch) {
+    MachOSlice store;
+    if (readSymbolStoreSlice(path, store)) {
+        return readSymbolStore(path, arch);
+    }
+
+    // The index keeps the mapping to decode line programs as lookups reach them.
+    auto file = std::make_shared<const MachOFile>(MachOFile::open(path, arch));
+    return Image(imageName(path), file->uuid(), file->architecture(), file->textAddress(),
+                 SymbolIndex::buildLazily(file));
+}
+
+Image Image::build(const std::string &path, const MachOFile &file) {
+    // The mapping is only needed while indexing; the index owns its strings.
+    return Image(imageName(path), file.uuid(), file.architecture(), file.textAddress(), SymbolIndex::build(file));
+}
+
+std::string Image::describe(const SymbolLookup &lookup, uint64_t loadAddress, uint64_t address,
+                            std::string_view addressText) const {
+    std::string result;
+    if (lookup.function == nullptr) {
+        result.append(addressText.data(), addressText.size());
+        result.append(" (in ").append(name_).append(")");
+        return result;
+    }
+
+    result.append(lookup.function).append(" (in ").append(name_).append(")");
+    if (lookup.file != nullptr && lookup.line > 0) {
+        const char *slash = std::strrchr(lookup.file, '/');
+        result.append(" (").append(slash != nullptr ? slash + 1 : lookup.file);
+        result.append(":").append(std::to_string(lookup.line)).append(")");
+    } else {
+        const uint64_t fileAddress = address - loadAddress + textAddress_;
+        result.append(" + ").append(std::to_string(fileAddress - lookup.functionStart));
+    }
+    return result;
+}
+
+} // namespace symbolicator
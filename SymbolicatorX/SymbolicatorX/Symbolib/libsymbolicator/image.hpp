@@ -0,0 +1,76 @@
+//
+//  image.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_IMAGE_HPP
+#define SYMBOLICATOR_IMAGE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "macho_file.hpp"
+#include "symbol_index.hpp"
+
+namespace symbolicator {
+
+/// A binary image ready for lookups: its symbol index plus the identity and
+/// __TEXT base needed to translate runtime addresses.
+class Image {
+public:
+    Image() = default;
+    Image(std::string name, const std::array<uint8_t, 16> &uuid, CpuArchitecture architecture,
+          uint64_t textAddress, SymbolIndex index)
+        : name_(std::move(name)), uuid_(uuid), architecture_(architecture), textAddress_(textAddress),
+          index_(std::move(index)) {}
+
+    /// Parses the slice of `path` matching `arch` and indexes it, deferring
+    /// each compilation unit's line table until a lookup lands in it (see
+    /// `SymbolIndex::buildLazily`). Throws `Error`.
+    static Image open(const std::string &path, const char *arch);
+
+    /// Indexes an already opened slice, line tables included, as needed to
+    /// write the index to an `IndexCache`. `path` only provides the image name.
+    static Image build(const std::string &path, const MachOFile &file);
+
+    /// File name of the binary, as atos prints it after "in".
+    const std::string &name() const { return name_; }
+    const std::array<uint8_t, 16> &uuid() const { return uuid_; }
+    const CpuArchitecture &architecture() const { return architecture_; }
+    uint64_t textAddress() const { return textAddress_; }
+    const SymbolIndex &index() const { return index_; }
+
+    /// Resolves a runtime address of an image loaded at `loadAddress`.
+    SymbolLookup lookup(uint64_t loadAddress, uint64_t address) const {
+        return index_.lookup(address - loadAddress + textAddress_);
+    }
+
+    /// `lookup` expanded into the calls inlined at `address`, innermost first.
+    void lookupInlined(uint64_t loadAddress, uint64_t address, std::vector<SymbolLookup> &chain) const {
+        index_.lookupInlined(address - loadAddress + textAddress_, chain);
+    }
+
+    /// Formats a lookup of `address` the way atos prints it:
+    /// "function (in Image) (File.swift:12)", "function (in Image) + 40", or
+    /// "<addressText> (in Image)" when no symbol covers the address.
+    std::string describe(const SymbolLookup &lookup, uint64_t loadAddress, uint64_t address,
+                         std::string_view addressText) const;
+
+private:
+    std::string name_;
+    std::array<uint8_t, 16> uuid_ {};
+    CpuArchitecture architecture_;
+    uint64_t textAddress_ = 0;
+    SymbolIndex index_;
+};
+
+} // namespace symbolicator
+
+#endif
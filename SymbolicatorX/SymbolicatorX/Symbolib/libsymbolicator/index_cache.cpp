@@ -0,0 +1,342 @@
+//
+//  index_cache.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "index_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "error.hpp"
+#include "mapped_file.hpp"
+#include "symbol_store.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'S', 'X', 'I', 'N', 'D', 'E', 'X', '\0'};
+constexpr uint32_t kIndexVersion = 4;
+constexpr const char *kIndexExtension = ".symindex";
+
+/// Fixed header at the start of every index file. Arrays follow at 8 byte
+/// aligned offsets and are mapped in place, so the file is host-endian.
+struct IndexFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint8_t uuid[16];
+    uint32_t cpuType;
+    uint32_t cpuSubtype;
+    uint64_t textAddress;
+    uint64_t nameOffset;
+    uint64_t nameSize;
+    uint64_t functionCount;
+    uint64_t functionStartsOffset;
+    uint64_t functionEndsOffset;
+    uint64_t functionNamesOffset;
+    uint64_t linesOffset;
+    uint64_t lineCount;
+    uint64_t filesOffset;
+    uint64_t fileCount;
+    uint64_t inlineSitesOffset;
+    uint64_t inlineSiteCount;
+    uint64_t inlineRangesOffset;
+    uint64_t inlineRangeCount;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+uint64_t aligned(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+std::string hexString(const std::array<uint8_t, 16> &bytes) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string result;
+    result.reserve(32);
+    for (uint8_t byte : bytes) {
+        result.push_back(digits[byte >> 4]);
+        result.push_back(digits[byte & 0x0f]);
+    }
+    return result;
+}
+
+template <typename T>
+Span<T> arrayAt(const MappedFile &file, uint64_t offset, uint64_t count) {
+    if (offset % alignof(T) != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+        throwBadFormat("index array out of bounds");
+    }
+    return {reinterpret_cast<const T *>(file.data() + offset), static_cast<size_t>(count)};
+}
+
+/// Checks every string offset, file number, inline parent and inline site
+/// in `arrays` against the tables they index, so a corrupt file of the
+/// right size cannot make lookups read outside the mapping.
+void validateArrays(const SymbolIndex::Arrays &arrays, const std::string &path) {
+    const uint64_t stringsSize = arrays.strings.size();
+    const uint64_t fileCount = arrays.files.size;
+    const uint64_t siteCount = arrays.inlineSites.size;
+    for (uint32_t name : arrays.functionNames) {
+        if (name >= stringsSize) {
+            throwBadFormat(path + ": function name out of range");
+        }
+    }
+    for (uint32_t file : arrays.files) {
+        if (file >= stringsSize) {
+            throwBadFormat(path + ": file name out of range");
+        }
+    }
+    for (const LineRow &row : arrays.lines) {
+        if (row.line != 0 && row.file >= fileCount) {
+            throwBadFormat(path + ": line row out of range");
+        }
+    }
+    for (uint64_t index = 0; index < siteCount; ++index) {
+        const InlineSite &site = arrays.inlineSites[index];
+        // Parents come first, so walking up a chain always ends.
+        if (site.name >= stringsSize || (site.parent != kNoInlineSite && site.parent >= index) ||
+            (site.callLine != 0 && site.callFile >= fileCount)) {
+            throwBadFormat(path + ": inline site out of range");
+        }
+    }
+    for (const InlineRange &range : arrays.inlineRanges) {
+        if (range.site >= siteCount || range.end < range.start) {
+            throwBadFormat(path + ": inline range out of range");
+        }
+    }
+}
+
+} // namespace
+
+void writeIndexFile(const std::string &path, const Image &image) {
+    const SymbolIndex::Arrays &index = image.index().arrays();
+
+    IndexFileHeader header {};
+    std::memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.version = kIndexVersion;
+    std::memcpy(header.uuid, image.uuid().data(), sizeof(header.uuid));
+    header.cpuType = image.architecture().type;
+    header.cpuSubtype = image.architecture().subtype;
+    header.textAddress = image.textAddress();
+
+    header.nameOffset = sizeof(IndexFileHeader);
+    header.nameSize = image.name().size();
+    header.functionCount = index.functionStarts.size;
+    header.functionStartsOffset = aligned(header.nameOffset + header.nameSize);
+    header.functionEndsOffset = aligned(header.functionStartsOffset + header.functionCount * sizeof(uint64_t));
+    header.functionNamesOffset = aligned(header.functionEndsOffset + header.functionCount * sizeof(uint64_t));
+    header.linesOffset = aligned(header.functionNamesOffset + header.functionCount * sizeof(uint32_t));
+    header.lineCount = index.lines.size;
+    header.filesOffset = aligned(header.linesOffset + header.lineCount * sizeof(LineRow));
+    header.fileCount = index.files.size;
+    header.inlineSitesOffset = aligned(header.filesOffset + header.fileCount * sizeof(uint32_t));
+    header.inlineSiteCount = index.inlineSites.size;
+    header.inlineRangesOffset = aligned(header.inlineSitesOffset + header.inlineSiteCount * sizeof(InlineSite));
+    header.inlineRangeCount = index.inlineRanges.size;
+    header.stringsOffset = aligned(header.inlineRangesOffset + header.inlineRangeCount * sizeof(InlineRange));
+    header.stringsSize = index.strings.size();
+
+    static std::atomic<unsigned> sequence {0};
+    const std::string temporary = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(sequence++);
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw Error(SYMBOLICATOR_E_IO_ERROR, temporary + ": " + std::strerror(errno));
+    }
+
+    try {
+        uint64_t position = 0;
+        const uint8_t padding[8] = {};
+        auto emit = [&](uint64_t offset, const void *data, uint64_t size) {
+            writeAll(fd, padding, static_cast<size_t>(offset - position), temporary);
+            writeAll(fd, data, static_cast<size_t>(size), temporary);
+            position = offset + size;
+        };
+        emit(0, &header, sizeof(header));
+        emit(header.nameOffset, image.name().data(), header.nameSize);
+        emit(header.functionStartsOffset, index.functionStarts.data, header.functionCount * sizeof(uint64_t));
+        emit(header.functionEndsOffset, index.functionEnds.data, header.functionCount * sizeof(uint64_t));
+        emit(header.functionNamesOffset, index.functionNames.data, header.functionCount * sizeof(uint32_t));
+        emit(header.linesOffset, index.lines.data, header.lineCount * sizeof(LineRow));
+        emit(header.filesOffset, index.files.data, header.fileCount * sizeof(uint32_t));
+        emit(header.inlineSitesOffset, index.inlineSites.data, header.inlineSiteCount * sizeof(InlineSite));
+        emit(header.inlineRangesOffset, index.inlineRanges.data, header.inlineRangeCount * sizeof(InlineRange));
+        emit(header.stringsOffset, index.strings.data(), header.stringsSize);
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+
+    if (::close(fd) != 0 || ::rename(temporary.c_str(), path.c_str()) != 0) {
+        const int savedErrno = errno;
+        ::unlink(temporary.c_str());
+        throw Error(SYMBOLICATOR_E_IO_ERROR, path + ": " + std::strerror(savedErrno));
+    }
+}
+
+Image readIndexFile(const std::string &path) {
+    auto file = std::make_shared<MappedFile>(MappedFile::open(path));
+    if (file->size() < sizeof(IndexFileHeader)) {
+        throwBadFormat(path + ": truncated symbol index");
+    }
+
+    IndexFileHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || header.version != kIndexVersion) {
+        throwBadFormat(path + ": incompatible symbol index");
+    }
+
+    const auto name = arrayAt<char>(*file, header.nameOffset, header.nameSize);
+    SymbolIndex::Arrays arrays;
+    arrays.functionStarts = arrayAt<uint64_t>(*file, header.functionStartsOffset, header.functionCount);
+    arrays.functionEnds = arrayAt<uint64_t>(*file, header.functionEndsOffset, header.functionCount);
+    arrays.functionNames = arrayAt<uint32_t>(*file, header.functionNamesOffset, header.functionCount);
+    arrays.lines = arrayAt<LineRow>(*file, header.linesOffset, header.lineCount);
+    arrays.files = arrayAt<uint32_t>(*file, header.filesOffset, header.fileCount);
+    arrays.inlineSites = arrayAt<InlineSite>(*file, header.inlineSitesOffset, header.inlineSiteCount);
+    arrays.inlineRanges = arrayAt<InlineRange>(*file, header.inlineRangesOffset, header.inlineRangeCount);
+    const auto strings = arrayAt<char>(*file, header.stringsOffset, header.stringsSize);
+    if (strings.empty() || strings[strings.size - 1] != '\0') {
+        throwBadFormat(path + ": unterminated string pool");
+    }
+    arrays.strings = std::string_view(strings.data, strings.size);
+    validateArrays(arrays, path);
+
+    std::array<uint8_t, 16> uuid;
+    std::memcpy(uuid.data(), header.uuid, uuid.size());
+    CpuArchitecture architecture;
+    architecture.type = header.cpuType;
+    architecture.subtype = header.cpuSubtype;
+
+    SymbolIndex index = SymbolIndex::view(file, arrays);
+    return Image(std::string(name.data, name.size), uuid, architecture, header.textAddress, std::move(index));
+}
+
+IndexCache::IndexCache(std::string directory, uint64_t maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes) {
+    while (directory_.size() > 1 && directory_.back() == '/') {
+        directory_.pop_back();
+    }
+}
+
+std::string IndexCache::pathFor(const std::array<uint8_t, 16> &uuid, const char *arch) const {
+    return directory_ + "/" + hexString(uuid) + "." + (arch != nullptr ? arch : "any") + kIndexExtension;
+}
+
+std::shared_ptr<const Image> IndexCache::loaded(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = loaded_.find(key);
+    return found != loaded_.end() ? found->second.lock() : nullptr;
+}
+
+std::shared_ptr<const Image> IndexCache::remember(const std::string &key, std::shared_ptr<const Image> image) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loaded_[key] = image;
+    return image;
+}
+
+std::shared_ptr<const Image> IndexCache::find(const std::array<uint8_t, 16> &uuid, const char *arch) {
+    const std::string key = pathFor(uuid, arch);
+    if (auto image = loaded(key)) {
+        return image;
+    }
+
+    try {
+        auto image = std::make_shared<const Image>(readIndexFile(key));
+        ::utimes(key.c_str(), nullptr);
+        return remember(key, std::move(image));
+    } catch (const Error &error) {
+        if (error.code() == SYMBOLICATOR_E_BAD_FORMAT) {
+            ::unlink(key.c_str());
+        }
+        return nullptr;
+    }
+}
+
+std::shared_ptr<const Image> IndexCache::open(const std::string &path, const char *arch) {
+    // A symbol store opens about as fast as a cached index.
+    MachOSlice store;
+    if (readSymbolStoreSlice(path, store)) {
+        return std::make_shared<const Image>(readSymbolStore(path, arch));
+    }
+
+    MachOFile file = MachOFile::open(path, arch);
+    if (!file.hasUUID()) {
+        return std::make_shared<const Image>(Image::build(path, file));
+    }
+
+    if (auto image = find(file.uuid(), arch)) {
+        return image;
+    }
+
+    auto image = std::make_shared<const Image>(Image::build(path, file));
+    const std::string key = pathFor(file.uuid(), arch);
+    try {
+        createDirectories(directory_);
+        writeIndexFile(key, *image);
+        trim();
+    } catch (const Error &) {
+        // A read-only or full cache directory must not fail symbolication.
+    }
+    return remember(key, std::move(image));
+}
+
+void IndexCache::trim() {
+    struct Entry {
+        std::string path;
+        uint64_t size;
+        time_t modified;
+    };
+
+    DIR *directory = ::opendir(directory_.c_str());
+    if (directory == nullptr) {
+        return;
+    }
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    const size_t extensionLength = std::strlen(kIndexExtension);
+    while (const dirent *item = ::readdir(directory)) {
+        const std::string name = item->d_name;
+        if (name.size() <= extensionLength || name.compare(name.size() - extensionLength, extensionLength, kIndexExtension) != 0) {
+            continue;
+        }
+        const std::string path = directory_ + "/" + name;
+        struct stat info;
+        if (::stat(path.c_str(), &info) == 0) {
+            entries.push_back({path, static_cast<uint64_t>(info.st_size), info.st_mtime});
+            total += static_cast<uint64_t>(info.st_size);
+        }
+    }
+    ::closedir(directory);
+
+    if (total <= maxBytes_) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) { return lhs.modified < rhs.modified; });
+    for (const auto &entry : entries) {
+        if (total <= maxBytes_) {
+            break;
+        }
+        // Images already mapped keep working: unlinking only drops the name.
+        if (::unlink(entry.path.c_str()) == 0) {
+            total -= entry.size;
+        }
+    }
+}
+
+} // namespace symbolicator
@@ -0,0 +1,66 @@
+//
+//  index_cache.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_INDEX_CACHE_HPP
+#define SYMBOLICATOR_INDEX_CACHE_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "image.hpp"
+
+namespace symbolicator {
+
+/// Directory of memory-mappable symbol indexes named `<UUID>.<arch>.symindex`.
+///
+/// A cached index is mapped and used in place, so reopening a build costs a
+/// header check instead of a DWARF parse. Every hit touches the file's mtime
+/// and the directory is trimmed oldest-first whenever it outgrows `maxBytes`.
+class IndexCache {
+public:
+    IndexCache(std::string directory, uint64_t maxBytes);
+
+    /// Returns the image for the slice of `path` matching `arch`, loading the
+    /// cached index for its UUID or building and storing one. Throws `Error`.
+    std::shared_ptr<const Image> open(const std::string &path, const char *arch);
+
+    /// Returns the cached image for `uuid` without touching any dSYM, or null.
+    std::shared_ptr<const Image> find(const std::array<uint8_t, 16> &uuid, const char *arch);
+
+    /// Deletes least recently used indexes until the directory fits `maxBytes`.
+    void trim();
+
+    const std::string &directory() const { return directory_; }
+
+private:
+    std::string pathFor(const std::array<uint8_t, 16> &uuid, const char *arch) const;
+    std::shared_ptr<const Image> remember(const std::string &key, std::shared_ptr<const Image> image);
+    std::shared_ptr<const Image> loaded(const std::string &key);
+
+    std::string directory_;
+    uint64_t maxBytes_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<const Image>> loaded_;
+};
+
+/// Serializes `image` into the cache file format. Writes atomically via a
+/// temporary file and rename. Throws `Error`.
+void writeIndexFile(const std::string &path, const Image &image);
+
+/// Maps a file written by `writeIndexFile`. Throws `Error` if it is missing,
+/// truncated or from an incompatible version.
+Image readIndexFile(const std::string &path);
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,492 @@
+//
+//  ips_report.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "ips_report.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+#include "crash_report.hpp"
+#include "error.hpp"
+#include "json_reader.hpp"
+#include "json_writer.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+void appendHex(std::string &out, uint64_t value) {
+    char buffer[24];
+    const int length = std::snprintf(buffer, sizeof(buffer), "0x%" PRIx64, value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+void appendDecimal(std::string &out, int64_t value) {
+    out.append(std::to_string(value));
+}
+
+/// Pads `value` with spaces, or cuts it, to exactly `width` characters,
+/// counting UTF-8 sequences as one character each.
+void appendPadded(std::string &out, std::string_view value, size_t width) {
+    size_t characters = 0;
+    size_t index = 0;
+    for (; index < value.size(); ++index) {
+        if ((static_cast<unsigned char>(value[index]) & 0xc0) != 0x80) {
+            if (characters == width) {
+                break;
+            }
+            ++characters;
+        }
+    }
+    out.append(value.data(), index);
+    out.append(width - characters, ' ');
+}
+
+/// Appends "<label><first> [<second>]\n" and friends without a format string.
+void appendLine(std::string &out, std::initializer_list<std::string_view> parts) {
+    for (const auto part : parts) {
+        out.append(part.data(), part.size());
+    }
+    out.push_back('\n');
+}
+
+/// Last path component of `path`.
+std::string_view fileName(std::string_view path) {
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+} // namespace
+
+std::string_view IPSReport::keep(const JSONReader &reader, std::string_view value) {
+    if (reader.borrows(value)) {
+        return value;
+    }
+    pool_.emplace_back(value);
+    return pool_.back();
+}
+
+std::string_view IPSReport::keepText(JSONReader &reader) {
+    return keep(reader, reader.text());
+}
+
+bool IPSReport::readString(JSONReader &reader, std::string_view &value) {
+    if (reader.peek() != JSONReader::Type::String) {
+        reader.skip();
+        return false;
+    }
+    value = keep(reader, reader.string());
+    return true;
+}
+
+bool IPSReport::readInteger(JSONReader &reader, int64_t &value) {
+    if (reader.peek() != JSONReader::Type::Number) {
+        reader.skip();
+        return false;
+    }
+    value = reader.integer();
+    return true;
+}
+
+void IPSReport::readHeaderLine(std::string_view line) {
+    // A damaged header line only costs the two fields read from it.
+    try {
+        JSONReader reader(line);
+        reader.beginObject();
+        std::string_view key;
+        while (reader.nextKey(key)) {
+            if (key == "incident_id") {
+                header_.incidentIdentifier = keepText(reader);
+            } else if (key == "os_version") {
+                header_.osVersion = keepText(reader);
+            } else {
+                reader.skip();
+            }
+        }
+    } catch (const Error &) {
+    }
+}
+
+void IPSReport::readPayload(JSONReader &reader, size_t base) {
+    std::string_view key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "threads" && reader.peek() == JSONReader::Type::Array) {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                readThread(reader, base);
+            }
+        } else if (key == "usedImages" && reader.peek() == JSONReader::Type::Array) {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                readImage(reader);
+            }
+        } else if (key == "bundleInfo") {
+            header_.hasBundleInfo = true;
+            if (reader.peek() != JSONReader::Type::Object) {
+                reader.skip();
+                continue;
+            }
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == "CFBundleIdentifier") {
+                    header_.bundleIdentifier = keepText(reader);
+                } else if (key == "CFBundleShortVersionString") {
+                    header_.shortVersion = keepText(reader);
+                } else if (key == "CFBundleVersion") {
+                    header_.bundleVersion = keepText(reader);
+                } else {
+                    reader.skip();
+                }
+            }
+        } else if (key == "exception" && reader.peek() == JSONReader::Type::Object) {
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == "type") {
+                    header_.exceptionType = keepText(reader);
+                } else if (key == "signal") {
+                    header_.exceptionSignal = keepText(reader);
+                } else if (key == "codes") {
+                    header_.exceptionCodes = keepText(reader);
+                } else {
+                    reader.skip();
+                }
+            }
+        } else if (key == "osVersion" && reader.peek() == JSONReader::Type::Object) {
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == "releaseType") {
+                    header_.releaseType = keepText(reader);
+                } else {
+                    reader.skip();
+                }
+            }
+        } else if (key == "crashReporterKey") {
+            header_.crashReporterKey = keepText(reader);
+        } else if (key == "modelCode") {
+            header_.modelCode = keepText(reader);
+        } else if (key == "procName") {
+            header_.processName = keepText(reader);
+        } else if (key == "pid") {
+            header_.pid = keepText(reader);
+        } else if (key == "procPath") {
+            header_.processPath = keepText(reader);
+        } else if (key == "cpuType") {
+            header_.cpuType = keepText(reader);
+        } else if (key == "procRole") {
+            header_.processRole = keepText(reader);
+        } else if (key == "parentProc") {
+            header_.parentProcess = keepText(reader);
+        } else if (key == "parentPid") {
+            header_.parentPid = keepText(reader);
+        } else if (key == "coalitionName") {
+            header_.coalitionName = keepText(reader);
+        } else if (key == "coalitionID") {
+            header_.coalitionIdentifier = keepText(reader);
+        } else if (key == "captureTime") {
+            header_.captureTime = keepText(reader);
+        } else if (key == "procLaunch") {
+            header_.launchTime = keepText(reader);
+        } else if (key == "basebandVersion") {
+            header_.basebandVersion = keepText(reader);
+        } else if (key == "faultingThread") {
+            header_.faultingThread = keepText(reader);
+        } else {
+            reader.skip();
+        }
+    }
+}
+
+void IPSReport::readThread(JSONReader &reader, size_t base) {
+    IPSThread thread;
+    thread.firstFrame = frames_.size();
+    if (reader.peek() != JSONReader::Type::Object) {
+        reader.skip();
+        threads_.push_back(thread);
+        return;
+    }
+
+    std::string_view queue;
+    bool hasQueue = false;
+    std::string_view key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "name") {
+            thread.hasName = readString(reader, thread.name);
+        } else if (key == "queue") {
+            hasQueue = readString(reader, queue);
+        } else if (key == "triggered") {
+            thread.triggered = reader.peek() == JSONReader::Type::Boolean ? reader.boolean() : (reader.skip(), false);
+        } else if (key == "frames" && reader.peek() == JSONReader::Type::Array) {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                readFrame(reader, base);
+            }
+        } else {
+            reader.skip();
+        }
+    }
+    if (!thread.hasName && hasQueue) {
+        thread.name = queue;
+        thread.hasName = true;
+    }
+    thread.frameCount = frames_.size() - thread.firstFrame;
+    threads_.push_back(thread);
+}
+
+void IPSReport::readFrame(JSONReader &reader, size_t base) {
+    IPSFrame frame;
+    if (reader.peek() != JSONReader::Type::Object) {
+        reader.skip();
+        frames_.push_back(frame);
+        return;
+    }
+
+    bool hasSymbolLocation = false;
+    bool hasSourceLine = false;
+    int64_t imageOffset = 0;
+    std::string_view key;
+    reader.beginObject();
+    frame.end = base + reader.offset();
+    while (reader.nextKey(key)) {
+        frame.hasMembers = true;
+        if (key == "imageIndex") {
+            readInteger(reader, frame.imageIndex);
+        } else if (key == "imageOffset") {
+            readInteger(reader, imageOffset);
+        } else if (key == "symbol") {
+            frame.hasSymbolName = true;
+            frame.hasSymbol = readString(reader, frame.symbol);
+        } else if (key == "symbolLocation") {
+            hasSymbolLocation = readInteger(reader, frame.symbolLocation);
+        } else if (key == "sourceFile") {
+            frame.hasSource = readString(reader, frame.sourceFile);
+        } else if (key == "sourceLine") {
+            hasSourceLine = readInteger(reader, frame.sourceLine);
+        } else {
+            reader.skip();
+        }
+        // New members go right after the last one, ahead of any whitespace.
+        frame.end = base + reader.offset();
+    }
+    frame.imageOffset = static_cast<uint64_t>(imageOffset);
+    frame.hasSymbol = frame.hasSymbol && hasSymbolLocation;
+    frame.hasSource = frame.hasSource && hasSourceLine;
+    frames_.push_back(frame);
+}
+
+void IPSReport::readImage(JSONReader &reader) {
+    IPSImage image;
+    if (reader.peek() != JSONReader::Type::Object) {
+        reader.skip();
+        images_.push_back(image);
+        return;
+    }
+
+    int64_t value = 0;
+    std::string_view key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "base") {
+            image.base = readInteger(reader, value) ? static_cast<uint64_t>(value) : 0;
+        } else if (key == "size") {
+            image.size = readInteger(reader, value) ? static_cast<uint64_t>(value) : 0;
+        } else if (key == "name") {
+            image.name = keepText(reader);
+        } else if (key == "arch") {
+            image.arch = keepText(reader);
+        } else if (key == "uuid") {
+            image.uuid = keepText(reader);
+        } else if (key == "path") {
+            image.path = keepText(reader);
+        } else {
+            reader.skip();
+        }
+    }
+    images_.push_back(image);
+}
+
+const IPSImage *IPSReport::image(const IPSFrame &frame) const {
+    return frame.imageIndex >= 0 && static_cast<uint64_t>(frame.imageIndex) < images_.size()
+               ? &images_[static_cast<size_t>(frame.imageIndex)]
+               : nullptr;
+}
+
+std::string IPSReport::architecture(const IPSImage &image) const {
+    return architectureName(image.arch, header_.cpuType);
+}
+
+std::string IPSReport::text(const std::vector<IPSSymbol> &symbols) const {
+    // Roughly one text line per frame and image, far smaller than the JSON.
+    std::string out;
+    out.reserve(2048 + (frames_.size() + images_.size()) * 128);
+
+    const IPSHeader &header = header_;
+    appendLine(out, {"Incident Identifier: ", header.incidentIdentifier});
+    appendLine(out, {"CrashReporter Key:   ", header.crashReporterKey});
+    appendLine(out, {"Hardware Model:      ", header.modelCode});
+    appendLine(out, {"Process:             ", header.processName, " [", header.pid, "]"});
+    appendLine(out, {"Path:                ", header.processPath});
+    if (header.hasBundleInfo) {
+        appendLine(out, {"Identifier:          ", header.bundleIdentifier});
+        appendLine(out, {"Version:             ", header.shortVersion, " (", header.bundleVersion, ")"});
+    }
+    appendLine(out, {"Report Version:      104"});
+    appendLine(out, {"Code Type:           ", header.cpuType, " (Native(?))"});
+    appendLine(out, {"Role:                ", header.processRole});
+    appendLine(out, {"Parent Process:      ", header.parentProcess, " [", header.parentPid, "]"});
+    appendLine(out, {"Coalition:           ", header.coalitionName, " [", header.coalitionIdentifier, "]"});
+    out.push_back('\n');
+    appendLine(out, {"Date/Time:           ", header.captureTime});
+    appendLine(out, {"Launch Time:         ", header.launchTime});
+    appendLine(out, {"OS Version:          ", header.osVersion});
+    appendLine(out, {"Release Type:        ", header.releaseType});
+    appendLine(out, {"Baseband Version:    ", header.basebandVersion});
+    out.push_back('\n');
+    appendLine(out, {"Exception Type:  ", header.exceptionType, " (", header.exceptionSignal, ")"});
+    appendLine(out, {"Exception Codes: ", header.exceptionCodes});
+    appendLine(out, {"Triggered by Thread:  ", header.faultingThread});
+    out.push_back('\n');
+
+    static const IPSImage kMissingImage;
+    for (size_t id = 0; id < threads_.size(); ++id) {
+        const IPSThread &thread = threads_[id];
+        const std::string number = std::to_string(id);
+        out.push_back('\n');
+        if (thread.hasName) {
+            appendLine(out, {"Thread ", number, " name:  ", thread.name});
+        }
+        appendLine(out, {"Thread ", number, thread.triggered ? " Crashed:" : ":"});
+
+        for (size_t index = 0; index < thread.frameCount; ++index) {
+            const IPSFrame &frame = frames_[thread.firstFrame + index];
+            const size_t frameIndex = thread.firstFrame + index;
+            const IPSImage *found = this->image(frame);
+            const IPSImage &image = found != nullptr ? *found : kMissingImage;
+            const IPSSymbol *symbol = frameIndex < symbols.size() && symbols[frameIndex].function != nullptr
+                                          ? &symbols[frameIndex]
+                                          : nullptr;
+            const size_t lineStart = out.size();
+            appendPadded(out, std::to_string(index), 5);
+            appendPadded(out, image.name, 40);
+            appendHex(out, frame.imageOffset + image.base);
+            out.push_back(' ');
+            if (!frame.hasSymbol && symbol != nullptr && !symbol->inlined.empty()) {
+                const std::string prefix = out.substr(lineStart);
+                for (const auto &inlined : symbol->inlined) {
+                    out.append(inlined.function).append(" + ");
+                    appendDecimal(out, static_cast<int64_t>(inlined.location));
+                    if (inlined.file != nullptr && inlined.line > 0) {
+                        out.append(" (").append(fileName(inlined.file)).push_back(':');
+                        appendDecimal(out, inlined.line);
+                        out.push_back(')');
+                    }
+                    out.append(" [inlined]\n").append(prefix);
+                }
+            }
+            if (frame.hasSymbol) {
+                out.append(frame.symbol.data(), frame.symbol.size()).append(" + ");
+                appendDecimal(out, frame.symbolLocation);
+            } else if (symbol != nullptr) {
+                out.append(symbol->function).append(" + ");
+                appendDecimal(out, static_cast<int64_t>(symbol->location));
+            } else {
+                appendHex(out, image.base);
+                out.append(" + ");
+                appendDecimal(out, static_cast<int64_t>(frame.imageOffset));
+            }
+            if (frame.hasSource) {
+                out.append(" (").append(frame.sourceFile.data(), frame.sourceFile.size()).push_back(':');
+                appendDecimal(out, frame.sourceLine);
+                out.push_back(')');
+            } else if (!frame.hasSymbol && symbol != nullptr && symbol->file != nullptr && symbol->line > 0) {
+                out.append(" (").append(fileName(symbol->file)).push_back(':');
+                appendDecimal(out, symbol->line);
+                out.push_back(')');
+            }
+            out.push_back('\n');
+        }
+    }
+
+    out.append("\nBinary Images:\n");
+    for (const auto &image : images_) {
+        appendHex(out, image.base);
+        out.append(" - ");
+        appendHex(out, image.base + image.size - 1);
+        out.push_back(' ');
+        out.append(image.name.data(), image.name.size()).push_back(' ');
+        out.append(image.arch.data(), image.arch.size()).append(" <");
+        for (const char character : image.uuid) {
+            if (character != '-') {
+                out.push_back(character);
+            }
+        }
+        out.append("> ").append(image.path.data(), image.path.size()).push_back('\n');
+    }
+    return out;
+}
+
+std::string IPSReport::json(std::string_view ips, const std::vector<IPSSymbol> &symbols) const {
+    std::string out;
+    out.reserve(ips.size() + symbols.size() * 64);
+    size_t copied = 0;
+    for (size_t index = 0; index < frames_.size() && index < symbols.size(); ++index) {
+        const IPSFrame &frame = frames_[index];
+        const IPSSymbol &symbol = symbols[index];
+        if (symbol.function == nullptr || frame.hasSymbolName || frame.end == 0 || frame.end < copied) {
+            continue;
+        }
+        out.append(ips.data() + copied, frame.end - copied);
+        copied = frame.end;
+
+        out.append(frame.hasMembers ? ",\"symbol\":" : "\"symbol\":");
+        appendJSONString(out, symbol.function);
+        out.append(",\"symbolLocation\":").append(std::to_string(symbol.location));
+        if (!frame.hasSource && symbol.file != nullptr && symbol.line > 0) {
+            out.append(",\"sourceFile\":");
+            appendJSONString(out, fileName(symbol.file));
+            out.append(",\"sourceLine\":").append(std::to_string(symbol.line));
+        }
+    }
+    out.append(ips.data() + copied, ips.size() - copied);
+    return out;
+}
+
+IPSReport IPSReport::parse(std::string_view ips) {
+    const size_t newline = ips.find('\n');
+    if (newline == std::string_view::npos) {
+        throwBadFormat("missing .ips payload");
+    }
+
+    IPSReport report;
+    report.readHeaderLine(ips.substr(0, newline));
+
+    JSONReader reader(ips.substr(newline + 1));
+    report.readPayload(reader, newline + 1);
+    if (!reader.atEnd()) {
+        throwBadFormat("trailing data after .ips payload");
+    }
+    return report;
+}
+
+bool isIPS(std::string_view text) {
+    for (const char character : text) {
+        if (character != ' ' && character != '\n' && character != '\r' && character != '\t') {
+            return character == '{';
+        }
+    }
+    return false;
+}
+
+std::string translateIPS(std::string_view ips) {
+    return IPSReport::parse(ips).text();
+}
+
+} // namespace symbolicator
@@ -0,0 +1,162 @@
+//
+//  ips_report.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_IPS_REPORT_HPP
+#define SYMBOLICATOR_IPS_REPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace symbolicator {
+
+class JSONReader;
+
+/// One entry of the payload's "usedImages".
+struct IPSImage {
+    uint64_t base = 0;
+    uint64_t size = 0;
+    std::string_view name;
+    std::string_view arch;
+    std::string_view uuid;
+    std::string_view path;
+};
+
+/// One entry of a thread's "frames".
+struct IPSFrame {
+    int64_t imageIndex = 0;
+    uint64_t imageOffset = 0;
+    std::string_view symbol;
+    std::string_view sourceFile;
+    int64_t symbolLocation = 0;
+    int64_t sourceLine = 0;
+    bool hasSymbol = false;     ///< Both "symbol" and "symbolLocation" are present.
+    bool hasSource = false;     ///< Both "sourceFile" and "sourceLine" are present.
+    bool hasSymbolName = false; ///< A "symbol" member is present at all.
+    bool hasMembers = false;
+    size_t end = 0;             ///< Offset in the .ips text just past the frame's last member, or
+                                ///< its opening brace; 0 when the frame is not an object.
+};
+
+struct IPSThread {
+    std::string_view name; ///< "name", or "queue" when the thread has no name.
+    bool hasName = false;
+    bool triggered = false;
+    size_t firstFrame = 0; ///< Index of the thread's first frame in `IPSReport::frames`.
+    size_t frameCount = 0;
+};
+
+/// Fields of the header line and the payload the text format prints.
+struct IPSHeader {
+    std::string_view incidentIdentifier;
+    std::string_view osVersion;
+    std::string_view crashReporterKey;
+    std::string_view modelCode;
+    std::string_view processName;
+    std::string_view pid;
+    std::string_view processPath;
+    std::string_view bundleIdentifier;
+    std::string_view shortVersion;
+    std::string_view bundleVersion;
+    bool hasBundleInfo = false;
+    std::string_view cpuType;
+    std::string_view processRole;
+    std::string_view parentProcess;
+    std::string_view parentPid;
+    std::string_view coalitionName;
+    std::string_view coalitionIdentifier;
+    std::string_view captureTime;
+    std::string_view launchTime;
+    std::string_view releaseType;
+    std::string_view basebandVersion;
+    std::string_view exceptionType;
+    std::string_view exceptionSignal;
+    std::string_view exceptionCodes;
+    std::string_view faultingThread;
+};
+
+/// Symbol resolved for one frame. A null `function` leaves the frame as is.
+struct IPSSymbol {
+    const char *function = nullptr;
+    uint64_t location = 0;       ///< Offset of the address into `function`.
+    const char *file = nullptr;  ///< Source path; printed by its last component.
+    uint32_t line = 0;
+    std::vector<IPSSymbol> inlined; ///< Calls inlined at the address, innermost first.
+};
+
+/// The parts of an .ips report (a JSON header line followed by a JSON
+/// payload) symbolication needs, read in one streaming pass. Strings point
+/// into the .ips text, or into storage owned by the report for the few
+/// that contain escapes, so the text must outlive the report.
+class IPSReport {
+public:
+    IPSReport() = default;
+    IPSReport(IPSReport &&) = default;
+    IPSReport &operator=(IPSReport &&) = default;
+    IPSReport(const IPSReport &) = delete;
+    IPSReport &operator=(const IPSReport &) = delete;
+
+    /// Throws `Error` when the payload is not valid JSON.
+    static IPSReport parse(std::string_view ips);
+
+    const IPSHeader &header() const { return header_; }
+    const std::vector<IPSThread> &threads() const { return threads_; }
+    const std::vector<IPSFrame> &frames() const { return frames_; }
+    const std::vector<IPSImage> &images() const { return images_; }
+
+    /// The image `frame` lies in, or null when its index is out of range.
+    const IPSImage *image(const IPSFrame &frame) const;
+
+    /// Architecture name `image` should be looked up with, as understood by
+    /// `CpuArchitecture::parse`. Empty when neither the image nor the
+    /// report's "cpuType" gives a usable one.
+    std::string architecture(const IPSImage &image) const;
+
+    /// The legacy text crash format: header, one backtrace per thread and the
+    /// binary image table. `symbols`, when given, holds one entry per frame
+    /// and fills in the frames the report left unsymbolicated; inlined calls
+    /// repeat the frame line, marked "[inlined]".
+    std::string text(const std::vector<IPSSymbol> &symbols = {}) const;
+
+    /// `ips` (the text the report was parsed from) with "symbol",
+    /// "symbolLocation", "sourceFile" and "sourceLine" added to every frame
+    /// that has no "symbol" yet and a resolved entry in `symbols`.
+    std::string json(std::string_view ips, const std::vector<IPSSymbol> &symbols) const;
+
+private:
+    void readHeaderLine(std::string_view line);
+    void readPayload(JSONReader &reader, size_t base);
+    void readThread(JSONReader &reader, size_t base);
+    void readFrame(JSONReader &reader, size_t base);
+    void readImage(JSONReader &reader);
+
+    std::string_view keep(const JSONReader &reader, std::string_view value);
+    std::string_view keepText(JSONReader &reader);
+    bool readString(JSONReader &reader, std::string_view &value);
+    bool readInteger(JSONReader &reader, int64_t &value);
+
+    std::deque<std::string> pool_;
+    IPSHeader header_;
+    std::vector<IPSThread> threads_;
+    std::vector<IPSFrame> frames_;
+    std::vector<IPSImage> images_;
+};
+
+/// Whether `text` is an .ips report rather than a text report.
+bool isIPS(std::string_view text);
+
+/// Translates an .ips report into the legacy text crash format. Throws
+/// `Error` when the payload is not valid JSON.
+std::string translateIPS(std::string_view ips);
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,1383 @@
+//
+//  itanium_demangler.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "itanium_demangler.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace symbolicator {
+
+namespace {
+
+/// Parsed name or type. Declarators print in two halves around whatever
+/// they are applied to, like LLVM's demangler: "void (*" and ")(int)".
+struct Node {
+    enum class Kind : uint8_t {
+        Name,            ///< `text`
+        Nested,          ///< children[0]::children[1]
+        Template,        ///< children[0]<children[1]>, children[1] being a List
+        List,            ///< Children separated by ", "; template arguments, and packs with `text` "pack".
+        Qualified,       ///< children[0] followed by the qualifiers in `text`.
+        Pointer,         ///< children[0] `text` ("*", "&" or "&&").
+        Function,        ///< children[0] (children[1], ...) with `text` after the parameters.
+        Array,           ///< children[0] [`text`]
+        Vector,          ///< children[0] vector[`text`]
+        MemberPointer,   ///< children[1] children[0]::*
+        Encoding,        ///< Like Function with children[0] the name, children[1] the return type or null.
+        Prefixed,        ///< `text` children[0]
+        Suffixed,        ///< children[0] `text`
+        Local,           ///< children[0]::children[1]
+    };
+
+    Kind kind;
+    std::string text;
+    std::vector<Node *> children;
+};
+
+bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+bool hasFunction(const Node *node) {
+    return node->kind == Node::Kind::Function;
+}
+
+bool hasArray(const Node *node) {
+    return node->kind == Node::Kind::Array ||
+           (node->kind == Node::Kind::Qualified && hasArray(node->children[0]));
+}
+
+bool hasRightSide(const Node *node) {
+    switch (node->kind) {
+    case Node::Kind::Function:
+    case Node::Kind::Array: return true;
+    case Node::Kind::Pointer:
+    case Node::Kind::Qualified: return hasRightSide(node->children[0]);
+    case Node::Kind::MemberPointer: return hasRightSide(node->children[1]);
+    default: return false;
+    }
+}
+
+/// Applies reference collapsing to a pointer or reference, which template
+/// arguments can stack: "T& &" and "T&& &" are "T&", "T&& &&" is "T&&".
+const Node *collapseReferences(const Node *node, std::string_view &declarator) {
+    declarator = node->text;
+    const Node *pointee = node->children[0];
+    if (declarator == "*") {
+        return pointee;
+    }
+    while (pointee->kind == Node::Kind::Pointer && pointee->text != "*") {
+        if (pointee->text == "&") {
+            declarator = "&";
+        }
+        pointee = pointee->children[0];
+    }
+    return pointee;
+}
+
+const Node *findPack(const Node *node) {
+    if (node->kind == Node::Kind::List && node->text == "pack") {
+        return node;
+    }
+    for (const Node *child : node->children) {
+        if (const Node *pack = child != nullptr ? findPack(child) : nullptr) {
+            return pack;
+        }
+    }
+    return nullptr;
+}
+
+void print(const Node *node, std::string &out);
+
+void printList(const std::vector<Node *> &nodes, size_t first, std::string &out) {
+    bool empty = true;
+    for (size_t index = first; index < nodes.size(); ++index) {
+        const size_t mark = out.size();
+        if (!empty) {
+            out.append(", ");
+        }
+        const size_t start = out.size();
+        print(nodes[index], out);
+        // An empty pack leaves no trace, separator included.
+        if (out.size() == start && nodes[index]->kind == Node::Kind::List) {
+            out.resize(mark);
+            continue;
+        }
+        empty = false;
+    }
+}
+
+/// Substitutions let a short name expand exponentially; printing stops
+/// growing the output past this and the name is rejected.
+constexpr size_t kMaxLength = 1 << 16;
+
+void printLeft(const Node *node, std::string &out) {
+    if (out.size() > kMaxLength) {
+        return;
+    }
+    const auto &children = node->children;
+    switch (node->kind) {
+    case Node::Kind::Name: out.append(node->text); break;
+    case Node::Kind::Nested:
+    case Node::Kind::Local:
+        print(children[0], out);
+        out.append("::");
+        print(children[1], out);
+        break;
+    case Node::Kind::Template:
+        print(children[0], out);
+        out.push_back('<');
+        printList(children[1]->children, 0, out);
+        out.push_back('>');
+        break;
+    case Node::Kind::List: printList(children, 0, out); break;
+    case Node::Kind::Qualified:
+        printLeft(children[0], out);
+        out.append(node->text);
+        break;
+    case Node::Kind::Pointer: {
+        std::string_view declarator;
+        const Node *pointee = collapseReferences(node, declarator);
+        printLeft(pointee, out);
+        if (hasArray(pointee)) {
+            out.push_back(' ');
+        }
+        if (hasArray(pointee) || hasFunction(pointee)) {
+            out.push_back('(');
+        }
+        out.append(declarator);
+        break;
+    }
+    case Node::Kind::Function:
+        printLeft(children[0], out);
+        out.push_back(' ');
+        break;
+    case Node::Kind::Array: printLeft(children[0], out); break;
+    case Node::Kind::Vector:
+        print(children[0], out);
+        out.append(" vector[").append(node->text).push_back(']');
+        break;
+    case Node::Kind::MemberPointer:
+        printLeft(children[1], out);
+        out.push_back(hasArray(children[1]) || hasFunction(children[1]) ? '(' : ' ');
+        print(children[0], out);
+        out.append("::*");
+        break;
+    case Node::Kind::Encoding:
+        if (children[1] != nullptr) {
+            printLeft(children[1], out);
+            if (!hasRightSide(children[1])) {
+                out.push_back(' ');
+            }
+        }
+        print(children[0], out);
+        break;
+    case Node::Kind::Prefixed:
+        out.append(node->text);
+        print(children[0], out);
+        break;
+    case Node::Kind::Suffixed:
+        print(children[0], out);
+        out.append(node->text);
+        break;
+    }
+}
+
+void printRight(const Node *node, std::string &out) {
+    if (out.size() > kMaxLength) {
+        return;
+    }
+    const auto &children = node->children;
+    switch (node->kind) {
+    case Node::Kind::Qualified: printRight(children[0], out); break;
+    case Node::Kind::Pointer: {
+        std::string_view declarator;
+        const Node *pointee = collapseReferences(node, declarator);
+        if (hasArray(pointee) || hasFunction(pointee)) {
+            out.push_back(')');
+        }
+        printRight(pointee, out);
+        break;
+    }
+    case Node::Kind::Function:
+        out.push_back('(');
+        printList(children, 1, out);
+        out.push_back(')');
+        printRight(children[0], out);
+        out.append(node->text);
+        break;
+    case Node::Kind::Array:
+        if (out.empty() || out.back() != ']') {
+            out.push_back(' ');
+        }
+        out.append("[").append(node->text).push_back(']');
+        printRight(children[0], out);
+        break;
+    case Node::Kind::MemberPointer:
+        if (hasArray(children[1]) || hasFunction(children[1])) {
+            out.push_back(')');
+        }
+        printRight(children[1], out);
+        break;
+    case Node::Kind::Encoding:
+        out.push_back('(');
+        printList(children, 2, out);
+        out.push_back(')');
+        if (children[1] != nullptr) {
+            printRight(children[1], out);
+        }
+        out.append(node->text);
+        break;
+    default: break;
+    }
+}
+
+void print(const Node *node, std::string &out) {
+    printLeft(node, out);
+    printRight(node, out);
+}
+
+std::string toString(const Node *node) {
+    std::string out;
+    print(node, out);
+    return out;
+}
+
+/// Recursive descent over the grammar of the Itanium C++ ABI, section 5.1,
+/// with the substitution and template parameter tables it requires.
+/// Every parse function returns null on malformed input.
+class Parser {
+public:
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    Node *parseEncoding();
+
+    bool atEnd() const { return position_ >= text_.size(); }
+    char look(size_t ahead = 0) const {
+        return position_ + ahead < text_.size() ? text_[position_ + ahead] : '\0';
+    }
+    std::string_view rest() const { return text_.substr(position_); }
+
+private:
+    /// What the name of an encoding says about its signature.
+    struct NameState {
+        bool endsWithTemplateArgs = false;
+        bool isConstructorOrConversion = false;
+        std::string qualifiers; ///< cv- and ref-qualifiers of a member function.
+    };
+
+    /// Bounds recursion on hostile input.
+    class Depth {
+    public:
+        explicit Depth(Parser &parser) : parser_(parser) { ++parser_.depth_; }
+        ~Depth() { --parser_.depth_; }
+        bool exceeded() const { return parser_.depth_ > 256; }
+
+    private:
+        Parser &parser_;
+    };
+
+    bool consume(char character) {
+        if (look() != character) {
+            return false;
+        }
+        ++position_;
+        return true;
+    }
+
+    bool consume(std::string_view prefix) {
+        if (rest().substr(0, prefix.size()) != prefix) {
+            return false;
+        }
+        position_ += prefix.size();
+        return true;
+    }
+
+    Node *make(Node::Kind kind, std::string text = {}, std::initializer_list<Node *> children = {}) {
+        nodes_.push_back({kind, std::move(text), children});
+        return &nodes_.back();
+    }
+
+    Node *name(std::string text) { return make(Node::Kind::Name, std::move(text)); }
+    Node *expandStandardName(Node *node);
+    Node *substitute(Node *node, const Node *pack, Node *element);
+
+    bool parseNumber(std::string &digits);
+    bool parseSeqID(size_t &id);
+    bool parseCallOffset();
+    std::string parseCVQualifiers();
+    void parseDiscriminator();
+
+    Node *parseSpecialName();
+    Node *parseName(NameState *state);
+    Node *parseNestedName(NameState *state);
+    Node *parseLocalName(NameState *state);
+    Node *parseUnscopedName(NameState *state, bool &isSubstitution);
+    Node *parseUnqualifiedName(NameState *state);
+    Node *parseSourceName();
+    Node *parseOperatorName(NameState *state);
+    Node *parseUnnamedTypeName();
+    Node *parseConstructorName(Node *scope, NameState *state);
+    Node *parseAbiTags(Node *node);
+    Node *parseSubstitution();
+    Node *parseTemplateParam();
+    Node *parseTemplateArgs(bool isOuter);
+    Node *parseTemplateArg();
+    Node *parseExpression();
+    Node *parseExprPrimary();
+    Node *parseType();
+    Node *parseBuiltinType();
+    Node *parseFunctionType();
+    Node *parseArrayType();
+
+    std::string_view text_;
+    size_t position_ = 0;
+    int depth_ = 0;
+    std::deque<Node> nodes_;
+    std::vector<Node *> substitutions_;
+    std::vector<Node *> templateParams_;
+    bool inLambdaSignature_ = false;
+};
+
+bool Parser::parseNumber(std::string &digits) {
+    digits.clear();
+    if (consume('n')) {
+        digits.push_back('-');
+    }
+    const size_t start = position_;
+    while (isDigit(look())) {
+        ++position_;
+    }
+    if (position_ == start) {
+        return false;
+    }
+    digits.append(text_.substr(start, position_ - start));
+    return true;
+}
+
+bool Parser::parseSeqID(size_t &id) {
+    id = 0;
+    const size_t start = position_;
+    for (;; ++position_) {
+        const char character = look();
+        if (isDigit(character)) {
+            id = id * 36 + static_cast<size_t>(character - '0');
+        } else if (character >= 'A' && character <= 'Z') {
+            id = id * 36 + static_cast<size_t>(character - 'A' + 10);
+        } else {
+            break;
+        }
+    }
+    return position_ > start;
+}
+
+bool Parser::parseCallOffset() {
+    std::string digits;
+    if (consume('h')) {
+        return parseNumber(digits) && consume('_');
+    }
+    if (consume('v')) {
+        return parseNumber(digits) && consume('_') && parseNumber(digits) && consume('_');
+    }
+    return false;
+}
+
+std::string Parser::parseCVQualifiers() {
+    const bool isRestrict = consume('r');
+    const bool isVolatile = consume('V');
+    const bool isConst = consume('K');
+    std::string qualifiers;
+    if (isConst) {
+        qualifiers.append(" const");
+    }
+    if (isVolatile) {
+        qualifiers.append(" volatile");
+    }
+    if (isRestrict) {
+        qualifiers.append(" restrict");
+    }
+    return qualifiers;
+}
+
+void Parser::parseDiscriminator() {
+    if (look() != '_') {
+        return;
+    }
+    if (isDigit(look(1))) {
+        position_ += 2;
+    } else if (look(1) == '_') {
+        position_ += 2;
+        while (isDigit(look())) {
+            ++position_;
+        }
+        consume('_');
+    }
+}
+
+Node *Parser::parseEncoding() {
+    Depth depth(*this);
+    if (depth.exceeded()) {
+        return nullptr;
+    }
+    if (look() == 'G' || look() == 'T') {
+        return parseSpecialName();
+    }
+
+    NameState state;
+    Node *entity = parseName(&state);
+    if (entity == nullptr) {
+        return nullptr;
+    }
+    if (atEnd() || look() == 'E' || look() == '.') {
+        return entity;
+    }
+
+    Node *encoding = make(Node::Kind::Encoding, state.qualifiers, {entity, nullptr});
+    if (state.endsWithTemplateArgs && !state.isConstructorOrConversion) {
+        encoding->children[1] = parseType();
+        if (encoding->children[1] == nullptr) {
+            return nullptr;
+        }
+    }
+    if (consume('v')) {
+        return atEnd() || look() == 'E' || look() == '.' ? encoding : nullptr;
+    }
+    while (!atEnd() && look() != 'E' && look() != '.') {
+        Node *parameter = parseType();
+        if (parameter == nullptr) {
+            return nullptr;
+        }
+        encoding->children.push_back(parameter);
+    }
+    return encoding;
+}
+
+Node *Parser::parseSpecialName() {
+    auto prefixed = [&](const char *prefix, Node *child) {
+        return child != nullptr ? make(Node::Kind::Prefixed, prefix, {child}) : nullptr;
+    };
+
+    if (consume('T')) {
+        switch (char kind = look(); kind) {
+        case 'V': ++position_; return prefixed("vtable for ", parseType());
+        case 'T': ++position_; return prefixed("VTT for ", parseType());
+        case 'I': ++position_; return prefixed("typeinfo for ", parseType());
+        case 'S': ++position_; return prefixed("typeinfo name for ", parseType());
+        case 'W': ++position_; return prefixed("thread-local wrapper routine for ", parseName(nullptr));
+        case 'H': ++position_; return prefixed("thread-local initialization routine for ", parseName(nullptr));
+        case 'h':
+        case 'v':
+            if (!parseCallOffset()) {
+                return nullptr;
+            }
+            return prefixed(kind == 'h' ? "non-virtual thunk to " : "virtual thunk to ", parseEncoding());
+        case 'c':
+            ++position_;
+            if (!parseCallOffset() || !parseCallOffset()) {
+                return nullptr;
+            }
+            return prefixed("covariant return thunk to ", parseEncoding());
+        case 'C': {
+            ++position_;
+            Node *derived = parseType();
+            std::string offset;
+            if (derived == nullptr || !parseNumber(offset) || !consume('_')) {
+                return nullptr;
+            }
+            Node *base = parseType();
+            if (base == nullptr) {
+                return nullptr;
+            }
+            return make(Node::Kind::Prefixed, "construction vtable for ",
+                        {make(Node::Kind::Suffixed, "-in-" + toString(derived), {base})});
+        }
+        default: return nullptr;
+        }
+    }
+
+    if (consume('G')) {
+        if (consume('V')) {
+            return prefixed("guard variable for ", parseName(nullptr));
+        }
+        if (consume('R')) {
+            Node *entity = parseName(nullptr);
+            size_t id = 0;
+            parseSeqID(id);
+            return consume('_') ? prefixed("reference temporary for ", entity) : nullptr;
+        }
+        if (consume("Tt") || consume("Tn")) {
+            return prefixed("transaction clone for ", parseEncoding());
+        }
+    }
+    return nullptr;
+}
+
+Node *Parser::parseName(NameState *state) {
+    Depth depth(*this);
+    if (depth.exceeded()) {
+        return nullptr;
+    }
+    if (look() == 'N') {
+        return parseNestedName(state);
+    }
+    if (look() == 'Z') {
+        return parseLocalName(state);
+    }
+
+    bool isSubstitution = false;
+    Node *result = parseUnscopedName(state, isSubstitution);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    if (look() == 'I') {
+        // An unscoped template name is a substitution candidate by itself.
+        if (!isSubstitution) {
+            substitutions_.push_back(result);
+        }
+        Node *arguments = parseTemplateArgs(state != nullptr);
+        if (arguments == nullptr) {
+            return nullptr;
+        }
+        if (state != nullptr) {
+            state->endsWithTemplateArgs = true;
+        }
+        return make(Node::Kind::Template, {}, {result, arguments});
+    }
+    return isSubstitution ? nullptr : result;
+}
+
+Node *Parser::parseNestedName(NameState *state) {
+    if (!consume('N')) {
+        return nullptr;
+    }
+    std::string qualifiers = parseCVQualifiers();
+    if (consume('O')) {
+        qualifiers.append(" &&");
+    } else if (consume('R')) {
+        qualifiers.append(" &");
+    }
+    if (state != nullptr) {
+        state->qualifiers = std::move(qualifiers);
+    }
+
+    Node *soFar = nullptr;
+    auto push = [&](Node *component) {
+        if (component == nullptr) {
+            return false;
+        }
+        soFar = soFar != nullptr ? make(Node::Kind::Nested, {}, {soFar, component}) : component;
+        if (state != nullptr) {
+            state->endsWithTemplateArgs = false;
+        }
+        return true;
+    };
+
+    if (consume("St")) {
+        soFar = name("std");
+    }
+    while (!consume('E')) {
+        if (atEnd()) {
+            return nullptr;
+        }
+        consume('L');
+        if (consume('M')) {
+            // Context of a lambda in a data member initializer.
+            if (soFar == nullptr) {
+                return nullptr;
+            }
+            continue;
+        }
+        if (look() == 'T') {
+            if (!push(parseTemplateParam())) {
+                return nullptr;
+            }
+        } else if (look() == 'I') {
+            Node *arguments = soFar != nullptr ? parseTemplateArgs(state != nullptr) : nullptr;
+            if (arguments == nullptr) {
+                return nullptr;
+            }
+            soFar = make(Node::Kind::Template, {}, {soFar, arguments});
+            if (state != nullptr) {
+                state->endsWithTemplateArgs = true;
+            }
+        } else if (look() == 'S' && look(1) != 't') {
+            Node *substitution = parseSubstitution();
+            if (substitution != nullptr && substitution->kind == Node::Kind::Name &&
+                (look() == 'C' || (look() == 'D' && isDigit(look(1))))) {
+                // Abbreviations are spelled out to scope their constructors.
+                substitution = expandStandardName(substitution);
+            }
+            const bool isFirst = soFar == nullptr;
+            if (!push(substitution)) {
+                return nullptr;
+            }
+            if (isFirst) {
+                continue;
+            }
+        } else if (look() == 'C' || (look() == 'D' && look(1) != 'C')) {
+            if (soFar == nullptr || !push(parseConstructorName(soFar, state))) {
+                return nullptr;
+            }
+            soFar = parseAbiTags(soFar);
+        } else if (!push(parseUnqualifiedName(state))) {
+            return nullptr;
+        }
+        substitutions_.push_back(soFar);
+    }
+
+    // The complete name is not a substitution candidate, only its prefixes.
+    if (soFar == nullptr || substitutions_.empty()) {
+        return nullptr;
+    }
+    substitutions_.pop_back();
+    return soFar;
+}
+
+Node *Parser::parseLocalName(NameState *state) {
+    if (!consume('Z')) {
+        return nullptr;
+    }
+    Node *encoding = parseEncoding();
+    if (encoding == nullptr || !consume('E')) {
+        return nullptr;
+    }
+
+    if (consume('s')) {
+        parseDiscriminator();
+        return make(Node::Kind::Local, {}, {encoding, name("string literal")});
+    }
+    if (consume('d')) {
+        std::string number;
+        parseNumber(number);
+        if (!consume('_')) {
+            return nullptr;
+        }
+    }
+
+    Node *entity = parseName(state);
+    if (entity == nullptr) {
+        return nullptr;
+    }
+    parseDiscriminator();
+    return make(Node::Kind::Local, {}, {encoding, entity});
+}
+
+Node *Parser::parseUnscopedName(NameState *state, bool &isSubstitution) {
+    if (consume("St")) {
+        Node *unqualified = parseUnqualifiedName(state);
+        return unqualified != nullptr ? make(Node::Kind::Nested, {}, {name("std"), unqualified}) : nullptr;
+    }
+    if (look() == 'S') {
+        isSubstitution = true;
+        return parseSubstitution();
+    }
+    return parseUnqualifiedName(state);
+}
+
+Node *Parser::parseUnqualifiedName(NameState *state) {
+    consume('L'); // internal linkage, in names GCC emits
+    Node *result = nullptr;
+    if (look() == 'U') {
+        result = parseUnnamedTypeName();
+    } else if (isDigit(look())) {
+        result = parseSourceName();
+    } else if (consume("DC")) {
+        // Structured binding: "[a, b]".
+        std::string text = "[";
+        while (!consume('E')) {
+            Node *binding = parseSourceName();
+            if (binding == nullptr) {
+                return nullptr;
+            }
+            if (text.size() > 1) {
+                text.append(", ");
+            }
+            text.append(binding->text);
+        }
+        result = name(text + "]");
+    } else {
+        result = parseOperatorName(state);
+    }
+    return result != nullptr ? parseAbiTags(result) : nullptr;
+}
+
+Node *Parser::parseSourceName() {
+    size_t length = 0;
+    const size_t start = position_;
+    while (isDigit(look())) {
+        length = length * 10 + static_cast<size_t>(look() - '0');
+        if (length > text_.size()) {
+            return nullptr;
+        }
+        ++position_;
+    }
+    if (position_ == start || length == 0 || length > text_.size() - position_) {
+        return nullptr;
+    }
+    const std::string_view identifier = text_.substr(position_, length);
+    position_ += length;
+    if (identifier.substr(0, 10) == "_GLOBAL__N") {
+        return name("(anonymous namespace)");
+    }
+    return name(std::string(identifier));
+}
+
+Node *Parser::parseOperatorName(NameState *state) {
+    struct Operator {
+        char code[3];
+        const char *symbol;
+    };
+    static const Operator kOperators[] = {
+        {"aN", "&="}, {"aS", "="}, {"aa", "&&"}, {"ad", "&"}, {"an", "&"}, {"aw", " co_await"},
+        {"cl", "()"}, {"cm", ","}, {"co", "~"}, {"dV", "/="}, {"da", " delete[]"}, {"de", "*"},
+        {"dl", " delete"}, {"dt", "."}, {"dv", "/"}, {"eO", "^="}, {"eo", "^"}, {"eq", "=="},
+        {"ge", ">="}, {"gt", ">"}, {"ix", "[]"}, {"lS", "<<="}, {"le", "<="}, {"ls", "<<"},
+        {"lt", "<"}, {"mI", "-="}, {"mL", "*="}, {"mi", "-"}, {"ml", "*"}, {"mm", "--"},
+        {"na", " new[]"}, {"ne", "!="}, {"ng", "-"}, {"nt", "!"}, {"nw", " new"}, {"oR", "|="},
+        {"oo", "||"}, {"or", "|"}, {"pL", "+="}, {"pl", "+"}, {"pm", "->*"}, {"pp", "++"},
+        {"ps", "+"}, {"pt", "->"}, {"qu", "?"}, {"rM", "%="}, {"rS", ">>="}, {"rm", "%"},
+        {"rs", ">>"}, {"ss", "<=>"},
+    };
+
+    if (consume("cv")) {
+        Node *type = parseType();
+        if (type == nullptr) {
+            return nullptr;
+        }
+        if (state != nullptr) {
+            state->isConstructorOrConversion = true;
+        }
+        return make(Node::Kind::Prefixed, "operator ", {type});
+    }
+    if (consume("li")) {
+        Node *suffix = parseSourceName();
+        return suffix != nullptr ? name("operator\"\" " + suffix->text) : nullptr;
+    }
+    if (look() == 'v' && isDigit(look(1))) {
+        position_ += 2;
+        Node *vendor = parseSourceName();
+        return vendor != nullptr ? name("operator " + vendor->text) : nullptr;
+    }
+    for (const auto &entry : kOperators) {
+        if (look() == entry.code[0] && look(1) == entry.code[1]) {
+            position_ += 2;
+            return name(std::string("operator") + entry.symbol);
+        }
+    }
+    return nullptr;
+}
+
+Node *Parser::parseUnnamedTypeName() {
+    std::string number;
+    if (consume("Ut")) {
+        parseNumber(number);
+        return consume('_') ? name("'unnamed" + number + "'") : nullptr;
+    }
+    if (!consume("Ul")) {
+        return nullptr;
+    }
+
+    // Parameters declared "auto" show up as template parameters the
+    // lambda itself introduces.
+    const bool wasInLambda = inLambdaSignature_;
+    inLambdaSignature_ = true;
+    std::vector<Node *> parameters;
+    if (!consume('v')) {
+        while (look() != 'E') {
+            Node *parameter = parseType();
+            if (parameter == nullptr) {
+                return nullptr;
+            }
+            parameters.push_back(parameter);
+        }
+    }
+    inLambdaSignature_ = wasInLambda;
+    if (!consume('E')) {
+        return nullptr;
+    }
+    parseNumber(number);
+    if (!consume('_')) {
+        return nullptr;
+    }
+
+    std::string text = "'lambda" + number + "'(";
+    printList(parameters, 0, text);
+    text.push_back(')');
+    return name(std::move(text));
+}
+
+Node *Parser::parseConstructorName(Node *scope, NameState *state) {
+    // The class name is the last component of the scope, without arguments.
+    const Node *last = scope;
+    while (last->kind != Node::Kind::Name) {
+        if (last->kind == Node::Kind::Nested) {
+            last = last->children[1];
+        } else if (last->kind == Node::Kind::Template || last->kind == Node::Kind::Suffixed) {
+            last = last->children[0];
+        } else {
+            return nullptr;
+        }
+    }
+    std::string base = last->text.substr(0, last->text.find('<'));
+    const size_t separator = base.rfind("::");
+    if (separator != std::string::npos) {
+        base.erase(0, separator + 2);
+    }
+
+    if (state != nullptr) {
+        state->isConstructorOrConversion = true;
+    }
+    if (consume('C')) {
+        const bool isInheriting = consume('I');
+        if (look() < '1' || look() > '5') {
+            return nullptr;
+        }
+        ++position_;
+        if (isInheriting && parseName(nullptr) == nullptr) {
+            return nullptr;
+        }
+        return name(base);
+    }
+    if (look() == 'D' && (look(1) == '0' || look(1) == '1' || look(1) == '2' || look(1) == '4' || look(1) == '5')) {
+        position_ += 2;
+        return name("~" + base);
+    }
+    return nullptr;
+}
+
+Node *Parser::parseAbiTags(Node *node) {
+    while (consume('B')) {
+        Node *tag = parseSourceName();
+        if (tag == nullptr) {
+            return nullptr;
+        }
+        node = make(Node::Kind::Suffixed, "[abi:" + tag->text + "]", {node});
+    }
+    return node;
+}
+
+Node *Parser::expandStandardName(Node *node) {
+    static const std::pair<const char *, const char *> kExpansions[] = {
+        {"std::string", "std::basic_string<char, std::char_traits<char>, std::allocator<char>>"},
+        {"std::istream", "std::basic_istream<char, std::char_traits<char>>"},
+        {"std::ostream", "std::basic_ostream<char, std::char_traits<char>>"},
+        {"std::iostream", "std::basic_iostream<char, std::char_traits<char>>"},
+    };
+    for (const auto &[abbreviation, expansion] : kExpansions) {
+        if (node->text == abbreviation) {
+            return name(expansion);
+        }
+    }
+    return node;
+}
+
+Node *Parser::substitute(Node *node, const Node *pack, Node *element) {
+    if (node == pack) {
+        return element;
+    }
+    if (node == nullptr || findPack(node) != pack) {
+        return node;
+    }
+    Node *copy = make(node->kind, node->text);
+    for (Node *child : node->children) {
+        copy->children.push_back(substitute(child, pack, element));
+    }
+    return copy;
+}
+
+Node *Parser::parseSubstitution() {
+    if (!consume('S')) {
+        return nullptr;
+    }
+    if (look() >= 'a' && look() <= 'z') {
+        const char *expansion = nullptr;
+        switch (look()) {
+        case 'a': expansion = "std::allocator"; break;
+        case 'b': expansion = "std::basic_string"; break;
+        case 's': expansion = "std::string"; break;
+        case 'i': expansion = "std::istream"; break;
+        case 'o': expansion = "std::ostream"; break;
+        case 'd': expansion = "std::iostream"; break;
+        default: return nullptr;
+        }
+        ++position_;
+        Node *special = name(expansion);
+        Node *tagged = parseAbiTags(special);
+        if (tagged != special) {
+            substitutions_.push_back(tagged);
+        }
+        return tagged;
+    }
+
+    if (consume('_')) {
+        return !substitutions_.empty() ? substitutions_[0] : nullptr;
+    }
+    size_t id = 0;
+    if (!parseSeqID(id) || !consume('_') || id + 1 >= substitutions_.size()) {
+        return nullptr;
+    }
+    return substitutions_[id + 1];
+}
+
+Node *Parser::parseTemplateParam() {
+    if (!consume('T')) {
+        return nullptr;
+    }
+    size_t index = 0;
+    if (!consume('_')) {
+        std::string digits;
+        if (!parseNumber(digits) || digits[0] == '-' || !consume('_')) {
+            return nullptr;
+        }
+        index = std::stoul(digits) + 1;
+    }
+    if (index < templateParams_.size()) {
+        return templateParams_[index];
+    }
+    return inLambdaSignature_ ? name("auto") : nullptr;
+}
+
+Node *Parser::parseTemplateArgs(bool isOuter) {
+    if (!consume('I')) {
+        return nullptr;
+    }
+    // Template parameters refer to the arguments of the entity's own name,
+    // as opposed to those of types named in its arguments or parameters.
+    if (isOuter) {
+        templateParams_.clear();
+    }
+    Node *arguments = make(Node::Kind::List);
+    while (!consume('E')) {
+        if (atEnd()) {
+            return nullptr;
+        }
+        std::vector<Node *> saved;
+        if (isOuter) {
+            saved = templateParams_;
+        }
+        Node *argument = parseTemplateArg();
+        if (isOuter) {
+            templateParams_ = std::move(saved);
+            templateParams_.push_back(argument);
+        }
+        if (argument == nullptr) {
+            return nullptr;
+        }
+        arguments->children.push_back(argument);
+    }
+    return arguments;
+}
+
+Node *Parser::parseTemplateArg() {
+    Depth depth(*this);
+    if (depth.exceeded()) {
+        return nullptr;
+    }
+    switch (look()) {
+    case 'X': {
+        ++position_;
+        Node *expression = parseExpression();
+        return expression != nullptr && consume('E') ? expression : nullptr;
+    }
+    case 'J': {
+        ++position_;
+        Node *pack = make(Node::Kind::List, "pack");
+        while (!consume('E')) {
+            Node *argument = atEnd() ? nullptr : parseTemplateArg();
+            if (argument == nullptr) {
+                return nullptr;
+            }
+            pack->children.push_back(argument);
+        }
+        return pack;
+    }
+    case 'L': return parseExprPrimary();
+    default: return parseType();
+    }
+}
+
+Node *Parser::parseExpression() {
+    if (look() == 'L') {
+        return parseExprPrimary();
+    }
+    if (look() == 'T') {
+        return parseTemplateParam();
+    }
+    if (consume("fp")) {
+        parseCVQualifiers();
+        std::string number;
+        parseNumber(number);
+        return consume('_') ? name(number.empty() ? "fp" : "fp" + number) : nullptr;
+    }
+    return nullptr;
+}
+
+Node *Parser::parseExprPrimary() {
+    if (!consume('L')) {
+        return nullptr;
+    }
+    if (look() == 'Z' || (look() == '_' && look(1) == 'Z')) {
+        consume('_');
+        ++position_;
+        Node *encoding = parseEncoding();
+        return encoding != nullptr && consume('E') ? encoding : nullptr;
+    }
+    if (consume("DnE")) {
+        return name("nullptr");
+    }
+
+    struct Literal {
+        char code;
+        const char *prefix;
+        const char *suffix;
+    };
+    static const Literal kLiterals[] = {
+        {'i', "", ""}, {'j', "", "u"}, {'l', "", "l"}, {'m', "", "ul"}, {'x', "", "ll"},
+        {'y', "", "ull"}, {'s', "(short)", ""}, {'t', "(unsigned short)", ""}, {'c', "(char)", ""},
+        {'a', "(signed char)", ""}, {'h', "(unsigned char)", ""}, {'w', "(wchar_t)", ""},
+        {'n', "(__int128)", ""}, {'o', "(unsigned __int128)", ""},
+    };
+
+    std::string digits;
+    if (consume('b')) {
+        if (!parseNumber(digits) || !consume('E')) {
+            return nullptr;
+        }
+        return name(digits == "0" ? "false" : digits == "1" ? "true" : "(bool)" + digits);
+    }
+    for (const auto &literal : kLiterals) {
+        if (look() == literal.code) {
+            ++position_;
+            if (!parseNumber(digits) || !consume('E')) {
+                return nullptr;
+            }
+            return name(literal.prefix + digits + literal.suffix);
+        }
+    }
+    if (look() == 'f' || look() == 'd' || look() == 'e' || look() == 'g') {
+        return nullptr; // floating point literals are written as hex images
+    }
+
+    Node *type = parseType();
+    if (type == nullptr || !parseNumber(digits) || !consume('E')) {
+        return nullptr;
+    }
+    return name("(" + toString(type) + ")" + digits);
+}
+
+Node *Parser::parseBuiltinType() {
+    static const char *const kLetters[26] = {
+        "signed char", "bool", "char", "double", "long double", "float", "__float128", "unsigned char",
+        "int", "unsigned int", nullptr, "long", "unsigned long", "__int128", "unsigned __int128", nullptr,
+        nullptr, nullptr, "short", "unsigned short", nullptr, "void", "wchar_t", "long long",
+        "unsigned long long", "...",
+    };
+    const char letter = look();
+    if (letter >= 'a' && letter <= 'z' && kLetters[letter - 'a'] != nullptr) {
+        ++position_;
+        return name(kLetters[letter - 'a']);
+    }
+    if (letter != 'D') {
+        return nullptr;
+    }
+
+    switch (look(1)) {
+    case 'd': position_ += 2; return name("decimal64");
+    case 'e': position_ += 2; return name("decimal128");
+    case 'f': position_ += 2; return name("decimal32");
+    case 'h': position_ += 2; return name("half");
+    case 'i': position_ += 2; return name("char32_t");
+    case 's': position_ += 2; return name("char16_t");
+    case 'u': position_ += 2; return name("char8_t");
+    case 'a': position_ += 2; return name("auto");
+    case 'c': position_ += 2; return name("decltype(auto)");
+    case 'n': position_ += 2; return name("std::nullptr_t");
+    case 'F': {
+        position_ += 2;
+        std::string digits;
+        return parseNumber(digits) && consume('_') ? name("_Float" + digits) : nullptr;
+    }
+    default: return nullptr;
+    }
+}
+
+Node *Parser::parseType() {
+    Depth depth(*this);
+    if (depth.exceeded()) {
+        return nullptr;
+    }
+
+    Node *result = nullptr;
+    switch (look()) {
+    case 'r':
+    case 'V':
+    case 'K': {
+        size_t after = 0;
+        while (look(after) == 'r' || look(after) == 'V' || look(after) == 'K') {
+            ++after;
+        }
+        if (look(after) == 'F' || (look(after) == 'D' && (look(after + 1) == 'o' || look(after + 1) == 'x'))) {
+            result = parseFunctionType();
+            break;
+        }
+        std::string qualifiers = parseCVQualifiers();
+        Node *type = parseType();
+        if (type == nullptr) {
+            return nullptr;
+        }
+        result = make(Node::Kind::Qualified, std::move(qualifiers), {type});
+        break;
+    }
+    case 'F': result = parseFunctionType(); break;
+    case 'A': result = parseArrayType(); break;
+    case 'M': {
+        ++position_;
+        Node *scope = parseType();
+        Node *member = scope != nullptr ? parseType() : nullptr;
+        if (member == nullptr) {
+            return nullptr;
+        }
+        result = make(Node::Kind::MemberPointer, {}, {scope, member});
+        break;
+    }
+    case 'P':
+    case 'R':
+    case 'O': {
+        const char *declarator = look() == 'P' ? "*" : look() == 'R' ? "&" : "&&";
+        ++position_;
+        Node *pointee = parseType();
+        if (pointee == nullptr) {
+            return nullptr;
+        }
+        result = make(Node::Kind::Pointer, declarator, {pointee});
+        break;
+    }
+    case 'C':
+    case 'G': {
+        const char *suffix = look() == 'C' ? " complex" : " imaginary";
+        ++position_;
+        Node *type = parseType();
+        if (type == nullptr) {
+            return nullptr;
+        }
+        result = make(Node::Kind::Suffixed, suffix, {type});
+        break;
+    }
+    case 'T': {
+        if (look(1) == 's' || look(1) == 'u' || look(1) == 'e') {
+            position_ += 2;
+            result = parseName(nullptr);
+            break;
+        }
+        result = parseTemplateParam();
+        if (result == nullptr) {
+            return nullptr;
+        }
+        if (look() == 'I') {
+            substitutions_.push_back(result);
+            Node *arguments = parseTemplateArgs(false);
+            if (arguments == nullptr) {
+                return nullptr;
+            }
+            result = make(Node::Kind::Template, {}, {result, arguments});
+        }
+        break;
+    }
+    case 'u': {
+        ++position_;
+        result = parseSourceName();
+        break;
+    }
+    case 'D':
+        if (look(1) == 'p') {
+            position_ += 2;
+            Node *pattern = parseType();
+            if (pattern == nullptr) {
+                return nullptr;
+            }
+            // Expands to one copy of the pattern per element of the pack it names.
+            const Node *pack = findPack(pattern);
+            if (pack == nullptr) {
+                result = make(Node::Kind::Suffixed, "...", {pattern});
+                break;
+            }
+            result = make(Node::Kind::List);
+            for (Node *element : pack->children) {
+                result->children.push_back(substitute(pattern, pack, element));
+            }
+            break;
+        }
+        if (look(1) == 'v') {
+            position_ += 2;
+            std::string dimension;
+            if (!parseNumber(dimension) || !consume('_')) {
+                return nullptr;
+            }
+            Node *element = parseType();
+            if (element == nullptr) {
+                return nullptr;
+            }
+            result = make(Node::Kind::Vector, dimension, {element});
+            break;
+        }
+        if (look(1) == 'o' || look(1) == 'x') {
+            result = parseFunctionType();
+            break;
+        }
+        return parseBuiltinType();
+    case 'S':
+        if (look(1) != 't') {
+            bool isSubstitution = false;
+            result = parseUnscopedName(nullptr, isSubstitution);
+            if (result == nullptr) {
+                return nullptr;
+            }
+            if (look() == 'I') {
+                if (!isSubstitution) {
+                    substitutions_.push_back(result);
+                }
+                Node *arguments = parseTemplateArgs(false);
+                if (arguments == nullptr) {
+                    return nullptr;
+                }
+                result = make(Node::Kind::Template, {}, {result, arguments});
+            } else if (isSubstitution) {
+                return result;
+            }
+            break;
+        }
+        result = parseName(nullptr);
+        break;
+    default:
+        if (look() >= 'a' && look() <= 'z') {
+            return parseBuiltinType();
+        }
+        result = parseName(nullptr);
+        break;
+    }
+
+    if (result != nullptr) {
+        substitutions_.push_back(result);
+    }
+    return result;
+}
+
+Node *Parser::parseFunctionType() {
+    std::string suffix = parseCVQualifiers();
+    if (consume("Do")) {
+        suffix.append(" noexcept");
+    }
+    consume("Dx");
+    if (!consume('F')) {
+        return nullptr;
+    }
+    consume('Y');
+
+    Node *returnType = parseType();
+    if (returnType == nullptr) {
+        return nullptr;
+    }
+    Node *function = make(Node::Kind::Function, {}, {returnType});
+    std::string reference;
+    while (!consume('E')) {
+        if (consume('v')) {
+            continue;
+        }
+        if ((look() == 'R' || look() == 'O') && look(1) == 'E') {
+            reference = look() == 'R' ? " &" : " &&";
+            position_ += 2;
+            break;
+        }
+        Node *parameter = atEnd() ? nullptr : parseType();
+        if (parameter == nullptr) {
+            return nullptr;
+        }
+        function->children.push_back(parameter);
+    }
+
+    // Printed after the parameters: qualifiers, then ref-qualifier, then noexcept.
+    const size_t noexceptAt = suffix.find(" noexcept");
+    if (noexceptAt != std::string::npos) {
+        suffix.insert(noexceptAt, reference);
+    } else {
+        suffix.append(reference);
+    }
+    function->text = std::move(suffix);
+    return function;
+}
+
+Node *Parser::parseArrayType() {
+    if (!consume('A')) {
+        return nullptr;
+    }
+    std::string dimension;
+    if (isDigit(look())) {
+        parseNumber(dimension);
+    } else if (look() != '_') {
+        Node *expression = parseExpression();
+        if (expression == nullptr) {
+            return nullptr;
+        }
+        dimension = toString(expression);
+    }
+    if (!consume('_')) {
+        return nullptr;
+    }
+    Node *element = parseType();
+    return element != nullptr ? make(Node::Kind::Array, dimension, {element}) : nullptr;
+}
+
+} // namespace
+
+bool demangleItanium(std::string_view mangled, std::string &out) {
+    // "___Z<encoding>_block_invoke[_<n>]": a block literal in a C++ function.
+    if (mangled.substr(0, 4) == "___Z") {
+        const size_t block = mangled.find("_block_invoke");
+        std::string function;
+        if (block == std::string_view::npos || !demangleItanium(mangled.substr(2, block - 2), function)) {
+            return false;
+        }
+        out = "invocation function for block in " + function;
+        return true;
+    }
+
+    if (mangled.substr(0, 3) == "__Z") {
+        mangled.remove_prefix(1);
+    }
+    if (mangled.substr(0, 2) != "_Z") {
+        return false;
+    }
+
+    Parser parser(mangled.substr(2));
+    const Node *encoding = parser.parseEncoding();
+    if (encoding == nullptr) {
+        return false;
+    }
+    // Vendor suffixes such as ".cold.1" of outlined code.
+    const std::string_view suffix = parser.rest();
+    if (!suffix.empty() && suffix.front() != '.') {
+        return false;
+    }
+
+    std::string result;
+    print(encoding, result);
+    if (result.size() > kMaxLength) {
+        return false;
+    }
+    if (!suffix.empty()) {
+        result.append(" (").append(suffix).push_back(')');
+    }
+    out = std::move(result);
+    return true;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,26 @@
+//
+//  itanium_demangler.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_ITANIUM_DEMANGLER_HPP
+#define SYMBOLICATOR_ITANIUM_DEMANGLER_HPP
+
+#include <string>
+#include <string_view>
+
+namespace symbolicator {
+
+/// Demangles an Itanium C++ ABI name ("_Z...", with or without the extra
+/// leading underscore of Mach-O symbols, and "___Z..._block_invoke") into
+/// the form LLVM's demangler, and so atos, prints. Returns false and
+/// leaves `out` alone for names it does not recognize or cannot fully
+/// parse; template argument expressions beyond literals are not supported.
+bool demangleItanium(std::string_view mangled, std::string &out);
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,343 @@
+//
+//  json_reader.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "json_reader.hpp"
+
+#include "error.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+constexpr size_t kMaximumDepth = 512;
+
+bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+int hexValue(char character) {
+    if (character >= '0' && character <= '9') {
+        return character - '0';
+    }
+    if (character >= 'a' && character <= 'f') {
+        return character - 'a' + 10;
+    }
+    if (character >= 'A' && character <= 'F') {
+        return character - 'A' + 10;
+    }
+    return -1;
+}
+
+void appendUTF8(std::string &out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+}
+
+} // namespace
+
+void JSONReader::fail(const char *message) const {
+    throwBadFormat("invalid JSON at offset " + std::to_string(cursor_) + ": " + message);
+}
+
+char JSONReader::skipWhitespace() {
+    while (cursor_ < text_.size()) {
+        const char character = text_[cursor_];
+        if (character != ' ' && character != '\n' && character != '\r' && character != '\t') {
+            return character;
+        }
+        ++cursor_;
+    }
+    return '\0';
+}
+
+void JSONReader::expect(char character) {
+    if (skipWhitespace() != character || cursor_ >= text_.size()) {
+        const char message[] = {'e', 'x', 'p', 'e', 'c', 't', 'e', 'd', ' ', '\'', character, '\'', '\0'};
+        fail(message);
+    }
+    ++cursor_;
+}
+
+JSONReader::Type JSONReader::peek() {
+    const char character = skipWhitespace();
+    if (cursor_ >= text_.size()) {
+        fail("unexpected end of document");
+    }
+    switch (character) {
+    case 'n': return Type::Null;
+    case 't':
+    case 'f': return Type::Boolean;
+    case '"': return Type::String;
+    case '[': return Type::Array;
+    case '{': return Type::Object;
+    default:
+        if (character == '-' || isDigit(character)) {
+            return Type::Number;
+        }
+        fail("unexpected character");
+    }
+}
+
+void JSONReader::beginObject() {
+    expect('{');
+    needsComma_.push_back(false);
+}
+
+bool JSONReader::nextKey(std::string_view &key) {
+    if (needsComma_.empty()) {
+        fail("not inside an object");
+    }
+    if (skipWhitespace() == '}') {
+        ++cursor_;
+        needsComma_.pop_back();
+        return false;
+    }
+    if (needsComma_.back()) {
+        expect(',');
+    }
+    needsComma_.back() = true;
+    key = string();
+    expect(':');
+    return true;
+}
+
+void JSONReader::beginArray() {
+    expect('[');
+    needsComma_.push_back(false);
+}
+
+bool JSONReader::nextElement() {
+    if (needsComma_.empty()) {
+        fail("not inside an array");
+    }
+    if (skipWhitespace() == ']') {
+        ++cursor_;
+        needsComma_.pop_back();
+        return false;
+    }
+    if (needsComma_.back()) {
+        expect(',');
+    }
+    needsComma_.back() = true;
+    return true;
+}
+
+std::string_view JSONReader::string() {
+    expect('"');
+    const size_t start = cursor_;
+    while (cursor_ < text_.size() && text_[cursor_] != '"' && text_[cursor_] != '\\') {
+        if (static_cast<unsigned char>(text_[cursor_]) < 0x20) {
+            fail("control character in string");
+        }
+        ++cursor_;
+    }
+    if (cursor_ >= text_.size()) {
+        fail("unterminated string");
+    }
+    if (text_[cursor_] == '"') {
+        return text_.substr(start, cursor_++ - start);
+    }
+
+    // Escaped strings are decoded into the scratch buffer.
+    scratch_.assign(text_.data() + start, cursor_ - start);
+    while (true) {
+        if (cursor_ >= text_.size()) {
+            fail("unterminated string");
+        }
+        const char character = text_[cursor_++];
+        if (character == '"') {
+            return scratch_;
+        }
+        if (static_cast<unsigned char>(character) < 0x20) {
+            fail("control character in string");
+        }
+        if (character != '\\') {
+            scratch_.push_back(character);
+            continue;
+        }
+        if (cursor_ >= text_.size()) {
+            fail("unterminated escape");
+        }
+        switch (text_[cursor_++]) {
+        case '"': scratch_.push_back('"'); break;
+        case '\\': scratch_.push_back('\\'); break;
+        case '/': scratch_.push_back('/'); break;
+        case 'b': scratch_.push_back('\b'); break;
+        case 'f': scratch_.push_back('\f'); break;
+        case 'n': scratch_.push_back('\n'); break;
+        case 'r': scratch_.push_back('\r'); break;
+        case 't': scratch_.push_back('\t'); break;
+        case 'u': {
+            auto unit = [&] {
+                if (cursor_ + 4 > text_.size()) {
+                    fail("truncated \\u escape");
+                }
+                uint32_t value = 0;
+                for (int index = 0; index < 4; ++index) {
+                    const int digit = hexValue(text_[cursor_++]);
+                    if (digit < 0) {
+                        fail("invalid \\u escape");
+                    }
+                    value = (value << 4) | static_cast<uint32_t>(digit);
+                }
+                return value;
+            };
+            uint32_t codePoint = unit();
+            if (codePoint >= 0xd800 && codePoint <= 0xdbff && text_.substr(cursor_, 2) == "\\u") {
+                const size_t pair = cursor_;
+                cursor_ += 2;
+                const uint32_t low = unit();
+                if (low >= 0xdc00 && low <= 0xdfff) {
+                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                } else {
+                    cursor_ = pair;
+                }
+            }
+            // Unpaired surrogates cannot be encoded; use the replacement character.
+            appendUTF8(scratch_, codePoint >= 0xd800 && codePoint <= 0xdfff ? 0xfffd : codePoint);
+            break;
+        }
+        default: fail("invalid escape");
+        }
+    }
+}
+
+std::string_view JSONReader::number() {
+    skipWhitespace();
+    const size_t start = cursor_;
+    auto digits = [&] {
+        const size_t first = cursor_;
+        while (cursor_ < text_.size() && isDigit(text_[cursor_])) {
+            ++cursor_;
+        }
+        if (cursor_ == first) {
+            fail("expected digit");
+        }
+    };
+
+    if (cursor_ < text_.size() && text_[cursor_] == '-') {
+        ++cursor_;
+    }
+    digits();
+    if (cursor_ < text_.size() && text_[cursor_] == '.') {
+        ++cursor_;
+        digits();
+    }
+    if (cursor_ < text_.size() && (text_[cursor_] == 'e' || text_[cursor_] == 'E')) {
+        ++cursor_;
+        if (cursor_ < text_.size() && (text_[cursor_] == '+' || text_[cursor_] == '-')) {
+            ++cursor_;
+        }
+        digits();
+    }
+    return text_.substr(start, cursor_ - start);
+}
+
+int64_t JSONReader::integer() {
+    const std::string_view value = number();
+    const bool negative = value.front() == '-';
+    uint64_t magnitude = 0;
+    for (size_t index = negative ? 1 : 0; index < value.size() && isDigit(value[index]); ++index) {
+        magnitude = magnitude * 10 + static_cast<uint64_t>(value[index] - '0');
+    }
+    return static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
+}
+
+bool JSONReader::boolean() {
+    skipWhitespace();
+    if (text_.substr(cursor_, 4) == "true") {
+        cursor_ += 4;
+        return true;
+    }
+    if (text_.substr(cursor_, 5) == "false") {
+        cursor_ += 5;
+        return false;
+    }
+    fail("expected boolean");
+}
+
+void JSONReader::null() {
+    skipWhitespace();
+    if (text_.substr(cursor_, 4) != "null") {
+        fail("expected null");
+    }
+    cursor_ += 4;
+}
+
+std::string_view JSONReader::text() {
+    switch (peek()) {
+    case Type::String: return string();
+    case Type::Number: return number();
+    case Type::Boolean: return boolean() ? "true" : "false";
+    case Type::Null: null(); return std::string_view();
+    case Type::Array:
+    case Type::Object: skip(); return std::string_view();
+    }
+    return std::string_view();
+}
+
+void JSONReader::skip() {
+    skip(0);
+}
+
+void JSONReader::skip(size_t depth) {
+    if (depth > kMaximumDepth) {
+        fail("nesting too deep");
+    }
+    switch (peek()) {
+    case Type::Object: {
+        beginObject();
+        std::string_view key;
+        while (nextKey(key)) {
+            skip(depth + 1);
+        }
+        break;
+    }
+    case Type::Array:
+        beginArray();
+        while (nextElement()) {
+            skip(depth + 1);
+        }
+        break;
+    case Type::String: {
+        // Skipped strings only need their end found, not decoding.
+        ++cursor_;
+        while (cursor_ < text_.size() && text_[cursor_] != '"') {
+            cursor_ += text_[cursor_] == '\\' ? 2 : 1;
+        }
+        if (cursor_ >= text_.size()) {
+            fail("unterminated string");
+        }
+        ++cursor_;
+        break;
+    }
+    case Type::Number: number(); break;
+    case Type::Boolean: boolean(); break;
+    case Type::Null: null(); break;
+    }
+}
+
+bool JSONReader::atEnd() {
+    skipWhitespace();
+    return cursor_ >= text_.size();
+}
+
+} // namespace symbolicator
@@ -0,0 +1,97 @@
+//
+//  json_reader.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_JSON_READER_HPP
+#define SYMBOLICATOR_JSON_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace symbolicator {
+
+/// Streaming pull reader over a JSON document held in memory.
+///
+/// Values are consumed in document order and nothing is built for them:
+/// callers descend into the members they want and `skip` the rest, so a
+/// large document is read without allocating per value. Malformed input
+/// throws `Error` with SYMBOLICATOR_E_BAD_FORMAT.
+class JSONReader {
+public:
+    enum class Type {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    explicit JSONReader(std::string_view text) : text_(text) {}
+
+    /// Type of the next value, without consuming it.
+    Type peek();
+
+    /// Enters an object; iterate its members with `nextKey`.
+    void beginObject();
+    /// Reads the next member name, or consumes the closing brace and returns
+    /// false. The member's value must be consumed before the next call.
+    bool nextKey(std::string_view &key);
+
+    /// Enters an array; iterate it with `nextElement`.
+    void beginArray();
+    /// Returns true when another element follows, or consumes the closing
+    /// bracket and returns false.
+    bool nextElement();
+
+    /// Unescaped string value. Points into the document when the string has
+    /// no escapes, otherwise into a buffer reused by the next string read.
+    std::string_view string();
+    /// Number as written in the document.
+    std::string_view number();
+    /// Integral part of a number, two's complement for values past INT64_MAX.
+    int64_t integer();
+    bool boolean();
+    void null();
+
+    /// Any scalar as text, the way it would be printed: strings unescaped,
+    /// numbers verbatim, "true"/"false", and "" for null. Containers are
+    /// skipped and read as "".
+    std::string_view text();
+
+    /// Consumes the next value, whatever it is.
+    void skip();
+
+    /// Whether only whitespace is left.
+    bool atEnd();
+
+    /// Byte offset of the cursor in the document.
+    size_t offset() const { return cursor_; }
+
+    /// Whether `value` points into the document rather than the scratch buffer.
+    bool borrows(std::string_view value) const {
+        return value.data() >= text_.data() && value.data() + value.size() <= text_.data() + text_.size();
+    }
+
+private:
+    char skipWhitespace();
+    void expect(char character);
+    void skip(size_t depth);
+    [[noreturn]] void fail(const char *message) const;
+
+    std::string_view text_;
+    size_t cursor_ = 0;
+    std::string scratch_;
+    std::vector<bool> needsComma_; ///< One entry per open container.
+};
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,117 @@
+//
+//  json_writer.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "json_writer.hpp"
+
+#include <charconv>
+
+namespace symbolicator {
+
+void appendJSONString(std::string &out, std::string_view value) {
+    static const char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    size_t run = 0;
+    for (size_t index = 0; index < value.size(); ++index) {
+        const unsigned char character = static_cast<unsigned char>(value[index]);
+        if (character >= 0x20 && character != '"' && character != '\\') {
+            continue;
+        }
+        // Unescaped runs are copied in one go.
+        out.append(value.data() + run, index - run);
+        run = index + 1;
+        switch (character) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            out.append("\\u00");
+            out.push_back(kHex[character >> 4]);
+            out.push_back(kHex[character & 0xf]);
+        }
+    }
+    out.append(value.data() + run, value.size() - run);
+    out.push_back('"');
+}
+
+JSONWriter &JSONWriter::key(std::string_view name) {
+    separate();
+    appendJSONString(out_, name);
+    out_.push_back(':');
+    afterKey_ = true;
+    return *this;
+}
+
+JSONWriter &JSONWriter::string(std::string_view value) {
+    separate();
+    appendJSONString(out_, value);
+    return *this;
+}
+
+JSONWriter &JSONWriter::string(const char *value) {
+    return value != nullptr ? string(std::string_view(value)) : null();
+}
+
+JSONWriter &JSONWriter::boolean(bool value) {
+    separate();
+    out_.append(value ? "true" : "false");
+    return *this;
+}
+
+JSONWriter &JSONWriter::null() {
+    separate();
+    out_.append("null");
+    return *this;
+}
+
+JSONWriter &JSONWriter::raw(std::string_view json) {
+    separate();
+    out_.append(json.data(), json.size());
+    return *this;
+}
+
+JSONWriter &JSONWriter::open(char bracket) {
+    separate();
+    out_.push_back(bracket);
+    first_ = true;
+    return *this;
+}
+
+JSONWriter &JSONWriter::close(char bracket) {
+    out_.push_back(bracket);
+    first_ = false;
+    return *this;
+}
+
+JSONWriter &JSONWriter::signedNumber(int64_t value) {
+    separate();
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out_.append(digits, static_cast<size_t>(result.ptr - digits));
+    return *this;
+}
+
+JSONWriter &JSONWriter::unsignedNumber(uint64_t value) {
+    separate();
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out_.append(digits, static_cast<size_t>(result.ptr - digits));
+    return *this;
+}
+
+void JSONWriter::separate() {
+    if (afterKey_) {
+        afterKey_ = false;
+    } else if (!first_) {
+        out_.push_back(',');
+    }
+    first_ = false;
+}
+
+} // namespace symbolicator
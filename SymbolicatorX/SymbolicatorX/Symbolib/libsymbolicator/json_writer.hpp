@@ -0,0 +1,83 @@
+//
+//  json_writer.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_JSON_WRITER_HPP
+#define SYMBOLICATOR_JSON_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace symbolicator {
+
+/// Appends `value` as a quoted JSON string, escaping quotes, backslashes and
+/// control characters. Other bytes, UTF-8 included, are copied as they are.
+void appendJSONString(std::string &out, std::string_view value);
+
+/// Streams JSON text straight into a string, without building a document
+/// first. Callers nest `begin`/`end` calls and put a `key` before each
+/// member of an object; the writer only places the commas and colons, so
+/// the output is valid JSON when the calls are balanced.
+class JSONWriter {
+public:
+    explicit JSONWriter(std::string &out) : out_(out) {}
+
+    JSONWriter &beginObject() { return open('{'); }
+    JSONWriter &endObject() { return close('}'); }
+    JSONWriter &beginArray() { return open('['); }
+    JSONWriter &endArray() { return close(']'); }
+
+    JSONWriter &key(std::string_view name);
+
+    JSONWriter &string(std::string_view value);
+    /// `null` for a null `value`.
+    JSONWriter &string(const char *value);
+    JSONWriter &boolean(bool value);
+    JSONWriter &null();
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, JSONWriter &> number(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            return signedNumber(static_cast<int64_t>(value));
+        } else {
+            return unsignedNumber(static_cast<uint64_t>(value));
+        }
+    }
+
+    /// Writes `json`, which must be one complete JSON value, as it is.
+    JSONWriter &raw(std::string_view json);
+
+    /// `key` followed by a value, for the common case of a scalar member.
+    template <typename T>
+    JSONWriter &field(std::string_view name, const T &value) {
+        key(name);
+        if constexpr (std::is_same_v<T, bool>) {
+            return boolean(value);
+        } else if constexpr (std::is_integral_v<T>) {
+            return number(value);
+        } else {
+            return string(value);
+        }
+    }
+
+private:
+    JSONWriter &open(char bracket);
+    JSONWriter &close(char bracket);
+    JSONWriter &signedNumber(int64_t value);
+    JSONWriter &unsignedNumber(uint64_t value);
+    void separate();
+
+    std::string &out_;
+    bool first_ = true;     ///< No value yet in the innermost container.
+    bool afterKey_ = false; ///< The next value belongs to the key just written.
+};
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,381 @@
+//
+//  macho_file.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "macho_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "error.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+constexpr uint32_t kMachMagic = 0xfeedface;
+constexpr uint32_t kMachMagic64 = 0xfeedfacf;
+constexpr uint32_t kFatMagic = 0xcafebabe;
+constexpr uint32_t kFatMagic64 = 0xcafebabf;
+constexpr size_t kFatArchSize = 20;
+constexpr size_t kFatArch64Size = 32;
+constexpr size_t kMachHeader64Size = 32;
+/// Enough for the fat header of any universal binary seen in practice.
+constexpr uint64_t kHeaderProbeSize = 4096;
+
+constexpr uint32_t kLoadCommandSegment = 0x1;
+constexpr uint32_t kLoadCommandSymtab = 0x2;
+constexpr uint32_t kLoadCommandUUID = 0x1b;
+constexpr uint32_t kLoadCommandSegment64 = 0x19;
+
+constexpr uint32_t kCpuArch64 = 0x01000000;
+constexpr uint32_t kCpuArch64_32 = 0x02000000;
+constexpr uint32_t kCpuTypeX86 = 7;
+constexpr uint32_t kCpuTypeARM = 12;
+constexpr uint32_t kCpuSubtypeMask = 0x00ffffff;
+
+constexpr uint8_t kStabMask = 0xe0;
+constexpr uint8_t kTypeMask = 0x0e;
+constexpr uint8_t kTypeSection = 0x0e;
+
+struct ArchitectureName {
+    const char *name;
+    uint32_t type;
+    uint32_t subtype;
+};
+
+constexpr ArchitectureName kArchitectureNames[] = {
+    {"i386", kCpuTypeX86, 3},
+    {"x86", kCpuTypeX86, 3},
+    {"x86_64", kCpuTypeX86 | kCpuArch64, 3},
+    {"x86_64h", kCpuTypeX86 | kCpuArch64, 8},
+    {"arm64", kCpuTypeARM | kCpuArch64, 0},
+    {"arm64e", kCpuTypeARM | kCpuArch64, 2},
+    {"arm64_32", kCpuTypeARM | kCpuArch64_32, 1},
+    {"arm", kCpuTypeARM, 0},
+    {"armv6", kCpuTypeARM, 6},
+    {"armv7", kCpuTypeARM, 9},
+    {"armv7f", kCpuTypeARM, 10},
+    {"armv7s", kCpuTypeARM, 11},
+    {"armv7k", kCpuTypeARM, 12},
+    {"armv6m", kCpuTypeARM, 14},
+    {"armv7m", kCpuTypeARM, 15},
+    {"armv7em", kCpuTypeARM, 16},
+};
+
+uint32_t bigEndian32(const uint8_t *bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+uint64_t bigEndian64(const uint8_t *bytes) {
+    return (static_cast<uint64_t>(bigEndian32(bytes)) << 32) | bigEndian32(bytes + 4);
+}
+
+std::string_view fixedString(DataReader &reader, size_t capacity) {
+    const char *characters = reinterpret_cast<const char *>(reader.current());
+    reader.skip(capacity); // before reading, so a truncated command throws
+    return std::string_view(characters, strnlen(characters, capacity));
+}
+
+bool sameSubtype(uint32_t lhs, uint32_t rhs) {
+    return (lhs & kCpuSubtypeMask) == (rhs & kCpuSubtypeMask);
+}
+
+/// One fat_arch or fat_arch_64 entry: where a slice lives in the file.
+struct FatSlice {
+    CpuArchitecture architecture;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+/// Reads the slice table of a universal file from its first pages only.
+/// Returns false, leaving `slices` empty, when `path` is a thin file.
+bool readFatSlices(const std::string &path, std::vector<FatSlice> &slices) {
+    MappedFile header = MappedFile::open(path, 0, kHeaderProbeSize);
+    if (header.size() < sizeof(uint32_t)) {
+        throwBadFormat(path + ": not a Mach-O file");
+    }
+    const uint32_t magic = bigEndian32(header.data());
+    if (magic != kFatMagic && magic != kFatMagic64) {
+        return false;
+    }
+
+    const bool wide = magic == kFatMagic64;
+    const uint64_t entrySize = wide ? kFatArch64Size : kFatArchSize;
+    const uint64_t count = header.size() >= 8 ? bigEndian32(header.data() + 4) : 0;
+    const uint64_t tableSize = 8 + count * entrySize;
+    if (tableSize > header.size()) {
+        header = MappedFile::open(path, 0, tableSize);
+    }
+    if (tableSize > header.size()) {
+        throwBadFormat(path + ": truncated fat header");
+    }
+
+    slices.resize(static_cast<size_t>(count));
+    for (size_t index = 0; index < slices.size(); ++index) {
+        const uint8_t *entry = header.data() + 8 + index * entrySize;
+        FatSlice &slice = slices[index];
+        slice.architecture.type = bigEndian32(entry);
+        slice.architecture.subtype = bigEndian32(entry + 4);
+        slice.offset = wide ? bigEndian64(entry + 8) : bigEndian32(entry + 8);
+        slice.size = wide ? bigEndian64(entry + 16) : bigEndian32(entry + 12);
+    }
+    return true;
+}
+
+/// Maps one slice, and nothing else, of a universal file.
+MappedFile mapSlice(const std::string &path, const FatSlice &slice) {
+    MappedFile mapping = MappedFile::open(path, slice.offset, slice.size);
+    if (mapping.size() < slice.size) {
+        throwBadFormat(path + ": fat slice extends past end of file");
+    }
+    return mapping;
+}
+
+} // namespace
+
+bool CpuArchitecture::parse(std::string_view name, CpuArchitecture &architecture) {
+    for (const auto &entry : kArchitectureNames) {
+        if (name == entry.name) {
+            architecture.type = entry.type;
+            architecture.subtype = entry.subtype;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *CpuArchitecture::name() const {
+    const char *sameType = nullptr;
+    for (const auto &entry : kArchitectureNames) {
+        if (entry.type != type) {
+            continue;
+        }
+        if (sameSubtype(entry.subtype, subtype)) {
+            return entry.name;
+        }
+        if (sameType == nullptr) {
+            sameType = entry.name;
+        }
+    }
+    // Subtypes without a name of their own still open as their cputype.
+    return sameType;
+}
+
+MachOFile MachOFile::open(const std::string &path, const char *arch) {
+    CpuArchitecture requested;
+    if (arch != nullptr && !CpuArchitecture::parse(arch, requested)) {
+        throw Error(SYMBOLICATOR_E_INVALID_ARG, std::string("unknown architecture ") + arch);
+    }
+
+    MachOFile file;
+    std::vector<FatSlice> slices;
+    if (!readFatSlices(path, slices)) {
+        file.file_ = MappedFile::open(path);
+        file.parse(file.file_.data(), file.file_.size(), arch != nullptr ? &requested : nullptr);
+        return file;
+    }
+
+    const FatSlice *match = nullptr;
+    if (arch == nullptr) {
+        if (slices.size() != 1) {
+            throw Error(SYMBOLICATOR_E_ARCH_NOT_FOUND, path + ": universal binary requires an architecture");
+        }
+        match = &slices.front();
+    } else {
+        // Prefer an exact cpusubtype match, otherwise fall back to any slice of
+        // the same cputype (an arm64 crash against an arm64e dSYM, for instance).
+        const FatSlice *fallback = nullptr;
+        for (const auto &slice : slices) {
+            if (slice.architecture.type != requested.type) {
+                continue;
+            }
+            if (sameSubtype(slice.architecture.subtype, requested.subtype)) {
+                match = &slice;
+                break;
+            }
+            if (fallback == nullptr) {
+                fallback = &slice;
+            }
+        }
+        if (match == nullptr) {
+            match = fallback;
+        }
+    }
+    if (match == nullptr) {
+        throw Error(SYMBOLICATOR_E_ARCH_NOT_FOUND, path + ": no slice for " + arch);
+    }
+
+    // Only the chosen slice is mapped: the other architectures of a
+    // universal dSYM take neither address space nor page cache.
+    file.file_ = mapSlice(path, *match);
+    file.parse(file.file_.data(), file.file_.size(), nullptr);
+    return file;
+}
+
+std::vector<MachOSlice> MachOFile::slices(const std::string &path) {
+    std::vector<FatSlice> ranges;
+    if (!readFatSlices(path, ranges)) {
+        FatSlice whole;
+        whole.size = UINT64_MAX;
+        ranges.push_back(whole);
+    }
+
+    // Only the header and load commands of each slice are mapped.
+    std::vector<MachOSlice> slices;
+    for (const auto &range : ranges) {
+        MappedFile header = MappedFile::open(path, range.offset, std::min<uint64_t>(range.size, kMachHeader64Size));
+        if (header.size() < kMachHeader64Size) {
+            throwBadFormat(path + ": not a Mach-O file");
+        }
+        const uint64_t commandsSize = DataReader(header.data() + 20, 4).u32();
+        header = MappedFile::open(path, range.offset, std::min<uint64_t>(range.size, kMachHeader64Size + commandsSize));
+
+        MachOFile file;
+        file.parse(header.data(), header.size(), nullptr);
+        MachOSlice slice;
+        slice.architecture = file.architecture_;
+        slice.hasUUID = file.hasUUID_;
+        slice.uuid = file.uuid_;
+        slices.push_back(slice);
+    }
+    return slices;
+}
+
+void MachOFile::parse(const uint8_t *image, size_t size, const CpuArchitecture *requested) {
+    image_ = image;
+    imageSize_ = size;
+
+    DataReader header(image, size);
+    const uint32_t magic = header.u32();
+    if (magic != kMachMagic && magic != kMachMagic64) {
+        throwBadFormat("not a Mach-O file");
+    }
+    is64Bit_ = magic == kMachMagic64;
+    architecture_.type = header.u32();
+    architecture_.subtype = header.u32();
+    header.skip(4); // filetype
+    const uint32_t commandCount = header.u32();
+    header.skip(8); // sizeofcmds, flags
+    if (is64Bit_) {
+        header.skip(4);
+    }
+
+    if (requested != nullptr && requested->type != architecture_.type) {
+        throw Error(SYMBOLICATOR_E_ARCH_NOT_FOUND, "binary does not contain the requested architecture");
+    }
+
+    for (uint32_t index = 0; index < commandCount; ++index) {
+        const size_t commandOffset = header.offset();
+        const uint32_t command = header.u32();
+        const uint32_t commandSize = header.u32();
+        if (commandSize < 8 || commandOffset + commandSize > size) {
+            throwBadFormat("malformed load command");
+        }
+
+        DataReader body(image + commandOffset + 8, commandSize - 8);
+        if (command == kLoadCommandSegment64 || command == kLoadCommandSegment) {
+            const bool wide = command == kLoadCommandSegment64;
+            std::string_view segmentName = fixedString(body, 16);
+            const uint64_t vmaddr = wide ? body.u64() : body.u32();
+            body.skip(wide ? 24 : 12); // vmsize, fileoff, filesize
+            body.skip(8);              // maxprot, initprot
+            const uint32_t sectionCount = body.u32();
+            body.skip(4); // flags
+            if (segmentName == "__TEXT") {
+                textAddress_ = vmaddr;
+            }
+
+            for (uint32_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex) {
+                MachOSection section;
+                section.name = fixedString(body, 16);
+                section.segment = fixedString(body, 16);
+                section.address = wide ? body.u64() : body.u32();
+                section.size = wide ? body.u64() : body.u32();
+                section.fileOffset = body.u32();
+                body.skip(wide ? 28 : 24); // align through the reserved fields
+                sections_.push_back(section);
+            }
+        } else if (command == kLoadCommandUUID) {
+            if (body.remaining() < uuid_.size()) {
+                throwBadFormat("malformed LC_UUID");
+            }
+            std::memcpy(uuid_.data(), body.current(), uuid_.size());
+            hasUUID_ = true;
+        } else if (command == kLoadCommandSymtab) {
+            symbolOffset_ = body.u32();
+            symbolCount_ = body.u32();
+            stringOffset_ = body.u32();
+            stringSize_ = body.u32();
+        }
+
+        header.seek(commandOffset + commandSize);
+    }
+}
+
+const MachOSection *MachOFile::section(std::string_view segment, std::string_view name) const {
+    for (const auto &section : sections_) {
+        if (section.segment == segment && section.name == name) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+DataReader MachOFile::sectionData(std::string_view name) const {
+    for (const auto &section : sections_) {
+        if (section.name != name) {
+            continue;
+        }
+        if (section.fileOffset == 0 || section.fileOffset + section.size > imageSize_) {
+            return {};
+        }
+        return DataReader(image_ + section.fileOffset, static_cast<size_t>(section.size));
+    }
+    return {};
+}
+
+std::vector<MachOSymbol> MachOFile::symbols() const {
+    std::vector<MachOSymbol> symbols;
+    const size_t entrySize = is64Bit_ ? 16 : 12;
+    if (symbolCount_ == 0 || symbolOffset_ + static_cast<uint64_t>(symbolCount_) * entrySize > imageSize_ ||
+        static_cast<uint64_t>(stringOffset_) + stringSize_ > imageSize_) {
+        return symbols;
+    }
+
+    DataReader strings(image_ + stringOffset_, stringSize_);
+    DataReader table(image_ + symbolOffset_, symbolCount_ * entrySize);
+    symbols.reserve(symbolCount_);
+    for (uint32_t index = 0; index < symbolCount_; ++index) {
+        const uint32_t nameOffset = table.u32();
+        const uint8_t type = table.u8();
+        table.skip(3); // n_sect, n_desc
+        const uint64_t address = is64Bit_ ? table.u64() : table.u32();
+        if ((type & kStabMask) != 0 || (type & kTypeMask) != kTypeSection) {
+            continue;
+        }
+
+        std::string_view name = strings.cstringAt(nameOffset);
+        if (name.empty()) {
+            continue;
+        }
+        // atos reports C level names: strip the leading underscore the linker adds.
+        if (name.front() == '_') {
+            name.remove_prefix(1);
+        }
+        symbols.push_back({address, name});
+    }
+
+    std::stable_sort(symbols.begin(), symbols.end(), [](const MachOSymbol &lhs, const MachOSymbol &rhs) {
+        return lhs.address < rhs.address;
+    });
+    return symbols;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,109 @@
+//
+//  macho_file.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_MACHO_FILE_HPP
+#define SYMBOLICATOR_MACHO_FILE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data_reader.hpp"
+#include "mapped_file.hpp"
+
+namespace symbolicator {
+
+/// A cputype/cpusubtype pair as found in Mach-O and fat headers.
+struct CpuArchitecture {
+    uint32_t type = 0;
+    uint32_t subtype = 0;
+
+    /// Parses an atos style name ("arm64", "x86_64", "armv7s", ...).
+    static bool parse(std::string_view name, CpuArchitecture &architecture);
+
+    /// The atos style name of this pair, or null when it has none.
+    const char *name() const;
+};
+
+struct MachOSection {
+    std::string_view segment;
+    std::string_view name;
+    uint64_t address = 0;
+    uint64_t size = 0;
+    uint32_t fileOffset = 0;
+};
+
+struct MachOSymbol {
+    uint64_t address = 0;
+    std::string_view name;
+};
+
+/// Identity of one slice, as listed by `MachOFile::slices`.
+struct MachOSlice {
+    CpuArchitecture architecture;
+    bool hasUUID = false;
+    std::array<uint8_t, 16> uuid {};
+};
+
+/// One architecture slice of a Mach-O file, parsed from a private mapping
+/// of just that slice.
+class MachOFile {
+public:
+    /// Selects the slice of `path` for `arch` and maps only that slice.
+    /// `arch` may be null for thin files and universal files with a single
+    /// slice. Throws `Error` on failure.
+    static MachOFile open(const std::string &path, const char *arch);
+
+    /// Architecture and UUID of every slice of `path`, thin or universal,
+    /// read from the load commands alone. Throws `Error` when `path` is not
+    /// a Mach-O file.
+    static std::vector<MachOSlice> slices(const std::string &path);
+
+    const CpuArchitecture &architecture() const { return architecture_; }
+    bool is64Bit() const { return is64Bit_; }
+    bool hasUUID() const { return hasUUID_; }
+    const std::array<uint8_t, 16> &uuid() const { return uuid_; }
+
+    /// vmaddr of the __TEXT segment; the base atos subtracts load addresses from.
+    uint64_t textAddress() const { return textAddress_; }
+
+    const std::vector<MachOSection> &sections() const { return sections_; }
+    const MachOSection *section(std::string_view segment, std::string_view name) const;
+
+    /// Contents of the first section called `name` in any segment. Empty when
+    /// the section is missing or has no file contents (as in a dSYM's __TEXT).
+    DataReader sectionData(std::string_view name) const;
+
+    /// Defined, non-debug symbol table entries sorted by address.
+    std::vector<MachOSymbol> symbols() const;
+
+private:
+    void parse(const uint8_t *image, size_t size, const CpuArchitecture *requested);
+
+    MappedFile file_;
+    const uint8_t *image_ = nullptr;
+    size_t imageSize_ = 0;
+
+    CpuArchitecture architecture_;
+    bool is64Bit_ = false;
+    bool hasUUID_ = false;
+    std::array<uint8_t, 16> uuid_ {};
+    uint64_t textAddress_ = 0;
+    std::vector<MachOSection> sections_;
+
+    uint32_t symbolOffset_ = 0;
+    uint32_t symbolCount_ = 0;
+    uint32_t stringOffset_ = 0;
+    uint32_t stringSize_ = 0;
+};
+
+} // namespace symbolicator
+
+#endif
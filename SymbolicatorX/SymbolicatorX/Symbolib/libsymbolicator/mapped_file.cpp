@@ -0,0 +1,154 @@
+//
+//  mapped_file.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "error.hpp"
+
+namespace symbolicator {
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        reset();
+        mapping_ = other.mapping_;
+        mappingSize_ = other.mappingSize_;
+        data_ = other.data_;
+        size_ = other.size_;
+        other.mapping_ = nullptr;
+        other.mappingSize_ = 0;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+MappedFile MappedFile::open(const std::string &path) {
+    return open(path, 0, UINT64_MAX);
+}
+
+MappedFile MappedFile::open(const std::string &path, uint64_t offset, uint64_t length) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw Error(SYMBOLICATOR_E_IO_ERROR, path + ": " + std::strerror(errno));
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int savedErrno = errno;
+        ::close(fd);
+        throw Error(SYMBOLICATOR_E_IO_ERROR, path + ": " + std::strerror(savedErrno));
+    }
+
+    const uint64_t fileSize = static_cast<uint64_t>(info.st_size);
+    MappedFile file;
+    if (offset < fileSize && length > 0) {
+        length = std::min(length, fileSize - offset);
+        // mmap offsets must be page aligned; the bytes before `offset` are
+        // mapped but not exposed.
+        static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        const uint64_t start = offset - offset % pageSize;
+        const size_t mappingSize = static_cast<size_t>(offset - start + length);
+        void *mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(start));
+        if (mapping == MAP_FAILED) {
+            int savedErrno = errno;
+            ::close(fd);
+            throw Error(SYMBOLICATOR_E_IO_ERROR, path + ": " + std::strerror(savedErrno));
+        }
+        file.mapping_ = mapping;
+        file.mappingSize_ = mappingSize;
+        file.data_ = static_cast<const uint8_t *>(mapping) + (offset - start);
+        file.size_ = static_cast<size_t>(length);
+    }
+    ::close(fd);
+    return file;
+}
+
+void MappedFile::prefetch() const {
+    if (mapping_ != nullptr) {
+        madvise(mapping_, mappingSize_, MADV_WILLNEED);
+    }
+}
+
+void MappedFile::reset() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappingSize_);
+    }
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void writeAll(int fd, const void *data, size_t size, const std::string &path) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    while (size > 0) {
+        const ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw Error(SYMBOLICATOR_E_IO_ERROR, path + ": " + std::strerror(errno));
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void createDirectories(const std::string &path) {
+    for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+        const std::string prefix = path.substr(0, slash);
+        if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw Error(SYMBOLICATOR_E_IO_ERROR, prefix + ": " + std::strerror(errno));
+        }
+        if (slash == std::string::npos) {
+            return;
+        }
+    }
+}
+
+void writeFileAtomically(const std::string &path, std::string_view contents) {
+    static std::atomic<unsigned> sequence {0};
+    const std::string temporary = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(sequence++);
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw Error(SYMBOLICATOR_E_IO_ERROR, temporary + ": " + std::strerror(errno));
+    }
+
+    try {
+        writeAll(fd, contents.data(), contents.size(), temporary);
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+
+    if (::close(fd) != 0 || ::rename(temporary.c_str(), path.c_str()) != 0) {
+        const int savedErrno = errno;
+        ::unlink(temporary.c_str());
+        throw Error(SYMBOLICATOR_E_IO_ERROR, path + ": " + std::strerror(savedErrno));
+    }
+}
+
+} // namespace symbolicator
@@ -0,0 +1,66 @@
+//
+//  mapped_file.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_MAPPED_FILE_HPP
+#define SYMBOLICATOR_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace symbolicator {
+
+/// Read-only private mapping of a file. Move-only; unmaps on destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /// Maps the whole file. Throws `Error` on failure.
+    static MappedFile open(const std::string &path);
+    /// Maps `length` bytes at `offset`, cut short at the end of the file, so
+    /// one slice of a large file costs no more address space than the slice.
+    /// Throws `Error` on failure.
+    static MappedFile open(const std::string &path, uint64_t offset, uint64_t length);
+
+    /// Starts reading the mapped pages in ahead of their first use.
+    void prefetch() const;
+
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    void reset();
+
+    void *mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/// Writes all of `data` to `fd`, retrying short writes. `path` names the
+/// file in errors. Throws `Error`.
+void writeAll(int fd, const void *data, size_t size, const std::string &path);
+
+/// Creates `path` and any missing parent directories. Throws `Error`.
+void createDirectories(const std::string &path);
+
+/// Replaces `path` with `contents` via a temporary file and rename, so
+/// readers see either the old file or the new one. Throws `Error`.
+void writeFileAtomically(const std::string &path, std::string_view contents);
+
+} // namespace symbolicator
+
+#endif
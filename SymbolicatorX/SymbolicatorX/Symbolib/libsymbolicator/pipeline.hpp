@@ -0,0 +1,261 @@
+//
+//  pipeline.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_PIPELINE_HPP
+#define SYMBOLICATOR_PIPELINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "work_pool.hpp"
+
+namespace symbolicator {
+
+/// Fixed-capacity multi-producer multi-consumer queue without locks, after
+/// Dmitry Vyukov's bounded MPMC ring: every slot carries a sequence number
+/// saying whose turn it is, so a push or pop costs one compare-and-swap on
+/// its end of the ring. `push` and `pop` spin briefly while the queue is
+/// full or empty and then park until the other side makes progress; the
+/// lock is only ever taken by a thread that has nothing else to do.
+/// `close` ends the stream once the queue has drained.
+template <typename T>
+class BoundedQueue {
+public:
+    /// `capacity` is rounded up to a power of two.
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots_ = std::make_unique<Slot[]>(size);
+        for (size_t index = 0; index < size; ++index) {
+            slots_[index].sequence.store(index, std::memory_order_relaxed);
+        }
+        mask_ = size - 1;
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /// Moves `value` in unless the queue is full.
+    bool tryPush(T &value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[position & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const ptrdiff_t lag = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+            if (lag == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Moves the oldest value out unless the queue is empty.
+    bool tryPop(T &value) {
+        size_t position = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[position & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const ptrdiff_t lag = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position + 1);
+            if (lag == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Waits for room, which is what holds producers back to the pace of
+    /// the consumers.
+    void push(T value) {
+        if (!spin([&] { return tryPush(value); })) {
+            notFull_.wait([&] { return tryPush(value); });
+        }
+        notEmpty_.notify();
+    }
+
+    /// Waits for a value; returns false once the queue is closed and empty.
+    bool pop(T &value) {
+        // Every push happened before `close`, so a closed queue that is
+        // empty on a second look stays empty.
+        bool popped = false;
+        auto attempt = [&] {
+            popped = tryPop(value);
+            return popped || (closed_.load(std::memory_order_acquire) && (popped = tryPop(value), true));
+        };
+        if (!spin(attempt)) {
+            notEmpty_.wait(attempt);
+        }
+        if (popped) {
+            notFull_.notify();
+        }
+        return popped;
+    }
+
+    /// Called once no more values will be pushed.
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        notEmpty_.notify();
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence {0};
+        T value {};
+    };
+
+    /// Threads blocked on one side of the queue. The waiter count is
+    /// checked after every push and pop, so the other side only locks and
+    /// signals when someone is actually asleep.
+    class Parking {
+    public:
+        template <typename Attempt>
+        void wait(const Attempt &attempt) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            waiting_.fetch_add(1, std::memory_order_seq_cst);
+            // The timeout only bounds the cost of a wakeup lost to a
+            // notifier that read the count just before it went up.
+            while (!attempt()) {
+                ready_.wait_for(lock, std::chrono::milliseconds(1));
+            }
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ready_.notify_all();
+            }
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::atomic<size_t> waiting_ {0};
+    };
+
+    /// Stages hand over whole reports, so a short spin rarely pays off and
+    /// is kept to a few yields.
+    template <typename Attempt>
+    static bool spin(const Attempt &attempt) {
+        for (unsigned round = 0; round < 4; ++round) {
+            if (attempt()) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        return attempt();
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    /// Apart, so producers and consumers do not contend for one cache line.
+    alignas(64) std::atomic<size_t> tail_ {0};
+    alignas(64) std::atomic<size_t> head_ {0};
+    alignas(64) std::atomic<bool> closed_ {false};
+    Parking notEmpty_;
+    Parking notFull_;
+};
+
+/// Streams items 0 to `count` - 1 through three stages joined by bounded
+/// queues, so reading one item overlaps processing others while only a
+/// few dozen are in flight at a time, however many there are:
+///
+/// - `read(index)` returns an `Item`, on a few threads of its own, since
+///   they mostly wait for the disk;
+/// - `process(Item &&)` returns an `Output`, on every worker of `pool`;
+/// - `write(Output &&)` runs on the calling thread, one call at a time, in
+///   the order outputs complete.
+///
+/// `read` and `process` must not throw. An exception from `write` stops
+/// further writes and is rethrown once the other stages have wound down.
+template <typename Item, typename Output, typename Read, typename Process, typename Write>
+void runPipeline(WorkPool &pool, size_t count, const Read &read, const Process &process, const Write &write) {
+    if (count == 0) {
+        return;
+    }
+    const size_t workers = pool.size();
+    const size_t readerCount = std::min(count, std::max<size_t>(2, workers / 4));
+    BoundedQueue<Item> items(2 * workers);
+    BoundedQueue<Output> outputs(2 * workers);
+
+    // The last reader and the last processor to finish close the queue
+    // they feed.
+    std::atomic<size_t> next {0};
+    std::atomic<size_t> readersLeft {readerCount};
+    std::atomic<size_t> processorsLeft {workers};
+    std::vector<std::thread> readers;
+    for (size_t reader = 0; reader < readerCount; ++reader) {
+        readers.emplace_back([&] {
+            for (size_t index; (index = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                items.push(read(index));
+            }
+            if (readersLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                items.close();
+            }
+        });
+    }
+    for (size_t worker = 0; worker < workers; ++worker) {
+        pool.submit([&] {
+            Item item;
+            while (items.pop(item)) {
+                outputs.push(process(std::move(item)));
+            }
+            if (processorsLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                outputs.close();
+            }
+        });
+    }
+
+    std::exception_ptr failure;
+    Output output;
+    while (outputs.pop(output)) {
+        if (failure) {
+            continue;
+        }
+        try {
+            write(std::move(output));
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    }
+    pool.wait();
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,220 @@
+//
+//  report_json.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "report_json.hpp"
+
+#include <charconv>
+#include <string_view>
+
+namespace symbolicator {
+
+namespace {
+
+using ResolvedFrame = BatchSymbolicator::ResolvedFrame;
+
+/// "0x" and 16 lowercase hex digits, as reports print addresses.
+JSONWriter &hexField(JSONWriter &writer, std::string_view name, uint64_t value) {
+    static const char kHex[] = "0123456789abcdef";
+    char digits[18] = {'0', 'x'};
+    for (int index = 17; index >= 2; --index, value >>= 4) {
+        digits[index] = kHex[value & 0xf];
+    }
+    return writer.field(name, std::string_view(digits, sizeof(digits)));
+}
+
+void optionalField(JSONWriter &writer, std::string_view name, std::string_view value) {
+    if (!value.empty()) {
+        writer.field(name, value);
+    }
+}
+
+/// Symbol and offset of a resolved frame, then its file and line unless
+/// `sourceFile` gives them, then the calls inlined at it.
+void writeResolved(JSONWriter &writer, const ResolvedFrame &resolved, std::string_view sourceFile = {},
+                   int64_t sourceLine = 0) {
+    writer.field("symbol", resolved.lookup.function);
+    writer.field("symbolOffset", resolved.symbolOffset);
+    if (!sourceFile.empty()) {
+        writer.field("file", sourceFile).field("line", sourceLine);
+    } else if (resolved.lookup.file != nullptr && resolved.lookup.line > 0) {
+        writer.field("file", resolved.lookup.file).field("line", resolved.lookup.line);
+    }
+    if (resolved.inlined.empty()) {
+        return;
+    }
+    writer.key("inlined").beginArray();
+    for (const auto &call : resolved.inlined) {
+        writer.beginObject().field("symbol", call.function != nullptr ? call.function : "");
+        if (call.file != nullptr && call.line > 0) {
+            writer.field("file", call.file).field("line", call.line);
+        }
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+bool isResolved(const BatchSymbolicator::Result &result, size_t frame) {
+    return frame < result.frames.size() && result.frames[frame].image != nullptr &&
+           result.frames[frame].lookup.function != nullptr;
+}
+
+void writeTextReport(JSONWriter &writer, const BatchSymbolicator::Result &result) {
+    const CrashReport &report = *result.report;
+    writer.key("header").beginObject();
+    optionalField(writer, "process", report.processName);
+    optionalField(writer, "identifier", report.identifier);
+    optionalField(writer, "responsible", report.responsible);
+    optionalField(writer, "version", report.version);
+    optionalField(writer, "build", report.buildVersion);
+    optionalField(writer, "codeType", report.codeType);
+    optionalField(writer, "exceptionType", report.exceptionType);
+    if (report.crashedThread >= 0) {
+        writer.field("crashedThread", report.crashedThread);
+    }
+    writer.endObject();
+    writer.field("resolvedFrames", result.resolvedFrames);
+
+    // Frames come in thread order; each run of one thread number is a thread.
+    writer.key("threads").beginArray();
+    for (size_t index = 0; index < report.frames.size(); ++index) {
+        const ReportFrame &frame = report.frames[index];
+        if (index == 0 || frame.thread != report.frames[index - 1].thread) {
+            if (index > 0) {
+                writer.endArray().endObject();
+            }
+            writer.beginObject().key("thread");
+            frame.thread >= 0 ? writer.number(frame.thread) : writer.null();
+            writer.field("crashed", frame.thread >= 0 && frame.thread == report.crashedThread);
+            writer.key("frames").beginArray();
+        }
+
+        writer.beginObject().field("image", frame.imageName).field("address", frame.address);
+        if (frame.image >= 0) {
+            writer.field("imageOffset", frame.addressValue - report.images[static_cast<size_t>(frame.image)].start);
+        }
+        if (isResolved(result, index)) {
+            writeResolved(writer, result.frames[index]);
+        }
+        writer.endObject();
+    }
+    if (!report.frames.empty()) {
+        writer.endArray().endObject();
+    }
+    writer.endArray();
+
+    writer.key("images").beginArray();
+    for (const auto &image : report.images) {
+        writer.beginObject().field("name", image.name);
+        optionalField(writer, "arch", image.arch);
+        optionalField(writer, "uuid", image.uuid);
+        hexField(writer, "loadAddress", image.start);
+        hexField(writer, "endAddress", image.end);
+        optionalField(writer, "path", image.path);
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+void writeIPSReport(JSONWriter &writer, const BatchSymbolicator::Result &result) {
+    const IPSReport &report = *result.ips;
+    const IPSHeader &header = report.header();
+    writer.key("header").beginObject();
+    optionalField(writer, "incident", header.incidentIdentifier);
+    optionalField(writer, "process", header.processName);
+    optionalField(writer, "pid", header.pid);
+    optionalField(writer, "path", header.processPath);
+    optionalField(writer, "identifier", header.bundleIdentifier);
+    optionalField(writer, "version", header.shortVersion);
+    optionalField(writer, "build", header.bundleVersion);
+    optionalField(writer, "codeType", header.cpuType);
+    optionalField(writer, "osVersion", header.osVersion);
+    optionalField(writer, "model", header.modelCode);
+    optionalField(writer, "captureTime", header.captureTime);
+    optionalField(writer, "launchTime", header.launchTime);
+    optionalField(writer, "exceptionType", header.exceptionType);
+    optionalField(writer, "exceptionSignal", header.exceptionSignal);
+    optionalField(writer, "exceptionCodes", header.exceptionCodes);
+    int64_t crashedThread = -1;
+    const std::string_view faulting = header.faultingThread;
+    if (std::from_chars(faulting.data(), faulting.data() + faulting.size(), crashedThread).ec == std::errc() &&
+        crashedThread >= 0) {
+        writer.field("crashedThread", crashedThread);
+    }
+    writer.endObject();
+    writer.field("resolvedFrames", result.resolvedFrames);
+
+    writer.key("threads").beginArray();
+    for (size_t thread = 0; thread < report.threads().size(); ++thread) {
+        const IPSThread &info = report.threads()[thread];
+        writer.beginObject().field("thread", thread);
+        optionalField(writer, "name", info.name);
+        writer.field("crashed", info.triggered);
+        writer.key("frames").beginArray();
+        for (size_t index = info.firstFrame; index < info.firstFrame + info.frameCount; ++index) {
+            const IPSFrame &frame = report.frames()[index];
+            const IPSImage *image = report.image(frame);
+            writer.beginObject();
+            if (image != nullptr) {
+                writer.field("image", image->name);
+                hexField(writer, "address", image->base + frame.imageOffset);
+            }
+            writer.field("imageOffset", frame.imageOffset);
+            // What the report already carries wins, as in its text form.
+            if (frame.hasSymbol) {
+                writer.field("symbol", frame.symbol).field("symbolOffset", frame.symbolLocation);
+            }
+            if (!frame.hasSymbol && isResolved(result, index)) {
+                writeResolved(writer, result.frames[index], frame.hasSource ? frame.sourceFile : std::string_view(),
+                              frame.sourceLine);
+            } else if (frame.hasSource) {
+                writer.field("file", frame.sourceFile).field("line", frame.sourceLine);
+            }
+            writer.endObject();
+        }
+        writer.endArray().endObject();
+    }
+    writer.endArray();
+
+    writer.key("images").beginArray();
+    for (const auto &image : report.images()) {
+        writer.beginObject().field("name", image.name);
+        optionalField(writer, "arch", image.arch);
+        optionalField(writer, "uuid", image.uuid);
+        hexField(writer, "loadAddress", image.base);
+        hexField(writer, "endAddress", image.base + image.size);
+        optionalField(writer, "path", image.path);
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+} // namespace
+
+void writeReportJSON(JSONWriter &writer, const BatchSymbolicator::Result &result) {
+    writer.beginObject().field("report", result.name);
+    if (!result.error.empty() || (result.report == nullptr && result.ips == nullptr)) {
+        writer.field("error", result.error).endObject();
+        return;
+    }
+
+    writer.field("format", result.ips != nullptr ? "ips" : "text");
+    if (result.bucket != nullptr) {
+        // Deduplicated batches deliver one report per signature.
+        writer.key("bucket").beginObject();
+        hexField(writer, "signature", result.bucket->signature.hash);
+        writer.field("reports", result.bucket->names.size()).endObject();
+    }
+    if (result.ips != nullptr) {
+        writeIPSReport(writer, result);
+    } else {
+        writeTextReport(writer, result);
+    }
+    writer.endObject();
+}
+
+} // namespace symbolicator
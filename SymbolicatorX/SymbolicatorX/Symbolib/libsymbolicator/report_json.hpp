@@ -0,0 +1,39 @@
+//
+//  report_json.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_REPORT_JSON_HPP
+#define SYMBOLICATOR_REPORT_JSON_HPP
+
+#include "batch_symbolicator.hpp"
+#include "json_writer.hpp"
+
+namespace symbolicator {
+
+/// Writes a symbolicated report as one JSON object, the same shape for text
+/// and .ips reports:
+///
+///     {"report": name, "format": "text" | "ips",
+///      "header": {"process": ..., "version": ..., "exceptionType": ..., ...},
+///      "resolvedFrames": n,
+///      "threads": [{"thread": n, "name": ..., "crashed": bool,
+///                   "frames": [{"image": ..., "address": "0x...", "imageOffset": n,
+///                               "symbol": ..., "symbolOffset": n, "file": ..., "line": n,
+///                               "inlined": [{"symbol": ..., "file": ..., "line": n}]}]}],
+///      "images": [{"name": ..., "arch": ..., "uuid": ..., "loadAddress": "0x...",
+///                  "endAddress": "0x...", "path": ...}]}
+///
+/// Absent values are left out rather than written as null, and a
+/// deduplicated report adds `"bucket": {"signature": ..., "reports": n}`.
+/// A report that failed is `{"report": name, "error": message}`. `result` must still be
+/// in its delivery call. Nothing is written but `writer`'s string, so the
+/// record of a batch report costs one buffer.
+void writeReportJSON(JSONWriter &writer, const BatchSymbolicator::Result &result);
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,1251 @@
+//
+//  swift_demangler.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "swift_demangler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <vector>
+
+namespace symbolicator {
+
+namespace {
+
+/// A node of the demangling stack. Swift manglings are postfix: every
+/// operator pops its operands, so the tree is built bottom up.
+struct Node {
+    enum class Kind : uint8_t {
+        // Operands that never reach the printer.
+        Identifier,         ///< `text`; also a parameter label.
+        DeclName,           ///< `text`; a private, local or operator name.
+        FirstElementMarker, ///< '_' after the first element of a list.
+        EmptyList,
+        VariadicMarker,
+        Annotation,         ///< " async" or " throws" of the function type above it.
+        Requirement,
+        GenericSignature,
+        Attribute,          ///< `text` printed before the whole symbol, e.g. "merged ".
+
+        // Types.
+        Nominal,            ///< `tag` C, V, O, P or a; children[0] is the context.
+        BoundGeneric,       ///< children[0]<children[1], ...>
+        Tuple,              ///< Children are TupleElements.
+        TupleElement,       ///< `text` label, `tag` 'd' when variadic, children[0] type.
+        FunctionType,       ///< (children[0]) -> children[1], `text` the annotations.
+        GenericParam,       ///< `text`
+        DependentMember,    ///< children[0].`text`
+        Metatype,           ///< children[0].Type
+        Modified,           ///< `text` children[0], e.g. "inout Int".
+        Existential,        ///< Children are the protocols.
+
+        // Contexts and entities.
+        Module,             ///< `text`; never printed.
+        Extension,          ///< Prints as the extended type, children[0].
+        Function,           ///< `text` name, `tail` labels.
+        Constructor,        ///< Same as Function.
+        Variable,           ///< `text` name.
+        Subscript,          ///< `tail` labels.
+        Accessor,           ///< children[0].`text`, e.g. "Foo.bar.getter".
+        Closure,            ///< `text` in children[0], e.g. "closure #1 in foo()".
+        Static,             ///< static children[0]
+        Global,             ///< `text` children[0] `tail`
+    };
+
+    Kind kind;
+    char tag = 0;
+    std::string text;
+    std::string tail;
+    std::vector<Node *> children;
+};
+
+bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+bool isLower(char character) {
+    return character >= 'a' && character <= 'z';
+}
+
+bool isUpper(char character) {
+    return character >= 'A' && character <= 'Z';
+}
+
+bool isType(const Node *node) {
+    return node->kind >= Node::Kind::Nominal && node->kind <= Node::Kind::Existential;
+}
+
+/// Entities are also the contexts whose members print as "x in context"
+/// rather than "context.x".
+bool isEntity(const Node *node) {
+    return node->kind >= Node::Kind::Function;
+}
+
+bool isSwiftType(const Node *node, const char *name) {
+    return node->kind == Node::Kind::Nominal && node->text == name &&
+           node->children[0]->kind == Node::Kind::Module && node->children[0]->text == "Swift";
+}
+
+/// Turns a node tree into the simplified text. Substitutions let a short
+/// symbol reference the same subtree many times; the budget bounds the
+/// work for hostile input and `print` fails once it runs out.
+class Printer {
+public:
+    bool print(const Node *node, std::string &out) {
+        out = text(node);
+        return budget_ > 0;
+    }
+
+private:
+    std::string text(const Node *node);
+    std::string qualify(const Node *context, const std::string &name);
+    std::string list(const std::vector<Node *> &nodes, size_t first, const char *separator);
+
+    int budget_ = 1 << 16;
+};
+
+std::string Printer::qualify(const Node *context, const std::string &name) {
+    if (context->kind == Node::Kind::Module) {
+        return name;
+    }
+    if (isEntity(context)) {
+        return name + " in " + text(context);
+    }
+    return text(context) + "." + name;
+}
+
+std::string Printer::list(const std::vector<Node *> &nodes, size_t first, const char *separator) {
+    std::string result;
+    for (size_t index = first; index < nodes.size(); ++index) {
+        if (index > first) {
+            result.append(separator);
+        }
+        result.append(text(nodes[index]));
+    }
+    return result;
+}
+
+std::string Printer::text(const Node *node) {
+    if (--budget_ <= 0) {
+        return {};
+    }
+    const auto &children = node->children;
+    switch (node->kind) {
+    case Node::Kind::Nominal: return qualify(children[0], node->text);
+    case Node::Kind::BoundGeneric: {
+        const Node *nominal = children[0];
+        if (isSwiftType(nominal, "Optional") && children.size() == 2) {
+            const bool needsParentheses = children[1]->kind == Node::Kind::FunctionType;
+            return needsParentheses ? "(" + text(children[1]) + ")?" : text(children[1]) + "?";
+        }
+        if (isSwiftType(nominal, "Array") && children.size() == 2) {
+            return "[" + text(children[1]) + "]";
+        }
+        if (isSwiftType(nominal, "Dictionary") && children.size() == 3) {
+            return "[" + text(children[1]) + " : " + text(children[2]) + "]";
+        }
+        return text(nominal) + "<" + list(children, 1, ", ") + ">";
+    }
+    case Node::Kind::Tuple: return "(" + list(children, 0, ", ") + ")";
+    case Node::Kind::TupleElement: {
+        std::string element = node->text.empty() ? std::string() : node->text + ": ";
+        element.append(text(children[0]));
+        if (node->tag == 'd') {
+            element.append("...");
+        }
+        return element;
+    }
+    case Node::Kind::FunctionType: {
+        std::string parameters = text(children[0]);
+        if (children[0]->kind != Node::Kind::Tuple) {
+            parameters = "(" + parameters + ")";
+        }
+        return parameters + node->text + " -> " + text(children[1]);
+    }
+    case Node::Kind::GenericParam: return node->text;
+    case Node::Kind::DependentMember: return text(children[0]) + "." + node->text;
+    case Node::Kind::Metatype: return text(children[0]) + ".Type";
+    case Node::Kind::Modified: return node->text + text(children[0]);
+    case Node::Kind::Existential: return children.empty() ? "Any" : "any " + list(children, 0, " & ");
+    case Node::Kind::Module: return node->text;
+    case Node::Kind::Extension: return text(children[0]);
+    case Node::Kind::Function:
+    case Node::Kind::Constructor: return qualify(children[0], node->text + node->tail);
+    case Node::Kind::Variable: return qualify(children[0], node->text);
+    case Node::Kind::Subscript: return qualify(children[0], "subscript" + node->tail);
+    case Node::Kind::Accessor: return text(children[0]) + "." + node->text;
+    case Node::Kind::Closure: return node->text + " in " + text(children[0]);
+    case Node::Kind::Static: return "static " + text(children[0]);
+    case Node::Kind::Global: return node->text + text(children[0]) + node->tail;
+    default: return {};
+    }
+}
+
+/// Stack machine over the Swift 5 mangling grammar (docs/ABI/Mangling.rst
+/// in the Swift repository), following the structure of Swift's own
+/// demangler so the two agree on which operands each operator takes.
+class Parser {
+public:
+    /// Repeated substitutions can push far more nodes than the symbol has characters.
+    static constexpr size_t kMaxStackSize = 1 << 14;
+
+
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    bool parse(std::string &out);
+
+private:
+    char next() { return position_ < text_.size() ? text_[position_++] : '\0'; }
+    char look() const { return position_ < text_.size() ? text_[position_] : '\0'; }
+
+    bool consume(char character) {
+        if (look() != character) {
+            return false;
+        }
+        ++position_;
+        return true;
+    }
+
+    Node *make(Node::Kind kind, std::string text = {}, std::initializer_list<Node *> children = {}) {
+        nodes_.push_back({kind, 0, std::move(text), {}, children});
+        return &nodes_.back();
+    }
+
+    void push(Node *node) { stack_.push_back(node); }
+
+    Node *pop() {
+        if (stack_.empty()) {
+            return nullptr;
+        }
+        Node *node = stack_.back();
+        stack_.pop_back();
+        return node;
+    }
+
+    Node *pop(Node::Kind kind) {
+        return !stack_.empty() && stack_.back()->kind == kind ? pop() : nullptr;
+    }
+
+    Node *popType() {
+        return !stack_.empty() && isType(stack_.back()) ? pop() : nullptr;
+    }
+
+    Node *popName() {
+        if (Node *identifier = pop(Node::Kind::Identifier)) {
+            return identifier;
+        }
+        return pop(Node::Kind::DeclName);
+    }
+
+    bool parseNatural(size_t &value);
+    bool parseIndex(size_t &value);
+    Node *parseGenericParamIndex();
+    static std::string genericParamName(size_t depth, size_t index);
+
+    Node *popModule();
+    Node *popContext();
+    Node *popProtocol();
+    Node *popConformance();
+    Node *popTuple();
+    Node *popParameters();
+    Node *popFunctionType();
+    bool popLabels(const Node *type, std::string &labels);
+    Node *popAssociatedType(Node *base);
+
+    Node *parseOperator();
+    Node *parseIdentifier();
+    Node *parseOperatorName();
+    Node *parseMultiSubstitutions();
+    Node *parseStandardSubstitution();
+    Node *parseNominal(char tag);
+    Node *parseBoundGeneric();
+    Node *parsePrivateName();
+    Node *parseFunctionEntity();
+    Node *parseAccessor(Node *storage);
+    Node *parseRequirement();
+    Node *parseGenericSignature(bool hasParamCounts);
+    Node *parseThunk();
+    Node *parseSpecialization(bool isFunctionSignature);
+    Node *parseMetadata();
+    Node *parseWitness();
+    Node *parseDependentMember();
+
+    std::string_view text_;
+    size_t position_ = 0;
+    std::deque<Node> nodes_;
+    std::vector<Node *> stack_;
+    std::vector<Node *> substitutions_;
+    std::vector<std::string> words_;
+};
+
+bool Parser::parseNatural(size_t &value) {
+    value = 0;
+    const size_t start = position_;
+    while (isDigit(look())) {
+        value = value * 10 + static_cast<size_t>(next() - '0');
+        if (value > text_.size()) {
+            return false;
+        }
+    }
+    return position_ > start;
+}
+
+bool Parser::parseIndex(size_t &value) {
+    if (consume('_')) {
+        value = 0;
+        return true;
+    }
+    if (!parseNatural(value) || !consume('_')) {
+        return false;
+    }
+    ++value;
+    return true;
+}
+
+std::string Parser::genericParamName(size_t depth, size_t index) {
+    std::string name;
+    do {
+        name.push_back(static_cast<char>('A' + index % 26));
+        index /= 26;
+    } while (index != 0);
+    if (depth != 0) {
+        name.append(std::to_string(depth));
+    }
+    return name;
+}
+
+Node *Parser::parseGenericParamIndex() {
+    size_t depth = 0;
+    size_t index = 0;
+    if (consume('d')) {
+        if (!parseIndex(depth) || !parseIndex(index)) {
+            return nullptr;
+        }
+        ++depth;
+    } else if (consume('s')) {
+        return make(Node::Kind::GenericParam, "Self");
+    } else if (!consume('z')) {
+        if (!parseIndex(index)) {
+            return nullptr;
+        }
+        ++index;
+    }
+    return make(Node::Kind::GenericParam, genericParamName(depth, index));
+}
+
+Node *Parser::popModule() {
+    if (Node *identifier = pop(Node::Kind::Identifier)) {
+        // The identifier may still be referenced as a substitution.
+        return make(Node::Kind::Module, identifier->text);
+    }
+    return pop(Node::Kind::Module);
+}
+
+Node *Parser::popContext() {
+    if (Node *module = popModule()) {
+        return module;
+    }
+    if (stack_.empty()) {
+        return nullptr;
+    }
+    Node *top = stack_.back();
+    if (top->kind == Node::Kind::Nominal || top->kind == Node::Kind::BoundGeneric ||
+        top->kind == Node::Kind::Extension || isEntity(top)) {
+        return pop();
+    }
+    return nullptr;
+}
+
+Node *Parser::popProtocol() {
+    if (Node *type = popType()) {
+        return type->kind == Node::Kind::Nominal && type->tag == 'P' ? type : nullptr;
+    }
+    Node *name = popName();
+    Node *context = name != nullptr ? popContext() : nullptr;
+    if (context == nullptr) {
+        return nullptr;
+    }
+    Node *protocol = make(Node::Kind::Nominal, name->text, {context});
+    protocol->tag = 'P';
+    return protocol;
+}
+
+/// A conformance of a type to a protocol, as in witness tables: the type,
+/// the protocol and the module declaring the conformance.
+Node *Parser::popConformance() {
+    pop(Node::Kind::GenericSignature);
+    Node *module = popModule();
+    Node *protocol = module != nullptr ? popProtocol() : nullptr;
+    Node *type = protocol != nullptr ? popType() : nullptr;
+    return type;
+}
+
+Node *Parser::popTuple() {
+    Node *tuple = make(Node::Kind::Tuple);
+    if (pop(Node::Kind::EmptyList) != nullptr) {
+        return tuple;
+    }
+    bool isFirst = false;
+    do {
+        isFirst = pop(Node::Kind::FirstElementMarker) != nullptr;
+        Node *element = make(Node::Kind::TupleElement);
+        if (pop(Node::Kind::VariadicMarker) != nullptr) {
+            element->tag = 'd';
+        }
+        if (Node *label = pop(Node::Kind::Identifier)) {
+            element->text = label->text;
+        }
+        Node *type = popType();
+        if (type == nullptr) {
+            return nullptr;
+        }
+        element->children.push_back(type);
+        tuple->children.push_back(element);
+    } while (!isFirst);
+    std::reverse(tuple->children.begin(), tuple->children.end());
+    return tuple;
+}
+
+Node *Parser::popParameters() {
+    if (pop(Node::Kind::EmptyList) != nullptr) {
+        return make(Node::Kind::Tuple);
+    }
+    return popType();
+}
+
+Node *Parser::popFunctionType() {
+    std::string annotations;
+    while (Node *annotation = pop(Node::Kind::Annotation)) {
+        annotations.insert(0, annotation->text);
+    }
+    Node *parameters = popParameters();
+    Node *results = parameters != nullptr ? popParameters() : nullptr;
+    if (results == nullptr) {
+        return nullptr;
+    }
+    return make(Node::Kind::FunctionType, std::move(annotations), {parameters, results});
+}
+
+/// Pops one label per parameter of a function type, or the empty list
+/// standing for no labels at all, and formats them as in "foo(_:bar:)".
+bool Parser::popLabels(const Node *type, std::string &labels) {
+    labels.clear();
+    if (type->kind != Node::Kind::FunctionType) {
+        return true;
+    }
+    const Node *parameters = type->children[0];
+    const size_t count = parameters->kind == Node::Kind::Tuple ? parameters->children.size() : 1;
+
+    std::vector<std::string> names(count, "_");
+    if (pop(Node::Kind::EmptyList) == nullptr) {
+        for (size_t index = count; index > 0; --index) {
+            Node *label = pop();
+            if (label == nullptr) {
+                return false;
+            }
+            if (label->kind == Node::Kind::Identifier) {
+                names[index - 1] = label->text;
+            } else if (label->kind != Node::Kind::FirstElementMarker) {
+                return false;
+            }
+        }
+    }
+
+    labels = "(";
+    for (const auto &name : names) {
+        labels.append(name).push_back(':');
+    }
+    labels.push_back(')');
+    return true;
+}
+
+/// An associated type of `base`, or of the type below its name when
+/// `base` is null: "A.Element".
+Node *Parser::popAssociatedType(Node *base) {
+    if (!stack_.empty() && stack_.back()->kind == Node::Kind::Nominal && stack_.back()->tag == 'P') {
+        pop();
+    }
+    Node *name = pop(Node::Kind::Identifier);
+    if (base == nullptr) {
+        base = popType();
+    }
+    if (name == nullptr || base == nullptr) {
+        return nullptr;
+    }
+    return make(Node::Kind::DependentMember, name->text, {base});
+}
+
+Node *Parser::parseOperator() {
+    const char character = next();
+    switch (character) {
+    case 'A': return parseMultiSubstitutions();
+    case 'C':
+    case 'O':
+    case 'P':
+    case 'V':
+    case 'a': return parseNominal(character);
+    case 'D': {
+        Node *type = popType();
+        return type != nullptr ? make(Node::Kind::Global, {}, {type}) : nullptr;
+    }
+    case 'E': {
+        pop(Node::Kind::GenericSignature);
+        Node *module = popModule();
+        Node *type = module != nullptr ? popType() : nullptr;
+        return type != nullptr ? make(Node::Kind::Extension, {}, {type}) : nullptr;
+    }
+    case 'F': {
+        pop(Node::Kind::GenericSignature);
+        Node *type = popFunctionType();
+        std::string labels;
+        if (type == nullptr || !popLabels(type, labels)) {
+            return nullptr;
+        }
+        Node *name = popName();
+        Node *context = name != nullptr ? popContext() : nullptr;
+        if (context == nullptr) {
+            return nullptr;
+        }
+        Node *function = make(Node::Kind::Function, name->text, {context});
+        function->tail = labels.empty() ? "()" : labels;
+        return function;
+    }
+    case 'G': return parseBoundGeneric();
+    case 'K': return make(Node::Kind::Annotation, " throws");
+    case 'L': return parsePrivateName();
+    case 'M': return parseMetadata();
+    case 'N': {
+        Node *type = popType();
+        return type != nullptr ? make(Node::Kind::Global, "type metadata for ", {type}) : nullptr;
+    }
+    case 'Q': return parseDependentMember();
+    case 'R': return parseRequirement();
+    case 'S': return parseStandardSubstitution();
+    case 'T': return parseThunk();
+    case 'W': return parseWitness();
+    case 'Y':
+        if (consume('a')) {
+            return make(Node::Kind::Annotation, " async");
+        }
+        if (consume('b')) {
+            return make(Node::Kind::Annotation, {});
+        }
+        return nullptr;
+    case 'Z': {
+        Node *entity = !stack_.empty() && isEntity(stack_.back()) ? pop() : nullptr;
+        return entity != nullptr ? make(Node::Kind::Static, {}, {entity}) : nullptr;
+    }
+    case '_': return make(Node::Kind::FirstElementMarker);
+    case 'c': return popFunctionType();
+    case 'd': return make(Node::Kind::VariadicMarker);
+    case 'f': return parseFunctionEntity();
+    case 'h':
+    case 'n':
+    case 'z': {
+        Node *type = popType();
+        const char *modifier = character == 'z' ? "inout " : character == 'n' ? "__owned " : "__shared ";
+        return type != nullptr ? make(Node::Kind::Modified, modifier, {type}) : nullptr;
+    }
+    case 'i': {
+        pop(Node::Kind::DeclName);
+        Node *type = popType();
+        std::string labels;
+        if (type == nullptr || !popLabels(type, labels)) {
+            return nullptr;
+        }
+        Node *context = popContext();
+        if (context == nullptr) {
+            return nullptr;
+        }
+        Node *subscript = make(Node::Kind::Subscript, {}, {context});
+        subscript->tail = labels;
+        return parseAccessor(subscript);
+    }
+    case 'l': return parseGenericSignature(false);
+    case 'r': return parseGenericSignature(true);
+    case 'm': {
+        Node *type = popType();
+        return type != nullptr ? make(Node::Kind::Metatype, {}, {type}) : nullptr;
+    }
+    case 'o': return parseOperatorName();
+    case 'p': {
+        Node *existential = make(Node::Kind::Existential);
+        if (pop(Node::Kind::EmptyList) != nullptr) {
+            return existential;
+        }
+        bool isFirst = false;
+        do {
+            isFirst = pop(Node::Kind::FirstElementMarker) != nullptr;
+            Node *protocol = popProtocol();
+            if (protocol == nullptr) {
+                return nullptr;
+            }
+            existential->children.push_back(protocol);
+        } while (!isFirst);
+        std::reverse(existential->children.begin(), existential->children.end());
+        return existential;
+    }
+    case 'q': return parseGenericParamIndex();
+    case 's': return make(Node::Kind::Module, "Swift");
+    case 't': return popTuple();
+    case 'v': {
+        Node *type = popType();
+        std::string labels;
+        if (type == nullptr || !popLabels(type, labels)) {
+            return nullptr;
+        }
+        Node *name = popName();
+        Node *context = name != nullptr ? popContext() : nullptr;
+        if (context == nullptr) {
+            return nullptr;
+        }
+        return parseAccessor(make(Node::Kind::Variable, name->text, {context}));
+    }
+    case 'x': return make(Node::Kind::GenericParam, "A");
+    case 'y': return make(Node::Kind::EmptyList);
+    default:
+        if (isDigit(character)) {
+            --position_;
+            return parseIdentifier();
+        }
+        return nullptr;
+    }
+}
+
+/// Identifiers are a length and the characters, or, after a '0', a mix of
+/// such literals and single letters that reference words of earlier
+/// identifiers ("0" terminates the mix).
+Node *Parser::parseIdentifier() {
+    bool hasWordSubstitutions = false;
+    if (consume('0')) {
+        if (look() == '0') {
+            return nullptr; // punycode-encoded Unicode identifier
+        }
+        hasWordSubstitutions = true;
+    }
+
+    std::string identifier;
+    do {
+        while (hasWordSubstitutions && (isLower(look()) || isUpper(look()))) {
+            const char character = next();
+            const size_t word = isLower(character) ? static_cast<size_t>(character - 'a')
+                                                   : static_cast<size_t>(character - 'A');
+            if (isUpper(character)) {
+                hasWordSubstitutions = false;
+            }
+            if (word >= words_.size()) {
+                return nullptr;
+            }
+            identifier.append(words_[word]);
+        }
+        if (consume('0')) {
+            break;
+        }
+        size_t length = 0;
+        if (!parseNatural(length) || length == 0 || length > text_.size() - position_) {
+            return nullptr;
+        }
+        const std::string_view literal = text_.substr(position_, length);
+        position_ += length;
+        identifier.append(literal);
+
+        // Words start at a letter and end before '_' or an uppercase letter
+        // that follows a lowercase one.
+        size_t wordStart = std::string_view::npos;
+        for (size_t index = 0; index <= literal.size(); ++index) {
+            const char character = index < literal.size() ? literal[index] : '\0';
+            if (wordStart != std::string_view::npos &&
+                (character == '_' || character == '\0' || (!isUpper(literal[index - 1]) && isUpper(character)))) {
+                if (index - wordStart >= 2 && words_.size() < 26) {
+                    words_.emplace_back(literal.substr(wordStart, index - wordStart));
+                }
+                wordStart = std::string_view::npos;
+            }
+            if (wordStart == std::string_view::npos && !isDigit(character) && character != '_' && character != '\0') {
+                wordStart = index;
+            }
+        }
+    } while (hasWordSubstitutions);
+
+    if (identifier.empty()) {
+        return nullptr;
+    }
+    Node *node = make(Node::Kind::Identifier, std::move(identifier));
+    substitutions_.push_back(node);
+    return node;
+}
+
+/// Operators are spelled with letters standing for their characters,
+/// followed by the fixity.
+Node *Parser::parseOperatorName() {
+    static const char kCharacters[] = "& @/= >    <*!|+?%-~   ^ .";
+    Node *identifier = pop(Node::Kind::Identifier);
+    if (identifier == nullptr) {
+        return nullptr;
+    }
+    std::string name;
+    for (const char character : identifier->text) {
+        if (static_cast<signed char>(character) < 0) {
+            name.push_back(character);
+            continue;
+        }
+        if (!isLower(character) || kCharacters[character - 'a'] == ' ') {
+            return nullptr;
+        }
+        name.push_back(kCharacters[character - 'a']);
+    }
+    switch (next()) {
+    case 'i': return make(Node::Kind::DeclName, name + " infix");
+    case 'p': return make(Node::Kind::DeclName, name + " prefix");
+    case 'P': return make(Node::Kind::DeclName, name + " postfix");
+    default: return nullptr;
+    }
+}
+
+/// "A" followed by lowercase letters, each pushing an earlier
+/// substitution (repeated when preceded by a count), and a final
+/// uppercase letter or index returning one.
+Node *Parser::parseMultiSubstitutions() {
+    bool hasCount = false;
+    size_t count = 0;
+    for (;;) {
+        const char character = next();
+        if (isLower(character) || isUpper(character)) {
+            const size_t index = static_cast<size_t>(character - (isLower(character) ? 'a' : 'A'));
+            if (index >= substitutions_.size()) {
+                return nullptr;
+            }
+            Node *node = substitutions_[index];
+            for (size_t copy = 1; hasCount && copy < count; ++copy) {
+                push(node);
+            }
+            if (isUpper(character)) {
+                return node;
+            }
+            push(node);
+            hasCount = false;
+        } else if (character == '_') {
+            const size_t index = hasCount ? count + 27 : 26;
+            return index < substitutions_.size() ? substitutions_[index] : nullptr;
+        } else if (isDigit(character)) {
+            --position_;
+            if (!parseNatural(count) || count > 2048) {
+                return nullptr;
+            }
+            hasCount = true;
+        } else {
+            return nullptr;
+        }
+    }
+}
+
+Node *Parser::parseStandardSubstitution() {
+    if (consume('o')) {
+        return make(Node::Kind::Module, "__C");
+    }
+    if (consume('C')) {
+        return make(Node::Kind::Module, "__C_Synthesized");
+    }
+    if (consume('g')) {
+        Node *type = popType();
+        if (type == nullptr) {
+            return nullptr;
+        }
+        Node *optional = make(Node::Kind::Nominal, "Optional", {make(Node::Kind::Module, "Swift")});
+        optional->tag = 'O';
+        Node *bound = make(Node::Kind::BoundGeneric, {}, {optional, type});
+        substitutions_.push_back(bound);
+        return bound;
+    }
+
+    struct Standard {
+        char code;
+        char tag;
+        const char *name;
+    };
+    static const Standard kStandard[] = {
+        {'A', 'V', "AutoreleasingUnsafeMutablePointer"}, {'a', 'V', "Array"}, {'B', 'P', "BinaryFloatingPoint"},
+        {'b', 'V', "Bool"}, {'D', 'V', "Dictionary"}, {'d', 'V', "Double"}, {'E', 'P', "Encodable"},
+        {'e', 'P', "Decodable"}, {'F', 'P', "FloatingPoint"}, {'f', 'V', "Float"},
+        {'G', 'P', "RandomNumberGenerator"}, {'H', 'P', "Hashable"}, {'h', 'V', "Set"},
+        {'I', 'V', "DefaultIndices"}, {'i', 'V', "Int"}, {'J', 'V', "Character"}, {'j', 'P', "Numeric"},
+        {'K', 'P', "BidirectionalCollection"}, {'k', 'P', "RandomAccessCollection"}, {'L', 'P', "Comparable"},
+        {'l', 'P', "Collection"}, {'M', 'P', "MutableCollection"}, {'m', 'P', "RangeReplaceableCollection"},
+        {'N', 'V', "ClosedRange"}, {'n', 'V', "Range"}, {'O', 'V', "ObjectIdentifier"}, {'P', 'V', "UnsafePointer"},
+        {'p', 'V', "UnsafeMutablePointer"}, {'Q', 'P', "Equatable"}, {'q', 'O', "Optional"},
+        {'R', 'V', "UnsafeBufferPointer"}, {'r', 'V', "UnsafeMutableBufferPointer"}, {'S', 'V', "String"},
+        {'s', 'V', "Substring"}, {'T', 'P', "Sequence"}, {'t', 'P', "IteratorProtocol"},
+        {'U', 'P', "UnsignedInteger"}, {'u', 'V', "UInt"}, {'V', 'V', "UnsafeRawPointer"},
+        {'v', 'V', "UnsafeMutableRawPointer"}, {'W', 'V', "UnsafeRawBufferPointer"},
+        {'w', 'V', "UnsafeMutableRawBufferPointer"}, {'X', 'P', "RangeExpression"}, {'x', 'P', "Strideable"},
+        {'Y', 'P', "RawRepresentable"}, {'y', 'P', "StringProtocol"}, {'Z', 'P', "SignedInteger"},
+        {'z', 'P', "BinaryInteger"},
+    };
+
+    size_t repeat = 1;
+    if (isDigit(look()) && (!parseNatural(repeat) || repeat > 2048)) {
+        return nullptr;
+    }
+    const char code = next();
+    for (const auto &standard : kStandard) {
+        if (standard.code == code) {
+            Node *type = make(Node::Kind::Nominal, standard.name, {make(Node::Kind::Module, "Swift")});
+            type->tag = standard.tag;
+            for (size_t copy = 1; copy < repeat; ++copy) {
+                push(type);
+            }
+            return type;
+        }
+    }
+    return nullptr; // includes the second-level "Sc" concurrency types
+}
+
+Node *Parser::parseNominal(char tag) {
+    Node *name = popName();
+    Node *context = name != nullptr ? popContext() : nullptr;
+    if (context == nullptr) {
+        return nullptr;
+    }
+    Node *type = make(Node::Kind::Nominal, name->text, {context});
+    type->tag = tag;
+    substitutions_.push_back(type);
+    return type;
+}
+
+/// Generic arguments come as one list per generic level, innermost first,
+/// separated by '_' and started by the empty list marker.
+Node *Parser::parseBoundGeneric() {
+    std::vector<std::vector<Node *>> levels;
+    for (;;) {
+        std::vector<Node *> arguments;
+        while (Node *type = popType()) {
+            arguments.insert(arguments.begin(), type);
+        }
+        levels.push_back(std::move(arguments));
+        if (pop(Node::Kind::EmptyList) != nullptr) {
+            break;
+        }
+        if (pop(Node::Kind::FirstElementMarker) == nullptr) {
+            return nullptr;
+        }
+    }
+    Node *nominal = popType();
+    if (nominal == nullptr || nominal->kind != Node::Kind::Nominal) {
+        return nullptr;
+    }
+
+    // Outer levels bind the generic parameters of enclosing types.
+    Node *current = nominal;
+    std::vector<Node *> chain;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        chain.push_back(current);
+        if (level + 1 < levels.size()) {
+            current = current->children[0];
+            if (current->kind != Node::Kind::Nominal) {
+                return nullptr;
+            }
+        }
+    }
+    Node *context = nullptr;
+    for (size_t level = levels.size(); level > 0; --level) {
+        Node *type = chain[level - 1];
+        if (context != nullptr) {
+            Node *copy = make(type->kind, type->text, {context});
+            copy->tag = type->tag;
+            type = copy;
+        }
+        if (!levels[level - 1].empty()) {
+            type = make(Node::Kind::BoundGeneric, {}, {type});
+            type->children.insert(type->children.end(), levels[level - 1].begin(), levels[level - 1].end());
+        }
+        context = type;
+    }
+    substitutions_.push_back(context);
+    return context;
+}
+
+/// "LL" private names drop their file discriminator; "L" local names
+/// their index.
+Node *Parser::parsePrivateName() {
+    if (consume('L')) {
+        Node *discriminator = pop(Node::Kind::Identifier);
+        Node *name = discriminator != nullptr ? popName() : nullptr;
+        return name != nullptr ? make(Node::Kind::DeclName, name->text) : nullptr;
+    }
+    size_t index = 0;
+    if (!parseIndex(index)) {
+        return nullptr;
+    }
+    Node *name = popName();
+    return name != nullptr ? make(Node::Kind::DeclName, name->text) : nullptr;
+}
+
+/// Entities spelled "f" plus a kind: constructors, destructors, closures
+/// and the implicit functions attached to declarations.
+Node *Parser::parseFunctionEntity() {
+    const char kind = next();
+    std::string name;
+    std::string labels;
+    size_t index = 0;
+    switch (kind) {
+    case 'C':
+    case 'c': {
+        pop(Node::Kind::DeclName);
+        Node *type = popType();
+        if (type == nullptr || !popLabels(type, labels)) {
+            return nullptr;
+        }
+        break;
+    }
+    case 'U':
+    case 'u': {
+        if (!parseIndex(index) || popType() == nullptr) {
+            return nullptr;
+        }
+        name = (kind == 'U' ? "closure #" : "implicit closure #") + std::to_string(index + 1);
+        break;
+    }
+    case 'A':
+        if (!parseIndex(index)) {
+            return nullptr;
+        }
+        name = "default argument " + std::to_string(index) + " of ";
+        break;
+    case 'D': name = "__deallocating_deinit"; break;
+    case 'd': name = "deinit"; break;
+    case 'E': name = "__ivar_destroyer"; break;
+    case 'e': name = "__ivar_initializer"; break;
+    case 'i': name = "variable initialization expression of "; break;
+    case 'P': name = "property wrapper backing initializer of "; break;
+    default: return nullptr;
+    }
+
+    Node *context = popContext();
+    if (context == nullptr) {
+        return nullptr;
+    }
+    switch (kind) {
+    case 'C':
+    case 'c': {
+        // Classes allocate in a separate entry point; value types do not.
+        const bool isClass = context->kind == Node::Kind::Nominal && context->tag == 'C';
+        Node *constructor = make(Node::Kind::Constructor, kind == 'C' && isClass ? "__allocating_init" : "init", {context});
+        constructor->tail = labels.empty() ? "()" : labels;
+        return constructor;
+    }
+    case 'U':
+    case 'u': return make(Node::Kind::Closure, std::move(name), {context});
+    case 'A':
+    case 'i':
+    case 'P': return make(Node::Kind::Global, std::move(name), {context});
+    default: return make(Node::Kind::Variable, std::move(name), {context});
+    }
+}
+
+Node *Parser::parseAccessor(Node *storage) {
+    const char *accessor = nullptr;
+    switch (next()) {
+    case 'p': return storage;
+    case 'g':
+    case 'G': accessor = "getter"; break;
+    case 's': accessor = "setter"; break;
+    case 'm': accessor = "materializeForSet"; break;
+    case 'r': accessor = "read"; break;
+    case 'M': accessor = "modify"; break;
+    case 'w': accessor = "willset"; break;
+    case 'W': accessor = "didset"; break;
+    case 'i': accessor = "init"; break;
+    case 'a':
+        accessor = "unsafeMutableAddressor";
+        if (!consume('u')) {
+            return nullptr; // owning addressors predate Swift 5
+        }
+        break;
+    case 'l':
+        accessor = "unsafeAddressor";
+        if (!consume('u')) {
+            return nullptr;
+        }
+        break;
+    default: return nullptr;
+    }
+    return make(Node::Kind::Accessor, accessor, {storage});
+}
+
+/// Requirements only need to be consumed: the simplified form leaves out
+/// generic signatures.
+Node *Parser::parseRequirement() {
+    enum class Subject { Param, Associated, Substitution } subject = Subject::Param;
+    enum class Constraint { Protocol, Type, Layout } constraint = Constraint::Protocol;
+    switch (look()) {
+    case 'b': constraint = Constraint::Type; break;
+    case 'B': constraint = Constraint::Type; subject = Subject::Substitution; break;
+    case 'c': constraint = Constraint::Type; subject = Subject::Associated; break;
+    case 's': constraint = Constraint::Type; break;
+    case 'S': constraint = Constraint::Type; subject = Subject::Substitution; break;
+    case 't': constraint = Constraint::Type; subject = Subject::Associated; break;
+    case 'l': constraint = Constraint::Layout; break;
+    case 'L': constraint = Constraint::Layout; subject = Subject::Substitution; break;
+    case 'm': constraint = Constraint::Layout; subject = Subject::Associated; break;
+    case 'p': subject = Subject::Associated; break;
+    case 'Q': subject = Subject::Substitution; break;
+    case 'C':
+    case 'M':
+    case 'P':
+    case 'T':
+    case 'h':
+    case 'v': return nullptr; // compound associated types, packs and same-shape
+    default: --position_; break;
+    }
+    ++position_;
+
+    switch (subject) {
+    case Subject::Param:
+        if (parseGenericParamIndex() == nullptr) {
+            return nullptr;
+        }
+        break;
+    case Subject::Associated: {
+        Node *param = parseGenericParamIndex();
+        Node *member = param != nullptr ? popAssociatedType(param) : nullptr;
+        if (member == nullptr) {
+            return nullptr;
+        }
+        substitutions_.push_back(member);
+        break;
+    }
+    case Subject::Substitution:
+        if (popType() == nullptr) {
+            return nullptr;
+        }
+        break;
+    }
+
+    switch (constraint) {
+    case Constraint::Protocol:
+        if (popProtocol() == nullptr) {
+            return nullptr;
+        }
+        break;
+    case Constraint::Type:
+        if (popType() == nullptr) {
+            return nullptr;
+        }
+        break;
+    case Constraint::Layout: {
+        const char layout = next();
+        size_t size = 0;
+        if (layout == 'e' || layout == 'E' || layout == 'm' || layout == 'M') {
+            if (!parseIndex(size) || ((layout == 'E' || layout == 'M') && !parseIndex(size))) {
+                return nullptr;
+            }
+        } else if (layout != 'U' && layout != 'R' && layout != 'N' && layout != 'C' && layout != 'D' &&
+                   layout != 'T') {
+            return nullptr;
+        }
+        break;
+    }
+    }
+    return make(Node::Kind::Requirement);
+}
+
+Node *Parser::parseGenericSignature(bool hasParamCounts) {
+    while (hasParamCounts && !consume('l')) {
+        size_t count = 0;
+        if (!consume('z') && !parseIndex(count)) {
+            return nullptr;
+        }
+    }
+    while (pop(Node::Kind::Requirement) != nullptr) {
+    }
+    return make(Node::Kind::GenericSignature);
+}
+
+Node *Parser::parseThunk() {
+    const char kind = next();
+    const char *attribute = nullptr;
+    switch (kind) {
+    case 'A': attribute = "partial apply for "; break;
+    case 'D': attribute = "dynamic "; break;
+    case 'O': attribute = "@nonobjc "; break;
+    case 'j': attribute = "dispatch thunk of "; break;
+    case 'm': attribute = "merged "; break;
+    case 'o': attribute = "@objc "; break;
+    case 'q': attribute = "method descriptor for "; break;
+    case 'u': attribute = "async function pointer to "; break;
+    case 'G':
+    case 'g':
+    case 's': return parseSpecialization(false);
+    case 'f': return parseSpecialization(true);
+    case 'W': {
+        Node *entity = !stack_.empty() && isEntity(stack_.back()) ? pop() : nullptr;
+        Node *type = entity != nullptr ? popConformance() : nullptr;
+        if (type == nullptr) {
+            return nullptr;
+        }
+        Node *witness = make(Node::Kind::Global, "protocol witness for ", {entity});
+        Printer printer;
+        std::string conformer;
+        if (!printer.print(type, conformer)) {
+            return nullptr;
+        }
+        witness->tail = " in conformance " + conformer;
+        return witness;
+    }
+    default: return nullptr; // reabstraction and other thunks
+    }
+    return make(Node::Kind::Attribute, attribute);
+}
+
+/// "Tg", "TG" and "Ts" follow the substituted types; "Tf" describes how
+/// each parameter was rewritten. Either way the result prints as
+/// "specialized" and the details are consumed.
+Node *Parser::parseSpecialization(bool isFunctionSignature) {
+    if (!isFunctionSignature) {
+        if (pop(Node::Kind::EmptyList) == nullptr) {
+            bool isFirst = false;
+            do {
+                isFirst = pop(Node::Kind::FirstElementMarker) != nullptr;
+                if (popType() == nullptr) {
+                    return nullptr;
+                }
+            } while (!isFirst);
+        }
+    }
+    consume('q'); // serialized
+    consume('a'); // async removed
+    if (!isDigit(next())) {
+        return nullptr;
+    }
+    if (isFunctionSignature) {
+        // One code per parameter up to '_', then one for the result. Codes
+        // that carry operands, such as constant propagation, are not supported.
+        static const std::string_view kCodes = "ndgGsxieEoX";
+        bool seenResult = false;
+        for (;;) {
+            const char code = next();
+            if (code == '_') {
+                if (seenResult) {
+                    return nullptr;
+                }
+                seenResult = true;
+                continue;
+            }
+            if (kCodes.find(code) == std::string_view::npos) {
+                return nullptr;
+            }
+            if (seenResult) {
+                break;
+            }
+        }
+    }
+    return make(Node::Kind::Attribute, "specialized ");
+}
+
+Node *Parser::parseMetadata() {
+    const char *description = nullptr;
+    Node *subject = nullptr;
+    switch (next()) {
+    case 'a': description = "type metadata accessor for "; subject = popType(); break;
+    case 'f': description = "full type metadata for "; subject = popType(); break;
+    case 'n': description = "nominal type descriptor for "; subject = popType(); break;
+    case 'p': description = "protocol descriptor for "; subject = popProtocol(); break;
+    case 'c': description = "protocol conformance descriptor for "; subject = popConformance(); break;
+    default: return nullptr;
+    }
+    return subject != nullptr ? make(Node::Kind::Global, description, {subject}) : nullptr;
+}
+
+Node *Parser::parseWitness() {
+    if (consume('P')) {
+        Node *type = popConformance();
+        return type != nullptr ? make(Node::Kind::Global, "protocol witness table for ", {type}) : nullptr;
+    }
+    if (!consume('O')) {
+        return nullptr;
+    }
+    const char *operation = nullptr;
+    switch (next()) {
+    case 'b': operation = "outlined init with take of "; break;
+    case 'c': operation = "outlined init with copy of "; break;
+    case 'd': operation = "outlined assign with take of "; break;
+    case 'e': operation = "outlined consume of "; break;
+    case 'f': operation = "outlined assign with copy of "; break;
+    case 'h': operation = "outlined destroy of "; break;
+    case 'r': operation = "outlined retain of "; break;
+    case 's': operation = "outlined release of "; break;
+    case 'y': operation = "outlined copy of "; break;
+    default: return nullptr;
+    }
+    pop(Node::Kind::GenericSignature);
+    Node *type = popType();
+    return type != nullptr ? make(Node::Kind::Global, operation, {type}) : nullptr;
+}
+
+Node *Parser::parseDependentMember() {
+    Node *base = nullptr;
+    switch (next()) {
+    case 'x': break;
+    case 'y':
+        base = parseGenericParamIndex();
+        if (base == nullptr) {
+            return nullptr;
+        }
+        break;
+    case 'z': base = make(Node::Kind::GenericParam, "A"); break;
+    default: return nullptr; // opaque and compound associated types
+    }
+    Node *member = popAssociatedType(base);
+    if (member != nullptr) {
+        substitutions_.push_back(member);
+    }
+    return member;
+}
+
+bool Parser::parse(std::string &out) {
+    while (position_ < text_.size()) {
+        Node *node = parseOperator();
+        if (node == nullptr || stack_.size() > kMaxStackSize) {
+            return false;
+        }
+        push(node);
+    }
+
+    // Attributes such as "merged" apply to everything below them.
+    std::string attributes;
+    while (Node *attribute = pop(Node::Kind::Attribute)) {
+        attributes.append(attribute->text);
+    }
+    if (stack_.size() != 1 || !(isEntity(stack_[0]) || isType(stack_[0]))) {
+        return false;
+    }
+
+    Printer printer;
+    std::string result;
+    if (!printer.print(stack_[0], result) || result.empty()) {
+        return false;
+    }
+    out = attributes + result;
+    return true;
+}
+
+} // namespace
+
+bool demangleSwift(std::string_view mangled, std::string &out) {
+    if (!mangled.empty() && mangled.front() == '_') {
+        mangled.remove_prefix(1);
+    }
+    if (mangled.size() < 3 || mangled[0] != '$' || (mangled[1] != 's' && mangled[1] != 'S')) {
+        return false;
+    }
+    Parser parser(mangled.substr(2));
+    return parser.parse(out);
+}
+
+} // namespace symbolicator
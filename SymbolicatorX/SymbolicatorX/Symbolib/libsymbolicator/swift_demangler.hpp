@@ -0,0 +1,26 @@
+//
+//  swift_demangler.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_SWIFT_DEMANGLER_HPP
+#define SYMBOLICATOR_SWIFT_DEMANGLER_HPP
+
+#include <string>
+#include <string_view>
+
+namespace symbolicator {
+
+/// Demangles a Swift 5 symbol ("$s...", "_$s..." and the pre-ABI-stability
+/// "$S" forms) into the simplified form atos prints: no module names,
+/// parameter labels instead of types, e.g. "closure #1 in Foo.bar(x:)".
+/// Returns false and leaves `out` alone for older manglings and constructs
+/// it does not implement, such as reabstraction thunks.
+bool demangleSwift(std::string_view mangled, std::string &out);
+
+} // namespace symbolicator
+
+#endif
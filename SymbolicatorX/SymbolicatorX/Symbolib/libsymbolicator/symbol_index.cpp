@@ -0,0 +1,556 @@
+//
+//  symbol_index.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "symbol_index.hpp"
+
+#include <algorithm>
+
+#include "dwarf_reader.hpp"
+#include "error.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+/// Index of the last of `count` items sorted by `key` whose key is at most
+/// `value`, or `count` when there is none. The loop runs the same log2(count)
+/// steps for every value and picks each half with a conditional move rather
+/// than a branch, so random frame addresses cause no mispredictions.
+template <typename T, typename Key>
+size_t lastAtOrBefore(const T *items, size_t count, uint64_t value, Key key) {
+    if (count == 0 || value < key(items[0])) {
+        return count;
+    }
+    const T *base = items;
+    size_t remaining = count;
+    while (remaining > 1) {
+        const size_t half = remaining / 2;
+        base = key(base[half]) <= value ? base + half : base;
+        remaining -= half;
+    }
+    return static_cast<size_t>(base - items);
+}
+
+/// `lastAtOrBefore` for a `value` no smaller than the key at `from`, the
+/// answer for the previous address of a sorted batch (or `count`). Gallops
+/// forward from there, so the cost grows with the distance covered rather
+/// than with the size of the table.
+template <typename T, typename Key>
+size_t lastAtOrBeforeFrom(const T *items, size_t count, size_t from, uint64_t value, Key key) {
+    if (from >= count) {
+        return lastAtOrBefore(items, count, value, key);
+    }
+    size_t low = from;
+    size_t step = 1;
+    while (step < count - low && key(items[low + step]) <= value) {
+        low += step;
+        step *= 2;
+    }
+    const size_t high = step < count - low ? low + step : count;
+    return low + lastAtOrBefore(items + low, high - low, value, key);
+}
+
+/// One address of a batch and where its result goes.
+struct Probe {
+    uint64_t address;
+    size_t slot;
+};
+
+/// Stable LSD radix sort by address, a byte per pass. Only the bytes in
+/// which the addresses differ from the smallest one are sorted on, so a
+/// batch within one image takes three or four passes rather than eight.
+void radixSort(std::vector<Probe> &probes) {
+    uint64_t low = UINT64_MAX;
+    uint64_t high = 0;
+    for (const auto &probe : probes) {
+        low = std::min(low, probe.address);
+        high = std::max(high, probe.address);
+    }
+
+    std::vector<Probe> scratch(probes.size());
+    for (unsigned shift = 0; shift < 64 && ((high - low) >> shift) != 0; shift += 8) {
+        size_t offsets[256] = {};
+        for (const auto &probe : probes) {
+            ++offsets[((probe.address - low) >> shift) & 0xff];
+        }
+        size_t total = 0;
+        for (auto &offset : offsets) {
+            const size_t bucket = offset;
+            offset = total;
+            total += bucket;
+        }
+        for (const auto &probe : probes) {
+            scratch[offsets[((probe.address - low) >> shift) & 0xff]++] = probe;
+        }
+        probes.swap(scratch);
+    }
+}
+
+uint64_t functionStart(uint64_t start) {
+    return start;
+}
+
+uint64_t rowAddress(const LineRow &row) {
+    return row.address;
+}
+
+uint64_t rangeStart(const LazyLineTable::Range &range) {
+    return range.start;
+}
+
+} // namespace
+
+uint32_t LazyLineTable::addUnit(LineDecoder decoder) {
+    const auto unit = static_cast<uint32_t>(units_.size());
+    units_.emplace_back().decode = std::move(decoder);
+    return unit;
+}
+
+void LazyLineTable::addRange(uint64_t start, uint64_t end, uint32_t unit) {
+    if (start < end && unit < units_.size()) {
+        ranges_.push_back({start, end, unit});
+    }
+}
+
+void LazyLineTable::addDecodedRanges(uint32_t unit) {
+    const Span<LineRow> unitRows = rows(unit);
+    size_t sequenceStart = 0;
+    for (size_t row = 0; row < unitRows.size; ++row) {
+        if (unitRows[row].line == 0) {
+            addRange(unitRows[sequenceStart].address, unitRows[row].address, unit);
+            sequenceStart = row + 1;
+        }
+    }
+}
+
+void LazyLineTable::finish() {
+    std::sort(ranges_.begin(), ranges_.end(), [](const Range &lhs, const Range &rhs) { return lhs.start < rhs.start; });
+}
+
+const LazyLineTable::Range *LazyLineTable::range(uint64_t address) const {
+    const size_t range = lastAtOrBefore(ranges_.data(), ranges_.size(), address, rangeStart);
+    return range < ranges_.size() && address < ranges_[range].end ? &ranges_[range] : nullptr;
+}
+
+Span<LineRow> LazyLineTable::rows(uint32_t unit) const {
+    Unit &state = units_[unit];
+    std::call_once(state.decoded, [&] {
+        std::vector<std::vector<LineRow>> sequences;
+        try {
+            state.decode(sequences);
+        } catch (const Error &) {
+            // Too late to fail opening the image; the unit keeps the
+            // sequences that ended before its line program went wrong.
+        }
+        std::stable_sort(sequences.begin(), sequences.end(),
+                         [](const std::vector<LineRow> &lhs, const std::vector<LineRow> &rhs) {
+                             return lhs.front().address < rhs.front().address;
+                         });
+        for (const auto &sequence : sequences) {
+            state.rows.insert(state.rows.end(), sequence.begin(), sequence.end());
+        }
+        state.decode = nullptr;
+        decodedUnits_.fetch_add(1, std::memory_order_relaxed);
+    });
+    return {state.rows.data(), state.rows.size()};
+}
+
+const LineRow *LazyLineTable::find(uint64_t address) const {
+    const Range *found = range(address);
+    if (found == nullptr) {
+        return nullptr;
+    }
+    const Span<LineRow> unitRows = rows(found->unit);
+    const size_t row = lastAtOrBefore(unitRows.data, unitRows.size, address, rowAddress);
+    return row < unitRows.size ? &unitRows[row] : nullptr;
+}
+
+void LazyStringPool::addBlock(uint64_t offset, BlockDecoder decoder) {
+    Block &block = blocks_.emplace_back();
+    block.offset = offset;
+    block.decode = std::move(decoder);
+}
+
+const char *LazyStringPool::at(uint64_t offset) const {
+    auto after = std::upper_bound(blocks_.begin(), blocks_.end(), offset,
+                                  [](uint64_t value, const Block &block) { return value < block.offset; });
+    if (after == blocks_.begin()) {
+        return "";
+    }
+    Block &block = *std::prev(after);
+    std::call_once(block.decoded, [&] {
+        try {
+            block.decode(block.bytes);
+        } catch (const Error &) {
+            block.bytes.clear();
+        }
+        // A block cut short still ends its last string.
+        if (!block.bytes.empty() && block.bytes.back() != '\0') {
+            block.bytes.push_back('\0');
+        }
+        block.decode = nullptr;
+        decodedBlocks_.fetch_add(1, std::memory_order_relaxed);
+    });
+    const uint64_t position = offset - block.offset;
+    return position < block.bytes.size() ? block.bytes.data() + position : "";
+}
+
+SymbolIndex SymbolIndex::build(const MachOFile &file) {
+    SymbolIndexBuilder builder;
+    DwarfReader(file).read(builder);
+
+    for (const auto &symbol : file.symbols()) {
+        builder.addSymbol(symbol.address, symbol.name);
+    }
+
+    return builder.finish();
+}
+
+SymbolIndex SymbolIndex::buildLazily(std::shared_ptr<const MachOFile> file) {
+    auto lines = std::make_shared<LazyLineTable>(file);
+    SymbolIndexBuilder builder;
+    DwarfReader(*file, lines.get()).read(builder);
+    lines->finish();
+
+    for (const auto &symbol : file->symbols()) {
+        builder.addSymbol(symbol.address, symbol.name);
+    }
+
+    SymbolIndex index = builder.finish();
+    index.lazyLines_ = std::move(lines);
+    return index;
+}
+
+SymbolIndex SymbolIndex::view(std::shared_ptr<const void> storage, const Arrays &arrays,
+                              std::shared_ptr<const LazyLineTable> lines, std::shared_ptr<const LazyStringPool> strings) {
+    SymbolIndex index;
+    index.storage_ = std::move(storage);
+    index.arrays_ = arrays;
+    index.lazyLines_ = std::move(lines);
+    index.lazyStrings_ = std::move(strings);
+    return index;
+}
+
+size_t SymbolIndex::findFunction(uint64_t address) const {
+    const Span<uint64_t> &starts = arrays_.functionStarts;
+    const size_t function = lastAtOrBefore(starts.data, starts.size, address, functionStart);
+    return function < starts.size && address < arrays_.functionEnds[function] ? function : starts.size;
+}
+
+SymbolLookup SymbolIndex::resolve(uint64_t address, size_t function, const LineRow *row) const {
+    SymbolLookup result;
+    if (function < functionCount() && address < arrays_.functionEnds[function]) {
+        result.function = string(arrays_.functionNames[function]);
+        result.functionStart = arrays_.functionStarts[function];
+    }
+
+    if (row != nullptr && row->line != 0 && row->file < arrays_.files.size && arrays_.files[row->file] != 0) {
+        result.file = string(arrays_.files[row->file]);
+        result.line = row->line;
+    }
+    return result;
+}
+
+SymbolLookup SymbolIndex::lookup(uint64_t address) const {
+    const Span<uint64_t> &starts = arrays_.functionStarts;
+    const size_t function = lastAtOrBefore(starts.data, starts.size, address, functionStart);
+    if (lazyLines_ != nullptr) {
+        return resolve(address, function, lazyLines_->find(address));
+    }
+
+    const Span<LineRow> &lines = arrays_.lines;
+    const size_t row = lastAtOrBefore(lines.data, lines.size, address, rowAddress);
+    return resolve(address, function, row < lines.size ? &lines[row] : nullptr);
+}
+
+void SymbolIndex::lookup(const uint64_t *addresses, size_t count, SymbolLookup *results) const {
+    // Deferred line tables are searched a unit at a time, so for them only
+    // the size of the function table counts.
+    if (count < kMergeJoinThreshold || std::max(functionCount(), arrays_.lines.size) < kMergeJoinMinimumRows) {
+        for (size_t index = 0; index < count; ++index) {
+            results[index] = lookup(addresses[index]);
+        }
+        return;
+    }
+
+    std::vector<Probe> probes(count);
+    for (size_t index = 0; index < count; ++index) {
+        probes[index] = {addresses[index], index};
+    }
+    if (count >= kRadixSortThreshold) {
+        radixSort(probes);
+    } else {
+        std::sort(probes.begin(), probes.end(), [](const Probe &lhs, const Probe &rhs) { return lhs.address < rhs.address; });
+    }
+
+    // Deferred line tables are swept one unit at a time, moving to the next
+    // unit when an address leaves the range of the current one.
+    const Span<uint64_t> &starts = arrays_.functionStarts;
+    Span<LineRow> lines = arrays_.lines;
+    const LazyLineTable::Range *unitRange = nullptr;
+    size_t function = starts.size;
+    size_t row = lines.size;
+    for (const auto &probe : probes) {
+        function = lastAtOrBeforeFrom(starts.data, starts.size, function, probe.address, functionStart);
+        if (lazyLines_ != nullptr && (unitRange == nullptr || probe.address >= unitRange->end)) {
+            unitRange = lazyLines_->range(probe.address);
+            lines = unitRange != nullptr ? lazyLines_->rows(unitRange->unit) : Span<LineRow>();
+            row = lines.size;
+        }
+        row = lastAtOrBeforeFrom(lines.data, lines.size, row, probe.address, rowAddress);
+        results[probe.slot] = resolve(probe.address, function, row < lines.size ? &lines[row] : nullptr);
+    }
+}
+
+void SymbolIndex::lookupInlined(uint64_t address, std::vector<SymbolLookup> &chain) const {
+    const SymbolLookup outer = lookup(address);
+
+    const Span<InlineRange> &ranges = arrays_.inlineRanges;
+    const size_t range = lastAtOrBefore(ranges.data, ranges.size, address,
+                                        [](const InlineRange &inlined) { return inlined.start; });
+    if (outer.function == nullptr || range == ranges.size || address >= ranges[range].end) {
+        chain.push_back(outer);
+        return;
+    }
+
+    // The line table gives the position in the innermost call; each call
+    // site gives the position one level further out. The depth bound only
+    // guards against a corrupt cache file with a parent cycle.
+    const Span<InlineSite> &sites = arrays_.inlineSites;
+    SymbolLookup frame = outer;
+    uint32_t site = ranges[range].site;
+    for (size_t depth = 0; site < sites.size && depth < sites.size; ++depth) {
+        const InlineSite &inlined = sites[site];
+        frame.function = inlined.name != 0 ? string(inlined.name) : nullptr;
+        chain.push_back(frame);
+
+        const bool hasCall = inlined.callLine != 0 && inlined.callFile < arrays_.files.size &&
+                             arrays_.files[inlined.callFile] != 0;
+        frame.file = hasCall ? string(arrays_.files[inlined.callFile]) : nullptr;
+        frame.line = hasCall ? inlined.callLine : 0;
+        site = inlined.parent;
+    }
+    frame.function = outer.function;
+    chain.push_back(frame);
+}
+
+SymbolIndexBuilder::SymbolIndexBuilder() : storage_(std::make_shared<Storage>()) {
+    // Offset 0 is the empty string, used for "no name".
+    storage_->strings.push_back('\0');
+    storage_->files.push_back(0);
+    files_.emplace(std::string(), kUnknownFile);
+}
+
+uint32_t SymbolIndexBuilder::intern(std::string_view string) {
+    if (string.empty()) {
+        return 0;
+    }
+    auto found = strings_.find(string);
+    if (found != strings_.end()) {
+        return found->second;
+    }
+    const auto offset = static_cast<uint32_t>(storage_->strings.size());
+    storage_->strings.append(string.data(), string.size());
+    storage_->strings.push_back('\0');
+    strings_.emplace(string, offset);
+    return offset;
+}
+
+uint32_t SymbolIndexBuilder::file(std::string_view directory, std::string_view name) {
+    std::string path;
+    if (!directory.empty() && (name.empty() || name.front() != '/')) {
+        path.reserve(directory.size() + name.size() + 1);
+        path.append(directory.data(), directory.size());
+        if (path.back() != '/') {
+            path.push_back('/');
+        }
+    }
+    path.append(name.data(), name.size());
+
+    auto found = files_.find(path);
+    if (found != files_.end()) {
+        return found->second;
+    }
+
+    // The path is composed here, so it has to be copied before interning.
+    const auto offset = static_cast<uint32_t>(storage_->strings.size());
+    storage_->strings.append(path);
+    storage_->strings.push_back('\0');
+
+    const auto id = static_cast<uint32_t>(storage_->files.size());
+    storage_->files.push_back(offset);
+    files_.emplace(std::move(path), id);
+    return id;
+}
+
+void SymbolIndexBuilder::addFunction(uint64_t start, uint64_t end, uint32_t name) {
+    if (start < end && name != 0) {
+        functions_.push_back({start, end, name});
+    }
+}
+
+void SymbolIndexBuilder::addSymbol(uint64_t address, std::string_view name) {
+    symbols_.push_back({address, intern(name)});
+}
+
+void SymbolIndexBuilder::addLineSequence(std::vector<LineRow> &&rows) {
+    if (!rows.empty()) {
+        sequences_.push_back(std::move(rows));
+    }
+}
+
+uint32_t SymbolIndexBuilder::addInlineSite(uint32_t callFile, uint32_t callLine, uint32_t parent) {
+    const auto site = static_cast<uint32_t>(storage_->inlineSites.size());
+    storage_->inlineSites.push_back({0, callFile, callLine, parent < site ? parent : kNoInlineSite});
+    return site;
+}
+
+void SymbolIndexBuilder::nameInlineSite(uint32_t site, uint32_t name) {
+    if (site < storage_->inlineSites.size()) {
+        storage_->inlineSites[site].name = name;
+    }
+}
+
+void SymbolIndexBuilder::addInlineRange(uint64_t start, uint64_t end, uint32_t site) {
+    if (start < end && site < storage_->inlineSites.size()) {
+        inlineRanges_.push_back({start, end, site});
+    }
+}
+
+void SymbolIndexBuilder::flattenInlineRanges() {
+    const auto &sites = storage_->inlineSites;
+    std::vector<uint32_t> depths(sites.size());
+    for (size_t site = 0; site < sites.size(); ++site) {
+        depths[site] = sites[site].parent == kNoInlineSite ? 0 : depths[sites[site].parent] + 1;
+    }
+
+    // Outer calls sort before the calls nested in them, so a sweep with a
+    // stack of open ranges sees every address covered by the deepest one.
+    std::sort(inlineRanges_.begin(), inlineRanges_.end(), [&](const InlineRange &lhs, const InlineRange &rhs) {
+        if (lhs.start != rhs.start) {
+            return lhs.start < rhs.start;
+        }
+        return depths[lhs.site] < depths[rhs.site];
+    });
+
+    auto &segments = storage_->inlineRanges;
+    auto emit = [&](uint64_t start, uint64_t end, uint32_t site) {
+        if (!segments.empty() && segments.back().end == start && segments.back().site == site) {
+            segments.back().end = end;
+        } else {
+            segments.push_back({start, end, site});
+        }
+    };
+
+    std::vector<const InlineRange *> open;
+    uint64_t cursor = 0;
+    auto advance = [&](uint64_t limit) {
+        while (!open.empty() && open.back()->end <= limit) {
+            if (cursor < open.back()->end) {
+                emit(cursor, open.back()->end, open.back()->site);
+                cursor = open.back()->end;
+            }
+            open.pop_back();
+        }
+        if (!open.empty() && cursor < limit) {
+            emit(cursor, limit, open.back()->site);
+        }
+        cursor = std::max(cursor, limit);
+    };
+    for (const auto &range : inlineRanges_) {
+        advance(range.start);
+        open.push_back(&range);
+    }
+    advance(UINT64_MAX);
+}
+
+SymbolIndex SymbolIndexBuilder::finish() {
+    auto &functions = functions_;
+    auto byStart = [](const FunctionRange &lhs, const FunctionRange &rhs) { return lhs.start < rhs.start; };
+    std::stable_sort(functions.begin(), functions.end(), byStart);
+    functions.erase(std::unique(functions.begin(), functions.end(),
+                                [](const FunctionRange &lhs, const FunctionRange &rhs) { return lhs.start == rhs.start; }),
+                    functions.end());
+
+    // Symbol table entries only fill the gaps DWARF leaves (stripped static
+    // libraries, hand written assembly). Each one extends to the next symbol
+    // or the next DWARF function, whichever comes first.
+    std::stable_sort(symbols_.begin(), symbols_.end(),
+                     [](const Symbol &lhs, const Symbol &rhs) { return lhs.address < rhs.address; });
+    std::vector<FunctionRange> fillers;
+    for (size_t index = 0; index < symbols_.size(); ++index) {
+        const Symbol &symbol = symbols_[index];
+        if (index + 1 < symbols_.size() && symbols_[index + 1].address == symbol.address) {
+            continue;
+        }
+
+        auto next = std::upper_bound(functions.begin(), functions.end(), symbol.address,
+                                     [](uint64_t value, const FunctionRange &range) { return value < range.start; });
+        if (next != functions.begin() && symbol.address < std::prev(next)->end) {
+            continue;
+        }
+
+        uint64_t end = index + 1 < symbols_.size() ? symbols_[index + 1].address : UINT64_MAX;
+        if (next != functions.end()) {
+            end = std::min(end, next->start);
+        }
+        if (symbol.address < end && symbol.name != 0) {
+            fillers.push_back({symbol.address, end, symbol.name});
+        }
+    }
+    if (!fillers.empty()) {
+        functions.insert(functions.end(), fillers.begin(), fillers.end());
+        std::stable_sort(functions.begin(), functions.end(), byStart);
+    }
+
+    std::stable_sort(sequences_.begin(), sequences_.end(),
+                     [](const std::vector<LineRow> &lhs, const std::vector<LineRow> &rhs) {
+                         return lhs.front().address < rhs.front().address;
+                     });
+    size_t rowCount = 0;
+    for (const auto &sequence : sequences_) {
+        rowCount += sequence.size();
+    }
+    storage_->lines.reserve(rowCount);
+    for (const auto &sequence : sequences_) {
+        storage_->lines.insert(storage_->lines.end(), sequence.begin(), sequence.end());
+    }
+
+    flattenInlineRanges();
+
+    Storage &storage = *storage_;
+    storage.functionStarts.reserve(functions.size());
+    storage.functionEnds.reserve(functions.size());
+    storage.functionNames.reserve(functions.size());
+    for (const auto &function : functions) {
+        storage.functionStarts.push_back(function.start);
+        storage.functionEnds.push_back(function.end);
+        storage.functionNames.push_back(function.name);
+    }
+
+    storage.strings.shrink_to_fit();
+    strings_.clear();
+    files_.clear();
+    functions_ = std::vector<FunctionRange>();
+    symbols_.clear();
+    sequences_.clear();
+    inlineRanges_.clear();
+
+    SymbolIndex::Arrays arrays;
+    arrays.functionStarts = {storage.functionStarts.data(), storage.functionStarts.size()};
+    arrays.functionEnds = {storage.functionEnds.data(), storage.functionEnds.size()};
+    arrays.functionNames = {storage.functionNames.data(), storage.functionNames.size()};
+    arrays.lines = {storage.lines.data(), storage.lines.size()};
+    arrays.files = {storage.files.data(), storage.files.size()};
+    arrays.inlineSites = {storage.inlineSites.data(), storage.inlineSites.size()};
+    arrays.inlineRanges = {storage.inlineRanges.data(), storage.inlineRanges.size()};
+    arrays.strings = storage.strings;
+    return SymbolIndex::view(std::move(storage_), arrays);
+}
+
+} // namespace symbolicator
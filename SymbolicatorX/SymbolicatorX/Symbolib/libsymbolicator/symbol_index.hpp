@@ -0,0 +1,319 @@
+//
+//  symbol_index.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_SYMBOL_INDEX_HPP
+#define SYMBOLICATOR_SYMBOL_INDEX_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "macho_file.hpp"
+
+namespace symbolicator {
+
+/// Half-open [start, end) range of one function; `name` is a string pool
+/// offset. Only used while building: the index splits functions into one
+/// array per field (see `SymbolIndex::Arrays`).
+struct FunctionRange {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint32_t name = 0;
+};
+
+/// File every index starts with: the empty path, for rows and calls whose
+/// line program names no file or a file number it does not have.
+constexpr uint32_t kUnknownFile = 0;
+
+/// One row of a DWARF line table. A row with `line == 0` ends a sequence.
+struct LineRow {
+    uint64_t address = 0;
+    uint32_t file = 0;
+    uint32_t line = 0;
+};
+
+constexpr uint32_t kNoInlineSite = UINT32_MAX;
+
+/// One inlined call: the function that was inlined (`name`, a string pool
+/// offset) and the position of the call, which lies in `parent` or, for
+/// `kNoInlineSite`, directly in the enclosing function. `callLine == 0`
+/// means the position is unknown.
+struct InlineSite {
+    uint32_t name = 0;
+    uint32_t callFile = 0;
+    uint32_t callLine = 0;
+    uint32_t parent = kNoInlineSite;
+};
+
+/// Half-open [start, end) range whose innermost inlined call is `site`.
+/// The index keeps these disjoint and sorted, so one binary search finds
+/// the whole chain of an address.
+struct InlineRange {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint32_t site = 0;
+    uint32_t reserved = 0;
+};
+
+/// Read-only view over an array owned by the index's storage.
+template <typename T>
+struct Span {
+    const T *data = nullptr;
+    size_t size = 0;
+
+    const T *begin() const { return data; }
+    const T *end() const { return data + size; }
+    const T &operator[](size_t index) const { return data[index]; }
+    bool empty() const { return size == 0; }
+};
+
+/// Runs the line program of one compilation unit, appending each of its
+/// sequences (ended by a row with `line == 0`) to `sequences`.
+using LineDecoder = std::function<void(std::vector<std::vector<LineRow>> &sequences)>;
+
+/// Line tables decoded one compilation unit at a time. The map from code
+/// ranges to units is built up front, which is cheap; a unit's line
+/// program only runs the first time an address lands in one of its ranges.
+/// Safe to query from several threads.
+class LazyLineTable {
+public:
+    /// Half-open [start, end) range of code described by `unit`.
+    struct Range {
+        uint64_t start;
+        uint64_t end;
+        uint32_t unit;
+    };
+
+    /// `owner` keeps the data the decoders read from alive.
+    explicit LazyLineTable(std::shared_ptr<const void> owner) : owner_(std::move(owner)) {}
+    LazyLineTable(const LazyLineTable &) = delete;
+    LazyLineTable &operator=(const LazyLineTable &) = delete;
+
+    uint32_t addUnit(LineDecoder decoder);
+    void addRange(uint64_t start, uint64_t end, uint32_t unit);
+    /// Decodes `unit` now and covers the addresses of its sequences, for
+    /// units whose code ranges are not recorded anywhere else.
+    void addDecodedRanges(uint32_t unit);
+    /// Sorts the range map; call once all units are added.
+    void finish();
+
+    /// The range containing `address`, or null.
+    const Range *range(uint64_t address) const;
+    /// Rows of `unit`, sequences sorted by address, decoding it on first use.
+    /// A unit whose line program turns out to be corrupt keeps the
+    /// sequences decoded before the error.
+    Span<LineRow> rows(uint32_t unit) const;
+    /// Row in effect at `address`, or null when no unit covers it.
+    const LineRow *find(uint64_t address) const;
+
+    size_t unitCount() const { return units_.size(); }
+    size_t decodedUnitCount() const { return decodedUnits_.load(std::memory_order_relaxed); }
+
+private:
+    struct Unit {
+        LineDecoder decode;
+        std::once_flag decoded;
+        std::vector<LineRow> rows;
+    };
+
+    std::shared_ptr<const void> owner_;
+    mutable std::deque<Unit> units_;
+    std::vector<Range> ranges_;
+    mutable std::atomic<size_t> decodedUnits_ {0};
+};
+
+/// String pool decoded one block at a time, for pools kept compressed (see
+/// `readSymbolStore`). Blocks begin at string boundaries, so no string
+/// spans two. Safe to query from several threads.
+class LazyStringPool {
+public:
+    /// Produces the bytes of one block, NUL terminators included.
+    using BlockDecoder = std::function<void(std::string &bytes)>;
+
+    /// `owner` keeps the data the decoders read from alive.
+    explicit LazyStringPool(std::shared_ptr<const void> owner) : owner_(std::move(owner)) {}
+    LazyStringPool(const LazyStringPool &) = delete;
+    LazyStringPool &operator=(const LazyStringPool &) = delete;
+
+    /// Adds the block starting at pool offset `offset`. Blocks must be added
+    /// in increasing order of offset.
+    void addBlock(uint64_t offset, BlockDecoder decoder);
+
+    /// The string at pool offset `offset`, decoding its block on first use;
+    /// empty when the offset lies outside every block or the block is corrupt.
+    const char *at(uint64_t offset) const;
+
+    size_t blockCount() const { return blocks_.size(); }
+    size_t decodedBlockCount() const { return decodedBlocks_.load(std::memory_order_relaxed); }
+
+private:
+    struct Block {
+        uint64_t offset;
+        BlockDecoder decode;
+        std::once_flag decoded;
+        std::string bytes;
+    };
+
+    std::shared_ptr<const void> owner_;
+    mutable std::deque<Block> blocks_;
+    mutable std::atomic<size_t> decodedBlocks_ {0};
+};
+
+struct SymbolLookup {
+    const char *function = nullptr;
+    uint64_t functionStart = 0;
+    const char *file = nullptr;
+    uint32_t line = 0;
+};
+
+/// Batches of at least `kMergeJoinThreshold` addresses are resolved with one
+/// sorted sweep rather than a binary search per address, unless both the
+/// function and line tables have fewer than `kMergeJoinMinimumRows` rows:
+/// small tables stay in cache, where searching beats sorting the batch.
+constexpr size_t kMergeJoinThreshold = 64;
+constexpr size_t kMergeJoinMinimumRows = 1 << 14;
+/// Batches at least this large are sorted with a radix sort.
+constexpr size_t kRadixSortThreshold = 4096;
+
+/// Immutable address -> function/file/line index over file (vm) addresses.
+/// The arrays either live in memory owned by the index or point straight
+/// into a mapped cache file (see `IndexCache`); `storage_` keeps whichever
+/// it is alive, so copies are cheap and share it.
+class SymbolIndex {
+public:
+    /// Everything an index consists of. Functions are stored as parallel
+    /// arrays: the search only touches the sorted `functionStarts`, eight
+    /// per cache line, and reads the end and name of the one it lands on.
+    struct Arrays {
+        Span<uint64_t> functionStarts;
+        Span<uint64_t> functionEnds;
+        Span<uint32_t> functionNames;
+        Span<LineRow> lines;
+        Span<uint32_t> files;
+        Span<InlineSite> inlineSites;
+        Span<InlineRange> inlineRanges;
+        std::string_view strings;
+    };
+
+    /// Builds the index from the DWARF sections of `file`, falling back to
+    /// the symbol table for code without debug information.
+    static SymbolIndex build(const MachOFile &file);
+
+    /// `build`, except that line programs are left undecoded until a lookup
+    /// needs them (see `LazyLineTable`), so opening a large dSYM costs the
+    /// .debug_info walk alone. The index keeps `file` mapped. `arrays().lines`
+    /// stays empty; such an index cannot be written to an `IndexCache`.
+    static SymbolIndex buildLazily(std::shared_ptr<const MachOFile> file);
+
+    SymbolLookup lookup(uint64_t address) const;
+
+    /// Resolves `count` addresses into `results`, in the order given. From
+    /// `kMergeJoinThreshold` addresses on, against a large index, they are
+    /// sorted and merge-joined against the function and line tables in one
+    /// forward sweep, which gallops over the entries between neighbours.
+    void lookup(const uint64_t *addresses, size_t count, SymbolLookup *results) const;
+
+    /// Position of the function containing `address` in the function
+    /// arrays, or `functionCount()` when no function does.
+    size_t findFunction(uint64_t address) const;
+
+    /// Appends the frames `address` stands for, innermost inlined call first
+    /// and the function it was inlined into last; just `lookup(address)`
+    /// when no call is inlined there. Each outer frame carries the position
+    /// of the call it made, and all of them share `functionStart`.
+    void lookupInlined(uint64_t address, std::vector<SymbolLookup> &chain) const;
+
+    const Arrays &arrays() const { return arrays_; }
+    size_t functionCount() const { return arrays_.functionStarts.size; }
+    /// The deferred line tables of an index from `buildLazily`, or null.
+    const LazyLineTable *lazyLines() const { return lazyLines_.get(); }
+
+    /// The string pool of an index loaded from a symbol store, or null.
+    const LazyStringPool *lazyStrings() const { return lazyStrings_.get(); }
+
+    /// Wraps arrays owned by `storage`; used when loading a cached index.
+    /// The three function arrays must have the same length. With `lines`,
+    /// `arrays.lines` is ignored and line rows come from it; with `strings`,
+    /// so are `arrays.strings`.
+    static SymbolIndex view(std::shared_ptr<const void> storage, const Arrays &arrays,
+                            std::shared_ptr<const LazyLineTable> lines = nullptr,
+                            std::shared_ptr<const LazyStringPool> strings = nullptr);
+
+private:
+    const char *string(uint32_t offset) const {
+        return lazyStrings_ != nullptr ? lazyStrings_->at(offset) : arrays_.strings.data() + offset;
+    }
+    /// Builds the lookup of `address` from the last function starting at or
+    /// before it (the array size for none) and the line row in effect there.
+    SymbolLookup resolve(uint64_t address, size_t function, const LineRow *row) const;
+
+    std::shared_ptr<const void> storage_;
+    Arrays arrays_;
+    std::shared_ptr<const LazyLineTable> lazyLines_;
+    std::shared_ptr<const LazyStringPool> lazyStrings_;
+};
+
+/// Collects functions, symbols and line sequences, then sorts them into a
+/// `SymbolIndex`. Names passed to `intern` only need to live until `finish`.
+class SymbolIndexBuilder {
+public:
+    SymbolIndexBuilder();
+
+    uint32_t intern(std::string_view string);
+    uint32_t file(std::string_view directory, std::string_view name);
+
+    void addFunction(uint64_t start, uint64_t end, uint32_t name);
+    void addSymbol(uint64_t address, std::string_view name);
+    void addLineSequence(std::vector<LineRow> &&rows);
+
+    /// Sites must be added after their parent. Ranges of a site may overlap
+    /// those of its parent; the deepest site wins.
+    uint32_t addInlineSite(uint32_t callFile, uint32_t callLine, uint32_t parent);
+    void nameInlineSite(uint32_t site, uint32_t name);
+    void addInlineRange(uint64_t start, uint64_t end, uint32_t site);
+
+    SymbolIndex finish();
+
+private:
+    struct Symbol {
+        uint64_t address;
+        uint32_t name;
+    };
+
+    struct Storage {
+        std::vector<uint64_t> functionStarts;
+        std::vector<uint64_t> functionEnds;
+        std::vector<uint32_t> functionNames;
+        std::vector<LineRow> lines;
+        std::vector<uint32_t> files;
+        std::vector<InlineSite> inlineSites;
+        std::vector<InlineRange> inlineRanges;
+        std::string strings;
+    };
+
+    void flattenInlineRanges();
+
+    std::shared_ptr<Storage> storage_;
+    std::unordered_map<std::string_view, uint32_t> strings_;
+    std::unordered_map<std::string, uint32_t> files_;
+    std::vector<FunctionRange> functions_;
+    std::vector<Symbol> symbols_;
+    std::vector<std::vector<LineRow>> sequences_;
+    std::vector<InlineRange> inlineRanges_;
+};
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,472 @@
+//
+//  symbol_store.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "symbol_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+#include "data_reader.hpp"
+#include "error.hpp"
+#include "mapped_file.hpp"
+
+namespace symbolicator {
+
+namespace {
+
+constexpr char kStoreMagic[8] = {'S', 'X', 'S', 'T', 'O', 'R', 'E', '\0'};
+constexpr uint32_t kStoreVersion = 1;
+
+/// Line rows per block, and the size the string pool is cut at. A lookup
+/// inflates one block of each, a few tens of kilobytes.
+constexpr size_t kLineBlockRows = 4096;
+constexpr size_t kStringBlockBytes = 64 * 1024;
+
+/// Deflate cannot expand data by more than this factor, so a larger claimed
+/// size marks a corrupt block before anything is allocated for it.
+constexpr uint64_t kMaximumInflation = 1032;
+
+/// Fixed header at the start of every store, host-endian like the index
+/// cache. The block indexes follow at 8 byte aligned offsets and are read in
+/// place; the compressed data follows them.
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint8_t uuid[16];
+    uint32_t cpuType;
+    uint32_t cpuSubtype;
+    uint64_t textAddress;
+    uint64_t nameOffset;
+    uint64_t nameSize;
+    uint64_t tablesOffset;
+    uint64_t tablesSize;
+    uint64_t tablesRawSize;
+    uint64_t lineBlocksOffset;
+    uint64_t lineBlockCount;
+    uint64_t stringBlocksOffset;
+    uint64_t stringBlockCount;
+};
+
+/// One compressed block. `first` is the address of its first line row, or
+/// the pool offset of its first string.
+struct StoreBlock {
+    uint64_t first;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t rawSize;
+};
+
+/// The tables decoded when a store is opened.
+struct StoreTables {
+    std::vector<uint64_t> functionStarts;
+    std::vector<uint64_t> functionEnds;
+    std::vector<uint32_t> functionNames;
+    std::vector<uint32_t> files;
+    std::vector<InlineSite> inlineSites;
+    std::vector<InlineRange> inlineRanges;
+};
+
+uint64_t aligned(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+void putULEB128(std::string &out, uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        out.push_back(static_cast<char>(byte));
+    } while (value != 0);
+}
+
+void putSLEB128(std::string &out, int64_t value) {
+    bool more = true;
+    while (more) {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        more = !((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0));
+        if (more) {
+            byte |= 0x80;
+        }
+        out.push_back(static_cast<char>(byte));
+    }
+}
+
+uint32_t getU32(DataReader &reader) {
+    const uint64_t value = reader.uleb128();
+    if (value > UINT32_MAX) {
+        throwBadFormat("symbol store value out of range");
+    }
+    return static_cast<uint32_t>(value);
+}
+
+/// Reads an element count, each element taking at least a byte.
+size_t getCount(DataReader &reader) {
+    const uint64_t count = reader.uleb128();
+    if (count > reader.remaining()) {
+        throwBadFormat("symbol store table out of bounds");
+    }
+    return static_cast<size_t>(count);
+}
+
+StoreBlock deflated(const std::string &raw, std::string &out) {
+    uLongf size = compressBound(static_cast<uLong>(raw.size()));
+    const size_t offset = out.size();
+    out.resize(offset + size);
+    if (compress2(reinterpret_cast<Bytef *>(&out[offset]), &size, reinterpret_cast<const Bytef *>(raw.data()),
+                  static_cast<uLong>(raw.size()), Z_BEST_COMPRESSION) != Z_OK) {
+        throw Error(SYMBOLICATOR_E_NO_MEMORY, "could not compress symbol store block");
+    }
+    out.resize(offset + size);
+    StoreBlock block {};
+    block.offset = offset;
+    block.size = static_cast<uint32_t>(size);
+    block.rawSize = static_cast<uint32_t>(raw.size());
+    return block;
+}
+
+std::string inflated(const MappedFile &file, uint64_t offset, uint64_t size, uint64_t rawSize) {
+    if (offset > file.size() || size > file.size() - offset || rawSize > size * kMaximumInflation) {
+        throwBadFormat("symbol store block out of bounds");
+    }
+    std::string raw(static_cast<size_t>(rawSize), '\0');
+    if (rawSize == 0) {
+        return raw;
+    }
+    uLongf length = static_cast<uLongf>(rawSize);
+    if (uncompress(reinterpret_cast<Bytef *>(&raw[0]), &length, file.data() + offset, static_cast<uLong>(size)) != Z_OK ||
+        length != rawSize) {
+        throwBadFormat("corrupt symbol store block");
+    }
+    return raw;
+}
+
+template <typename T>
+Span<T> arrayAt(const MappedFile &file, uint64_t offset, uint64_t count) {
+    if (offset % alignof(T) != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+        throwBadFormat("symbol store array out of bounds");
+    }
+    return {reinterpret_cast<const T *>(file.data() + offset), static_cast<size_t>(count)};
+}
+
+bool readHeader(const uint8_t *data, size_t size, StoreHeader &header) {
+    if (size < sizeof(StoreHeader)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    return std::memcmp(header.magic, kStoreMagic, sizeof(kStoreMagic)) == 0 && header.version == kStoreVersion;
+}
+
+/// Functions, files and inlined calls, with addresses as differences from
+/// the previous entry so that most take a byte or two.
+std::string encodeTables(const SymbolIndex::Arrays &index) {
+    std::string out;
+    putULEB128(out, index.functionStarts.size);
+    uint64_t previous = 0;
+    for (size_t function = 0; function < index.functionStarts.size; ++function) {
+        putULEB128(out, index.functionStarts[function] - previous);
+        putULEB128(out, index.functionEnds[function] - index.functionStarts[function]);
+        putULEB128(out, index.functionNames[function]);
+        previous = index.functionStarts[function];
+    }
+
+    putULEB128(out, index.files.size);
+    for (uint32_t file : index.files) {
+        putULEB128(out, file);
+    }
+
+    putULEB128(out, index.inlineSites.size);
+    for (const auto &site : index.inlineSites) {
+        putULEB128(out, site.name);
+        putULEB128(out, site.callFile);
+        putULEB128(out, site.callLine);
+        putULEB128(out, static_cast<uint32_t>(site.parent + 1)); // kNoInlineSite becomes 0.
+    }
+
+    putULEB128(out, index.inlineRanges.size);
+    previous = 0;
+    for (const auto &range : index.inlineRanges) {
+        putULEB128(out, range.start - previous);
+        putULEB128(out, range.end - range.start);
+        putULEB128(out, range.site);
+        previous = range.end;
+    }
+    return out;
+}
+
+std::shared_ptr<StoreTables> decodeTables(const std::string &raw) {
+    auto tables = std::make_shared<StoreTables>();
+    DataReader reader(reinterpret_cast<const uint8_t *>(raw.data()), raw.size());
+
+    const size_t functionCount = getCount(reader);
+    tables->functionStarts.reserve(functionCount);
+    tables->functionEnds.reserve(functionCount);
+    tables->functionNames.reserve(functionCount);
+    uint64_t previous = 0;
+    for (size_t function = 0; function < functionCount; ++function) {
+        const uint64_t start = previous + reader.uleb128();
+        tables->functionStarts.push_back(start);
+        tables->functionEnds.push_back(start + reader.uleb128());
+        tables->functionNames.push_back(getU32(reader));
+        previous = start;
+    }
+
+    const size_t fileCount = getCount(reader);
+    tables->files.reserve(fileCount);
+    for (size_t file = 0; file < fileCount; ++file) {
+        tables->files.push_back(getU32(reader));
+    }
+
+    const size_t siteCount = getCount(reader);
+    tables->inlineSites.reserve(siteCount);
+    for (size_t index = 0; index < siteCount; ++index) {
+        InlineSite site;
+        site.name = getU32(reader);
+        site.callFile = getU32(reader);
+        site.callLine = getU32(reader);
+        site.parent = getU32(reader) - 1;
+        // Parents come first, so walking up a chain always ends.
+        if ((site.parent != kNoInlineSite && site.parent >= index) || (site.callLine != 0 && site.callFile >= fileCount)) {
+            throwBadFormat("symbol store inline site out of range");
+        }
+        tables->inlineSites.push_back(site);
+    }
+
+    const size_t rangeCount = getCount(reader);
+    tables->inlineRanges.reserve(rangeCount);
+    previous = 0;
+    for (size_t index = 0; index < rangeCount; ++index) {
+        InlineRange range;
+        range.start = previous + reader.uleb128();
+        range.end = range.start + reader.uleb128();
+        range.site = getU32(reader);
+        if (range.site >= siteCount) {
+            throwBadFormat("symbol store inline range out of range");
+        }
+        tables->inlineRanges.push_back(range);
+        previous = range.end;
+    }
+    return tables;
+}
+
+/// Rows of one line block: address and line as differences from the row
+/// before, which for consecutive rows are small.
+std::string encodeLines(const LineRow *rows, size_t count) {
+    std::string out;
+    uint64_t address = rows[0].address;
+    int64_t line = 0;
+    for (size_t row = 0; row < count; ++row) {
+        putULEB128(out, rows[row].address - address);
+        putULEB128(out, rows[row].file);
+        putSLEB128(out, static_cast<int64_t>(rows[row].line) - line);
+        address = rows[row].address;
+        line = rows[row].line;
+    }
+    return out;
+}
+
+std::vector<LineRow> decodeLines(const std::string &raw, uint64_t first, size_t fileCount) {
+    std::vector<LineRow> rows;
+    DataReader reader(reinterpret_cast<const uint8_t *>(raw.data()), raw.size());
+    uint64_t address = first;
+    int64_t line = 0;
+    while (!reader.atEnd()) {
+        LineRow row;
+        address += reader.uleb128();
+        row.address = address;
+        row.file = getU32(reader);
+        line += reader.sleb128();
+        if (line < 0 || line > UINT32_MAX || (line != 0 && row.file >= fileCount)) {
+            throwBadFormat("symbol store line row out of range");
+        }
+        row.line = static_cast<uint32_t>(line);
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+} // namespace
+
+void writeSymbolStore(const std::string &path, const Image &image) {
+    const SymbolIndex &symbols = image.index();
+    if (symbols.lazyLines() != nullptr || symbols.lazyStrings() != nullptr) {
+        throw Error(SYMBOLICATOR_E_INVALID_ARG, "a symbol store is written from an index with all its line tables");
+    }
+    const SymbolIndex::Arrays &index = symbols.arrays();
+
+    std::string data;
+    const std::string tables = encodeTables(index);
+    const StoreBlock tablesBlock = deflated(tables, data);
+
+    std::vector<StoreBlock> lineBlocks;
+    for (size_t first = 0; first < index.lines.size; first += kLineBlockRows) {
+        const size_t count = std::min(kLineBlockRows, index.lines.size - first);
+        StoreBlock block = deflated(encodeLines(index.lines.data + first, count), data);
+        block.first = index.lines[first].address;
+        lineBlocks.push_back(block);
+    }
+
+    // Blocks end after a terminator, so every string lies in one block.
+    std::vector<StoreBlock> stringBlocks;
+    const std::string_view strings = index.strings;
+    for (size_t first = 0; first < strings.size();) {
+        size_t end = std::min(first + kStringBlockBytes, strings.size());
+        const size_t terminator = strings.find('\0', end - 1);
+        end = terminator != std::string_view::npos ? terminator + 1 : strings.size();
+        StoreBlock block = deflated(std::string(strings.substr(first, end - first)), data);
+        block.first = first;
+        stringBlocks.push_back(block);
+        first = end;
+    }
+
+    StoreHeader header {};
+    std::memcpy(header.magic, kStoreMagic, sizeof(kStoreMagic));
+    header.version = kStoreVersion;
+    std::memcpy(header.uuid, image.uuid().data(), sizeof(header.uuid));
+    header.cpuType = image.architecture().type;
+    header.cpuSubtype = image.architecture().subtype;
+    header.textAddress = image.textAddress();
+    header.nameOffset = sizeof(StoreHeader);
+    header.nameSize = image.name().size();
+    header.lineBlocksOffset = aligned(header.nameOffset + header.nameSize);
+    header.lineBlockCount = lineBlocks.size();
+    header.stringBlocksOffset = aligned(header.lineBlocksOffset + lineBlocks.size() * sizeof(StoreBlock));
+    header.stringBlockCount = stringBlocks.size();
+    const uint64_t dataOffset = aligned(header.stringBlocksOffset + stringBlocks.size() * sizeof(StoreBlock));
+    header.tablesOffset = dataOffset + tablesBlock.offset;
+    header.tablesSize = tablesBlock.size;
+    header.tablesRawSize = tablesBlock.rawSize;
+    for (auto *blocks : {&lineBlocks, &stringBlocks}) {
+        for (auto &block : *blocks) {
+            block.offset += dataOffset;
+        }
+    }
+
+    std::string out;
+    out.reserve(static_cast<size_t>(dataOffset) + data.size());
+    auto emit = [&](uint64_t offset, const void *bytes, size_t size) {
+        out.resize(static_cast<size_t>(offset), '\0');
+        out.append(static_cast<const char *>(bytes), size);
+    };
+    emit(0, &header, sizeof(header));
+    emit(header.nameOffset, image.name().data(), image.name().size());
+    emit(header.lineBlocksOffset, lineBlocks.data(), lineBlocks.size() * sizeof(StoreBlock));
+    emit(header.stringBlocksOffset, stringBlocks.data(), stringBlocks.size() * sizeof(StoreBlock));
+    emit(dataOffset, data.data(), data.size());
+    writeFileAtomically(path, out);
+}
+
+Image readSymbolStore(const std::string &path, const char *arch) {
+    auto file = std::make_shared<const MappedFile>(MappedFile::open(path));
+    StoreHeader header;
+    if (!readHeader(file->data(), file->size(), header)) {
+        throwBadFormat(path + ": not a compatible symbol store");
+    }
+
+    if (arch != nullptr) {
+        CpuArchitecture requested;
+        if (!CpuArchitecture::parse(arch, requested)) {
+            throw Error(SYMBOLICATOR_E_INVALID_ARG, std::string("unknown architecture ") + arch);
+        }
+        if (requested.type != header.cpuType) {
+            throw Error(SYMBOLICATOR_E_ARCH_NOT_FOUND, path + ": no slice for " + arch);
+        }
+    }
+
+    const auto name = arrayAt<char>(*file, header.nameOffset, header.nameSize);
+    const auto lineBlocks = arrayAt<StoreBlock>(*file, header.lineBlocksOffset, header.lineBlockCount);
+    const auto stringBlocks = arrayAt<StoreBlock>(*file, header.stringBlocksOffset, header.stringBlockCount);
+    for (size_t block = 1; block < lineBlocks.size; ++block) {
+        if (lineBlocks[block].first < lineBlocks[block - 1].first) {
+            throwBadFormat(path + ": unsorted line blocks");
+        }
+    }
+    for (size_t block = 1; block < stringBlocks.size; ++block) {
+        if (stringBlocks[block].first <= stringBlocks[block - 1].first) {
+            throwBadFormat(path + ": unsorted string blocks");
+        }
+    }
+
+    std::shared_ptr<StoreTables> tables =
+        decodeTables(inflated(*file, header.tablesOffset, header.tablesSize, header.tablesRawSize));
+
+    // Blocks are decoded from the mapping, which the lazy tables keep alive.
+    auto lines = std::make_shared<LazyLineTable>(file);
+    const size_t fileCount = tables->files.size();
+    for (size_t index = 0; index < lineBlocks.size; ++index) {
+        const StoreBlock block = lineBlocks[index];
+        const uint32_t unit = lines->addUnit([file, block, fileCount](std::vector<std::vector<LineRow>> &sequences) {
+            std::vector<LineRow> rows =
+                decodeLines(inflated(*file, block.offset, block.size, block.rawSize), block.first, fileCount);
+            if (!rows.empty()) {
+                sequences.push_back(std::move(rows));
+            }
+        });
+        // Each block covers the addresses up to the next one's first row,
+        // which finds the same row as a search over all of them would.
+        lines->addRange(block.first, index + 1 < lineBlocks.size ? lineBlocks[index + 1].first : UINT64_MAX, unit);
+    }
+    lines->finish();
+
+    auto strings = std::make_shared<LazyStringPool>(file);
+    for (const StoreBlock &block : stringBlocks) {
+        strings->addBlock(block.first, [file, block](std::string &bytes) {
+            bytes = inflated(*file, block.offset, block.size, block.rawSize);
+        });
+    }
+
+    SymbolIndex::Arrays arrays;
+    arrays.functionStarts = {tables->functionStarts.data(), tables->functionStarts.size()};
+    arrays.functionEnds = {tables->functionEnds.data(), tables->functionEnds.size()};
+    arrays.functionNames = {tables->functionNames.data(), tables->functionNames.size()};
+    arrays.files = {tables->files.data(), tables->files.size()};
+    arrays.inlineSites = {tables->inlineSites.data(), tables->inlineSites.size()};
+    arrays.inlineRanges = {tables->inlineRanges.data(), tables->inlineRanges.size()};
+
+    std::array<uint8_t, 16> uuid;
+    std::memcpy(uuid.data(), header.uuid, uuid.size());
+    CpuArchitecture architecture;
+    architecture.type = header.cpuType;
+    architecture.subtype = header.cpuSubtype;
+
+    SymbolIndex index = SymbolIndex::view(std::move(tables), arrays, std::move(lines), std::move(strings));
+    return Image(std::string(name.data, name.size), uuid, architecture, header.textAddress, std::move(index));
+}
+
+bool readSymbolStoreSlice(const std::string &path, MachOSlice &slice) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    uint8_t bytes[sizeof(StoreHeader)];
+    const bool read = ::read(fd, bytes, sizeof(bytes)) == static_cast<ssize_t>(sizeof(bytes));
+    ::close(fd);
+
+    StoreHeader header;
+    if (!read || !readHeader(bytes, sizeof(bytes), header)) {
+        return false;
+    }
+    slice.architecture.type = header.cpuType;
+    slice.architecture.subtype = header.cpuSubtype;
+    slice.hasUUID = true;
+    std::memcpy(slice.uuid.data(), header.uuid, slice.uuid.size());
+    return true;
+}
+
+} // namespace symbolicator
@@ -0,0 +1,45 @@
+//
+//  symbol_store.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_SYMBOL_STORE_HPP
+#define SYMBOLICATOR_SYMBOL_STORE_HPP
+
+#include <string>
+
+#include "image.hpp"
+
+namespace symbolicator {
+
+/// Symbol stores: the symbol index of one image in a compressed file, for
+/// keeping the symbols of every shipped build without their dSYMs.
+///
+/// Function starts, line addresses and inline ranges are delta-encoded and
+/// everything is deflated. Functions, files and inlined calls form one block,
+/// decoded when the store is opened; line rows and the string pool are cut
+/// into blocks of their own, located through an uncompressed block index and
+/// decoded the first time a lookup lands in them. A store symbolicates like
+/// the binary it was written from and can stand in for it wherever a binary
+/// path is accepted.
+
+/// Writes the index of `image`, which must hold its line tables (see
+/// `Image::build`), as a store at `path`. Writes atomically via a temporary
+/// file and rename. Throws `Error`.
+void writeSymbolStore(const std::string &path, const Image &image);
+
+/// Opens the store at `path`. Throws `Error`, with
+/// `SYMBOLICATOR_E_ARCH_NOT_FOUND` when `arch` is set and the store holds
+/// another architecture.
+Image readSymbolStore(const std::string &path, const char *arch);
+
+/// Reads the identity of the image in the store at `path` into `slice`.
+/// False when `path` is not a symbol store.
+bool readSymbolStoreSlice(const std::string &path, MachOSlice &slice);
+
+} // namespace symbolicator
+
+#endif
@@ -0,0 +1,669 @@
+//
+//  symbolicator.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "symbolicator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "batch_symbolicator.hpp"
+#include "crash_report.hpp"
+#include "demangler.hpp"
+#include "dsym_catalog.hpp"
+#include "error.hpp"
+#include "frame_cache.hpp"
+#include "image.hpp"
+#include "index_cache.hpp"
+#include "ips_report.hpp"
+#include "mapped_file.hpp"
+#include "symbol_store.hpp"
+#include "work_pool.hpp"
+
+using namespace symbolicator;
+
+namespace {
+
+/// Resolved frames kept by each cache handle, or by a batch without one.
+constexpr uint64_t kFrameCacheBytes = 64ull << 20;
+
+} // namespace
+
+struct symbolicator_image_private {
+    std::shared_ptr<const Image> image;
+};
+
+struct symbolicator_cache_private {
+    std::shared_ptr<IndexCache> cache;
+    std::shared_ptr<FrameCache> frames;
+};
+
+struct symbolicator_batch_private {
+    WorkPool pool;
+    BatchSymbolicator batch;
+    /// Views of `batch.buckets()` handed out by symbolicator_batch_get_buckets.
+    std::vector<symbolicator_batch_bucket_t> buckets;
+    std::vector<const char *> bucketNames;
+    bool json = false; ///< Deliver `Result::json` instead of the text.
+
+    symbolicator_batch_private(unsigned threads, symbolicator_cache_t cache)
+        : pool(threads), batch(pool, cache != nullptr ? cache->cache : nullptr) {
+        // Without a cache the frames are still shared by the batch's reports.
+        batch.setFrameCache(cache != nullptr ? cache->frames : std::make_shared<FrameCache>(std::string(), kFrameCacheBytes));
+    }
+};
+
+struct symbolicator_catalog_private {
+    DSYMCatalog catalog;
+
+    explicit symbolicator_catalog_private(std::string file) : catalog(std::move(file)) {}
+};
+
+struct symbolicator_report_private {
+    std::string text;
+    MappedFile file;
+    std::string_view source; ///< What `report` was parsed from: `text` or `file`.
+    CrashReport report;
+    std::string rendered;
+    std::string strings;
+    symbolicator_report_info_t info;
+    std::vector<symbolicator_report_image_t> images;
+    std::vector<symbolicator_report_frame_t> frames;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+/// Runs `body`, translating exceptions into error codes for the C API.
+template <typename Body>
+symbolicator_error_t guarded(Body &&body) {
+    try {
+        body();
+        return SYMBOLICATOR_E_SUCCESS;
+    } catch (const Error &error) {
+        lastError = error.what();
+        return error.code();
+    } catch (const std::bad_alloc &) {
+        lastError = "out of memory";
+        return SYMBOLICATOR_E_NO_MEMORY;
+    } catch (const std::exception &error) {
+        lastError = error.what();
+        return SYMBOLICATOR_E_UNKNOWN_ERROR;
+    }
+}
+
+/// Copies `string` into a buffer released with symbolicator_string_free().
+char *copyString(const std::string &string) {
+    char *copy = static_cast<char *>(std::malloc(string.size() + 1));
+    if (copy == nullptr) {
+        throw std::bad_alloc();
+    }
+    std::memcpy(copy, string.data(), string.size() + 1);
+    return copy;
+}
+
+/// Copies the parsed report into C structs. All strings go into one buffer
+/// reserved up front, so the pointers handed out never move.
+void exportReport(const CrashReport &report, symbolicator_report_private &exported) {
+    size_t total = 6;
+    auto measure = [&](std::string_view string) { total += string.size() + 1; };
+    for (auto string : {report.processName, report.identifier, report.responsible, report.codeType,
+                        report.version, report.buildVersion}) {
+        measure(string);
+    }
+    for (const auto &image : report.images) {
+        measure(image.name);
+        measure(image.arch);
+        measure(image.uuid);
+        measure(image.path);
+    }
+    for (const auto &frame : report.frames) {
+        measure(frame.imageName);
+        measure(frame.address);
+    }
+
+    exported.strings.reserve(total);
+    auto copy = [&](std::string_view string) {
+        const char *pointer = exported.strings.data() + exported.strings.size();
+        exported.strings.append(string.data(), string.size());
+        exported.strings.push_back('\0');
+        return pointer;
+    };
+
+    exported.info.process_name = copy(report.processName);
+    exported.info.identifier = copy(report.identifier);
+    exported.info.responsible = copy(report.responsible);
+    exported.info.code_type = copy(report.codeType);
+    exported.info.version = copy(report.version);
+    exported.info.build_version = copy(report.buildVersion);
+    exported.info.main_image = report.mainImage;
+
+    exported.images.reserve(report.images.size());
+    for (const auto &image : report.images) {
+        exported.images.push_back({image.start, image.end, copy(image.name), copy(image.arch), copy(image.uuid), copy(image.path)});
+    }
+
+    exported.frames.reserve(report.frames.size());
+    for (const auto &frame : report.frames) {
+        symbolicator_report_frame_t entry;
+        entry.image = copy(frame.imageName);
+        entry.address = copy(frame.address);
+        entry.address_value = frame.addressValue;
+        entry.address_offset = frame.addressOffset;
+        entry.symbol_offset = frame.symbolOffset;
+        entry.symbol_length = frame.symbolLength;
+        entry.thread = frame.thread;
+        entry.image_index = frame.image;
+        entry.kind = frame.kind == ReportFrameKind::Sample ? SYMBOLICATOR_REPORT_FRAME_SAMPLE : SYMBOLICATOR_REPORT_FRAME_CRASH;
+        entry.is_main_image = frame.isMainImage ? 1 : 0;
+        exported.frames.push_back(entry);
+    }
+}
+
+} // namespace
+
+symbolicator_error_t symbolicator_image_open(const char *path, const char *arch, symbolicator_image_t *image) {
+    if (path == nullptr || image == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        *image = new symbolicator_image_private {std::make_shared<const Image>(Image::open(path, arch))};
+    });
+}
+
+symbolicator_error_t symbolicator_image_free(symbolicator_image_t image) {
+    if (image == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    delete image;
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_image_get_uuid(symbolicator_image_t image, uint8_t uuid[16]) {
+    if (image == nullptr || uuid == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    std::memcpy(uuid, image->image->uuid().data(), 16);
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+const char *symbolicator_image_get_name(symbolicator_image_t image) {
+    return image != nullptr ? image->image->name().c_str() : nullptr;
+}
+
+symbolicator_error_t symbolicator_image_lookup(symbolicator_image_t image, uint64_t load_address, const uint64_t *addresses, size_t count, symbolicator_frame_t *frames) {
+    if (image == nullptr || (count > 0 && (addresses == nullptr || frames == nullptr))) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        const uint64_t slide = image->image->textAddress() - load_address;
+        std::vector<uint64_t> fileAddresses(addresses, addresses + count);
+        for (auto &address : fileAddresses) {
+            address += slide;
+        }
+        std::vector<SymbolLookup> lookups(count);
+        image->image->index().lookup(fileAddresses.data(), count, lookups.data());
+        for (size_t index = 0; index < count; ++index) {
+            const SymbolLookup &lookup = lookups[index];
+            frames[index].function = lookup.function;
+            frames[index].function_offset = lookup.function != nullptr ? fileAddresses[index] - lookup.functionStart : 0;
+            frames[index].file = lookup.file;
+            frames[index].line = lookup.line;
+        }
+    });
+}
+
+symbolicator_error_t symbolicator_image_lookup_inlined(symbolicator_image_t image, uint64_t load_address, uint64_t address, symbolicator_frame_t *frames, size_t capacity, size_t *count) {
+    if (image == nullptr || count == nullptr || (capacity > 0 && frames == nullptr)) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::vector<SymbolLookup> chain;
+        image->image->lookupInlined(load_address, address, chain);
+        const uint64_t fileAddress = address - load_address + image->image->textAddress();
+        for (size_t index = 0; index < chain.size() && index < capacity; ++index) {
+            const SymbolLookup &lookup = chain[index];
+            frames[index].function = lookup.function;
+            frames[index].function_offset = lookup.function != nullptr ? fileAddress - lookup.functionStart : 0;
+            frames[index].file = lookup.file;
+            frames[index].line = lookup.line;
+        }
+        *count = chain.size();
+    });
+}
+
+symbolicator_error_t symbolicator_store_export(const char *path, const char *arch, const char *output) {
+    if (path == nullptr || output == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        writeSymbolStore(output, Image::build(path, MachOFile::open(path, arch)));
+    });
+}
+
+symbolicator_error_t symbolicator_cache_new(const char *directory, uint64_t max_bytes, symbolicator_cache_t *cache) {
+    if (directory == nullptr || *directory == '\0' || cache == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        auto frames = std::make_shared<FrameCache>(std::string(directory) + "/frames.cache", kFrameCacheBytes);
+        *cache = new symbolicator_cache_private {std::make_shared<IndexCache>(directory, max_bytes), std::move(frames)};
+    });
+}
+
+symbolicator_error_t symbolicator_cache_free(symbolicator_cache_t cache) {
+    if (cache == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    delete cache;
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_cache_open_image(symbolicator_cache_t cache, const char *path, const char *arch, symbolicator_image_t *image) {
+    if (cache == nullptr || path == nullptr || image == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        *image = new symbolicator_image_private {cache->cache->open(path, arch)};
+    });
+}
+
+symbolicator_error_t symbolicator_cache_find_image(symbolicator_cache_t cache, const uint8_t uuid[16], const char *arch, symbolicator_image_t *image) {
+    if (cache == nullptr || uuid == nullptr || image == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::array<uint8_t, 16> key;
+        std::memcpy(key.data(), uuid, key.size());
+        auto found = cache->cache->find(key, arch);
+        if (found == nullptr) {
+            throw Error(SYMBOLICATOR_E_NOT_FOUND, "no cached symbol index for this UUID");
+        }
+        *image = new symbolicator_image_private {std::move(found)};
+    });
+}
+
+symbolicator_error_t symbolicator_cache_save_frames(symbolicator_cache_t cache) {
+    if (cache == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] { cache->frames->save(); });
+}
+
+symbolicator_error_t symbolicator_cache_get_frame_stats(symbolicator_cache_t cache, symbolicator_frame_cache_stats_t *stats) {
+    if (cache == nullptr || stats == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        const FrameCache::Stats found = cache->frames->stats();
+        *stats = {found.lookups, found.hits, found.frames, found.bytes};
+    });
+}
+
+symbolicator_error_t symbolicator_report_parse(const char *text, size_t length, symbolicator_report_t *report) {
+    if ((text == nullptr && length > 0) || report == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        auto exported = std::make_unique<symbolicator_report_private>();
+        exported->text.assign(text, length);
+        exported->source = exported->text;
+        exported->report = CrashReport::parse(exported->source);
+        exportReport(exported->report, *exported);
+        *report = exported.release();
+    });
+}
+
+symbolicator_error_t symbolicator_report_open(const char *path, symbolicator_report_t *report) {
+    if (path == nullptr || report == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        auto exported = std::make_unique<symbolicator_report_private>();
+        exported->file = MappedFile::open(path);
+        exported->source = std::string_view(reinterpret_cast<const char *>(exported->file.data()), exported->file.size());
+        if (exported->source.find_first_not_of(" \t\r\n") == std::string_view::npos) {
+            throw Error(SYMBOLICATOR_E_BAD_FORMAT, std::string(path) + ": empty report");
+        }
+        if (isIPS(exported->source)) {
+            try {
+                exported->text = translateIPS(exported->source);
+                exported->source = exported->text;
+                exported->file = MappedFile();
+            } catch (const Error &) {
+                // Parsed as it is, like symbolicator_ips_translate callers do.
+            }
+        }
+        exported->report = CrashReport::parse(exported->source);
+        exportReport(exported->report, *exported);
+        *report = exported.release();
+    });
+}
+
+symbolicator_error_t symbolicator_report_free(symbolicator_report_t report) {
+    if (report == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    delete report;
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_report_get_info(symbolicator_report_t report, symbolicator_report_info_t *info) {
+    if (report == nullptr || info == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    *info = report->info;
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_report_get_text(symbolicator_report_t report, const char **text, size_t *length) {
+    if (report == nullptr || text == nullptr || length == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    *text = report->source.data();
+    *length = report->source.size();
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_report_get_images(symbolicator_report_t report, const symbolicator_report_image_t **images, size_t *count) {
+    if (report == nullptr || images == nullptr || count == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    *images = report->images.data();
+    *count = report->images.size();
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_report_get_frames(symbolicator_report_t report, const symbolicator_report_frame_t **frames, size_t *count) {
+    if (report == nullptr || frames == nullptr || count == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    *frames = report->frames.data();
+    *count = report->frames.size();
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_report_render(symbolicator_report_t report, const char *const *replacements, size_t count, const char **output, size_t *length) {
+    if (report == nullptr || (count > 0 && replacements == nullptr) || output == nullptr || length == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::vector<std::string_view> views(count);
+        for (size_t index = 0; index < count; ++index) {
+            if (replacements[index] != nullptr) {
+                views[index] = replacements[index];
+            }
+        }
+        report->rendered = report->report.render(report->source, views);
+        *output = report->rendered.c_str();
+        *length = report->rendered.size();
+    });
+}
+
+symbolicator_error_t symbolicator_batch_new(symbolicator_cache_t cache, unsigned threads, symbolicator_batch_t *batch) {
+    if (batch == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        *batch = new symbolicator_batch_private(threads, cache);
+    });
+}
+
+symbolicator_error_t symbolicator_batch_free(symbolicator_batch_t batch) {
+    if (batch == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    delete batch;
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_batch_add_report(symbolicator_batch_t batch, const char *name, const char *text, size_t length) {
+    if (batch == nullptr || name == nullptr || (text == nullptr && length > 0)) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        batch->batch.addReport(name, std::string(text, length));
+    });
+}
+
+symbolicator_error_t symbolicator_batch_add_report_file(symbolicator_batch_t batch, const char *path) {
+    if (batch == nullptr || path == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        batch->batch.addReportFile(path);
+    });
+}
+
+symbolicator_error_t symbolicator_batch_add_binary(symbolicator_batch_t batch, const uint8_t uuid[16], const char *path) {
+    if (batch == nullptr || uuid == nullptr || path == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::array<uint8_t, 16> key;
+        std::memcpy(key.data(), uuid, key.size());
+        batch->batch.addBinary(key, path);
+    });
+}
+
+symbolicator_error_t symbolicator_batch_set_expand_inlines(symbolicator_batch_t batch, int enabled) {
+    if (batch == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    batch->batch.setExpandsInlines(enabled != 0);
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_batch_set_demangle(symbolicator_batch_t batch, int enabled) {
+    if (batch == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    batch->batch.setDemangles(enabled != 0);
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_batch_set_deduplicate(symbolicator_batch_t batch, unsigned frames) {
+    if (batch == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    batch->batch.setDeduplicates(frames);
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_batch_set_format(symbolicator_batch_t batch, symbolicator_batch_format_t format) {
+    if (batch == nullptr || (format != SYMBOLICATOR_BATCH_FORMAT_TEXT && format != SYMBOLICATOR_BATCH_FORMAT_JSON)) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    batch->json = format == SYMBOLICATOR_BATCH_FORMAT_JSON;
+    batch->batch.setRendersText(!batch->json);
+    batch->batch.setRendersJSON(batch->json);
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_batch_run(symbolicator_batch_t batch, symbolicator_batch_locate_cb_t locate, symbolicator_batch_result_cb_t result, void *user_data) {
+    if (batch == nullptr || result == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        auto locateMissing = [&](const std::vector<ImageKey> &missing) {
+            if (locate == nullptr) {
+                return;
+            }
+            std::vector<symbolicator_image_key_t> keys(missing.size());
+            for (size_t index = 0; index < missing.size(); ++index) {
+                std::memcpy(keys[index].uuid, missing[index].uuid.data(), 16);
+                keys[index].arch = missing[index].arch.empty() ? nullptr : missing[index].arch.c_str();
+            }
+            locate(batch, keys.data(), keys.size(), user_data);
+        };
+        auto deliver = [&](BatchSymbolicator::Result &&finished) {
+            const std::string &output = batch->json ? finished.json : finished.output;
+            const bool hasOutput = batch->json || finished.error.empty();
+            result(finished.name.c_str(), hasOutput ? output.c_str() : nullptr, hasOutput ? output.size() : 0,
+                   finished.error.empty() ? nullptr : finished.error.c_str(), user_data);
+        };
+        batch->batch.run(locateMissing, deliver);
+    });
+}
+
+symbolicator_error_t symbolicator_batch_get_timings(symbolicator_batch_t batch, symbolicator_batch_timings_t *timings) {
+    if (batch == nullptr || timings == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    const BatchSymbolicator::Timings &stages = batch->batch.timings();
+    *timings = {stages.parse, stages.locate, stages.load, stages.resolve, stages.demangle, stages.deduplicate};
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_batch_get_buckets(symbolicator_batch_t batch, const symbolicator_batch_bucket_t **buckets, size_t *count) {
+    if (batch == nullptr || buckets == nullptr || count == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        const std::vector<BatchSymbolicator::Bucket> &found = batch->batch.buckets();
+        batch->bucketNames.clear();
+        for (const auto &bucket : found) {
+            for (const auto &name : bucket.names) {
+                batch->bucketNames.push_back(name.c_str());
+            }
+        }
+        batch->buckets.clear();
+        const char *const *names = batch->bucketNames.data();
+        for (const auto &bucket : found) {
+            batch->buckets.push_back({bucket.signature.hash, bucket.signature.text.c_str(), names, bucket.names.size()});
+            names += bucket.names.size();
+        }
+        *buckets = batch->buckets.data();
+        *count = batch->buckets.size();
+    });
+}
+
+symbolicator_error_t symbolicator_catalog_new(const char *file, symbolicator_catalog_t *catalog) {
+    if (catalog == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        *catalog = new symbolicator_catalog_private(file != nullptr ? file : "");
+    });
+}
+
+symbolicator_error_t symbolicator_catalog_free(symbolicator_catalog_t catalog) {
+    if (catalog == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    delete catalog;
+    return SYMBOLICATOR_E_SUCCESS;
+}
+
+symbolicator_error_t symbolicator_catalog_refresh(symbolicator_catalog_t catalog, const char *const *roots, size_t count, unsigned threads) {
+    if (catalog == nullptr || (count > 0 && roots == nullptr)) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::vector<std::string> paths;
+        for (size_t index = 0; index < count; ++index) {
+            if (roots[index] != nullptr) {
+                paths.emplace_back(roots[index]);
+            }
+        }
+        WorkPool pool(threads);
+        catalog->catalog.refresh(paths, pool);
+    });
+}
+
+symbolicator_error_t symbolicator_catalog_watch(symbolicator_catalog_t catalog, const char *const *roots, size_t count, unsigned threads) {
+    if (catalog == nullptr || (count > 0 && roots == nullptr)) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::vector<std::string> paths;
+        for (size_t index = 0; index < count; ++index) {
+            if (roots[index] != nullptr) {
+                paths.emplace_back(roots[index]);
+            }
+        }
+        if (!catalog->catalog.watch(paths, threads)) {
+            throw Error(SYMBOLICATOR_E_IO_ERROR, "no filesystem change notifications on this system");
+        }
+    });
+}
+
+symbolicator_error_t symbolicator_catalog_search(symbolicator_catalog_t catalog, const uint8_t *uuids, size_t uuid_count, const char *const *roots, size_t count, unsigned threads) {
+    if (catalog == nullptr || (uuid_count > 0 && uuids == nullptr) || (count > 0 && roots == nullptr)) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::vector<std::array<uint8_t, 16>> keys(uuid_count);
+        for (size_t index = 0; index < uuid_count; ++index) {
+            std::memcpy(keys[index].data(), uuids + index * 16, 16);
+        }
+        std::vector<std::string> paths;
+        for (size_t index = 0; index < count; ++index) {
+            if (roots[index] != nullptr) {
+                paths.emplace_back(roots[index]);
+            }
+        }
+        WorkPool pool(threads);
+        if (catalog->catalog.search(keys, paths, pool) < keys.size()) {
+            throw Error(SYMBOLICATOR_E_NOT_FOUND, "no dSYM found for some of the UUIDs");
+        }
+    });
+}
+
+symbolicator_error_t symbolicator_catalog_find(symbolicator_catalog_t catalog, const uint8_t uuid[16], const char *arch, char **path) {
+    if (catalog == nullptr || uuid == nullptr || path == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::array<uint8_t, 16> key;
+        std::memcpy(key.data(), uuid, key.size());
+        const std::string found = catalog->catalog.find(key, arch);
+        if (found.empty()) {
+            throw Error(SYMBOLICATOR_E_NOT_FOUND, "no binary with this UUID in the catalog");
+        }
+        *path = copyString(found);
+    });
+}
+
+symbolicator_error_t symbolicator_ips_translate(const char *json, size_t length, char **text, size_t *text_length) {
+    if ((json == nullptr && length > 0) || text == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        const std::string translated = translateIPS(std::string_view(json, length));
+        *text = copyString(translated);
+        if (text_length != nullptr) {
+            *text_length = translated.size();
+        }
+    });
+}
+
+symbolicator_error_t symbolicator_demangle(const char *mangled, char **demangled) {
+    if (mangled == nullptr || demangled == nullptr) {
+        return SYMBOLICATOR_E_INVALID_ARG;
+    }
+    return guarded([&] {
+        std::string name;
+        if (!demangle(mangled, name)) {
+            throw Error(SYMBOLICATOR_E_BAD_FORMAT, "not a supported mangled name");
+        }
+        *demangled = copyString(name);
+    });
+}
+
+void symbolicator_string_free(char *string) {
+    std::free(string);
+}
+
+const char *symbolicator_last_error(void) {
+    return lastError.c_str();
+}
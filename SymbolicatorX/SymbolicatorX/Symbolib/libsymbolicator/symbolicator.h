@@ -0,0 +1,775 @@
+//
+//  symbolicator.h
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+//  In-process Mach-O/DWARF symbolication. Exposed to Swift through the
+//  bridging header alongside the Devicelib headers.
+//
+
+#ifndef SYMBOLICATOR_H
+#define SYMBOLICATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Error Codes */
+typedef enum {
+    SYMBOLICATOR_E_SUCCESS           =  0,
+    SYMBOLICATOR_E_INVALID_ARG       = -1,
+    SYMBOLICATOR_E_IO_ERROR          = -2,
+    SYMBOLICATOR_E_BAD_FORMAT        = -3,
+    SYMBOLICATOR_E_ARCH_NOT_FOUND    = -4,
+    SYMBOLICATOR_E_NO_MEMORY         = -5,
+    SYMBOLICATOR_E_NOT_FOUND         = -6,
+    SYMBOLICATOR_E_UNKNOWN_ERROR     = -256
+} symbolicator_error_t;
+
+/** What a batch delivers for each report. */
+typedef enum {
+    SYMBOLICATOR_BATCH_FORMAT_TEXT = 0, /**< The symbolicated report in the text crash format. */
+    SYMBOLICATOR_BATCH_FORMAT_JSON = 1  /**< One JSON object per report, on a single line. */
+} symbolicator_batch_format_t;
+
+typedef struct symbolicator_image_private symbolicator_image_private; /**< \private */
+typedef symbolicator_image_private *symbolicator_image_t; /**< Handle to a loaded symbol index. */
+
+typedef struct symbolicator_cache_private symbolicator_cache_private; /**< \private */
+typedef symbolicator_cache_private *symbolicator_cache_t; /**< Handle to an on-disk symbol index cache. */
+
+typedef struct symbolicator_report_private symbolicator_report_private; /**< \private */
+typedef symbolicator_report_private *symbolicator_report_t; /**< Handle to a parsed crash report. */
+
+typedef struct symbolicator_batch_private symbolicator_batch_private; /**< \private */
+typedef symbolicator_batch_private *symbolicator_batch_t; /**< Handle to a batch of reports symbolicated together. */
+
+typedef struct symbolicator_catalog_private symbolicator_catalog_private; /**< \private */
+typedef symbolicator_catalog_private *symbolicator_catalog_t; /**< Handle to a persistent dSYM UUID catalog. */
+
+/** A resolved frame. Strings are owned by the image and stay valid until it is freed. */
+typedef struct {
+    const char *function;       /**< Function name, or NULL when no symbol covers the address. */
+    uint64_t function_offset;   /**< Distance from the start of the function. */
+    const char *file;           /**< Source path, or NULL when there is no line information. */
+    uint32_t line;              /**< Source line, 0 when unknown. */
+} symbolicator_frame_t;
+
+/** Header fields of a crash report. Missing fields are empty strings. */
+typedef struct {
+    const char *process_name;   /**< "Process:" without the pid. */
+    const char *identifier;     /**< "Identifier:" */
+    const char *responsible;    /**< "Responsible:" without the pid. */
+    const char *code_type;      /**< "Code Type:" without the parenthesized suffix. */
+    const char *version;        /**< Marketing version from "Version:". */
+    const char *build_version;  /**< Build number in the parentheses of "Version:". */
+    int64_t main_image;         /**< Index of the process' own binary image, or -1. */
+} symbolicator_report_info_t;
+
+/** One entry of the "Binary Images:" table. */
+typedef struct {
+    uint64_t start;             /**< Load address. */
+    uint64_t end;               /**< Last address of the image. */
+    const char *name;           /**< Image name without the leading "+". */
+    const char *arch;           /**< Architecture column, empty when the report has none. */
+    const char *uuid;           /**< UUID text between the angle brackets, empty when absent. */
+    const char *path;           /**< Install path. */
+} symbolicator_report_image_t;
+
+/** Kinds of backtrace lines recognized in a report. */
+typedef enum {
+    SYMBOLICATOR_REPORT_FRAME_CRASH  = 0, /**< "0  MyApp  0x00000001000... " */
+    SYMBOLICATOR_REPORT_FRAME_SAMPLE = 1  /**< "??? (in MyApp) load address ... [0x...]" */
+} symbolicator_report_frame_kind_t;
+
+/** A frame address found in a report. */
+typedef struct {
+    const char *image;          /**< Image column of the frame. */
+    const char *address;        /**< Address token exactly as written in the report. */
+    uint64_t address_value;     /**< Parsed address. */
+    size_t address_offset;      /**< Byte offset of the address token in the report text. */
+    size_t symbol_offset;       /**< Byte offset of the unresolved text a rendering replaces. */
+    size_t symbol_length;       /**< Length of that text. */
+    int32_t thread;             /**< Thread number, -1 outside a "Thread N" section. */
+    int64_t image_index;        /**< Index of the binary image holding the address, or -1. */
+    symbolicator_report_frame_kind_t kind;
+    int is_main_image;          /**< Non-zero when the frame belongs to the process' own binary. */
+} symbolicator_report_frame_t;
+
+/** Symbols a batch needs: a binary UUID and the slice architecture. */
+typedef struct {
+    uint8_t uuid[16];
+    const char *arch;           /**< Architecture name, or NULL for the only slice. */
+} symbolicator_image_key_t;
+
+/** Wall-clock seconds spent in each stage of the last batch run. */
+typedef struct {
+    double parse;               /**< Reading and parsing the reports. */
+    double locate;              /**< Collecting their images and the locate callback. */
+    double load;                /**< Loading the symbols of each image. */
+    double resolve;             /**< Resolving and rendering the reports, demangling included. */
+    double demangle;            /**< Demangling, summed over all threads. */
+    double deduplicate;         /**< Computing crash signatures, when deduplicating. */
+} symbolicator_batch_timings_t;
+
+/** Use of the resolved frame cache kept with a symbolicator_cache_t. */
+typedef struct {
+    uint64_t lookups;           /**< Frames looked up since the cache was opened. */
+    uint64_t hits;              /**< Lookups answered from the cache. */
+    size_t frames;              /**< Frames cached now, loaded ones included. */
+    uint64_t bytes;             /**< Approximate memory the cached frames and their names take. */
+} symbolicator_frame_cache_stats_t;
+
+/** Reports of a batch that share a crash signature. */
+typedef struct {
+    uint64_t hash;              /**< 64-bit FNV-1a hash of signature. */
+    const char *signature;      /**< Exception type, then one "image!function" line per top frame. */
+    const char *const *names;   /**< Names of the reports; the first is the one delivered. */
+    size_t count;               /**< Number of reports in the bucket. */
+} symbolicator_batch_bucket_t;
+
+/**
+ * Asked once per batch run for the images that are neither cached nor
+ * registered. Register the binaries found with symbolicator_batch_add_binary().
+ */
+typedef void (*symbolicator_batch_locate_cb_t)(symbolicator_batch_t batch, const symbolicator_image_key_t *keys, size_t count, void *user_data);
+
+/**
+ * Receives each finished report of a batch, as soon as it is done, on the
+ * thread running the batch, one at a time. output is NULL when error is
+ * set, except in SYMBOLICATOR_BATCH_FORMAT_JSON, where it is the record of
+ * the failed report. Reports wait to be resolved while it runs, so a slow callback holds
+ * the batch back instead of piling up results.
+ */
+typedef void (*symbolicator_batch_result_cb_t)(const char *name, const char *output, size_t length, const char *error, void *user_data);
+
+
+/**
+ * Maps a Mach-O binary (usually the DWARF file inside a dSYM bundle) and
+ * builds its address to function/file/line index. Of a universal (fat or
+ * fat64) binary only the selected slice is mapped. The line table of each
+ * compilation unit is decoded the first time a lookup lands in it, so the
+ * binary stays mapped until the image is freed. path may also name a symbol
+ * store written by symbolicator_store_export().
+ *
+ * @param path Path to the Mach-O file.
+ * @param arch Architecture name as understood by atos ("arm64", "x86_64",
+ *     "armv7", ...). Selects the slice of a universal binary. Pass NULL to
+ *     accept the only slice of a thin or single-slice universal binary.
+ * @param image Pointer that will be set to a newly allocated
+ *     symbolicator_image_t upon successful return. Must be freed using
+ *     symbolicator_image_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_ARCH_NOT_FOUND if
+ *     the binary has no slice for arch, or another SYMBOLICATOR_E_* error
+ *     code otherwise.
+ */
+symbolicator_error_t symbolicator_image_open(const char *path, const char *arch, symbolicator_image_t *image);
+
+/**
+ * Frees an image and all strings returned from it.
+ *
+ * @param image The image to free.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if image is NULL.
+ */
+symbolicator_error_t symbolicator_image_free(symbolicator_image_t image);
+
+/**
+ * Copies the LC_UUID of the selected slice.
+ *
+ * @param image The image to query.
+ * @param uuid Buffer of 16 bytes receiving the UUID. Zero filled when the
+ *     binary has no LC_UUID load command.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_image_get_uuid(symbolicator_image_t image, uint8_t uuid[16]);
+
+/**
+ * Returns the file name of the indexed binary, as atos prints it after "in".
+ *
+ * @param image The image to query.
+ *
+ * @return A NUL-terminated string owned by the image, or NULL if image is NULL.
+ */
+const char *symbolicator_image_get_name(symbolicator_image_t image);
+
+/**
+ * Resolves a batch of runtime addresses. Equivalent to
+ * `atos -o <path> -arch <arch> -l <load_address> <addresses...>`.
+ *
+ * The image is immutable once opened, so concurrent lookups on the same
+ * image are safe. Large batches, such as the thousands of addresses of a
+ * sample or spindump report, are sorted and resolved in one sweep over the
+ * symbol tables; frames still come back in the order of addresses.
+ *
+ * @param image The image to query.
+ * @param load_address Runtime address the image's __TEXT segment was loaded at.
+ * @param addresses Runtime addresses to resolve.
+ * @param count Number of entries in addresses and frames.
+ * @param frames Caller allocated array receiving one frame per address.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid, or SYMBOLICATOR_E_NO_MEMORY.
+ */
+symbolicator_error_t symbolicator_image_lookup(symbolicator_image_t image, uint64_t load_address, const uint64_t *addresses, size_t count, symbolicator_frame_t *frames);
+
+/**
+ * Resolves one runtime address into the chain of calls inlined at it, like
+ * `atos -i`: the innermost inlined call first and the function they were
+ * inlined into last. Each outer frame carries the file and line of the call
+ * it made; all frames share the function_offset of the address.
+ *
+ * @param image The image to query.
+ * @param load_address Runtime address the image's __TEXT segment was loaded at.
+ * @param address Runtime address to resolve.
+ * @param frames Caller allocated array receiving up to capacity frames.
+ * @param capacity Number of entries in frames.
+ * @param count Receives the length of the whole chain, which is 1 when
+ *     nothing is inlined at the address. When it exceeds capacity, only
+ *     the innermost capacity frames were written.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_image_lookup_inlined(symbolicator_image_t image, uint64_t load_address, uint64_t address, symbolicator_frame_t *frames, size_t capacity, size_t *count);
+
+/**
+ * Indexes a Mach-O binary and writes the index as a symbol store: a
+ * compressed file that resolves addresses, inlined calls included, exactly
+ * like the binary and is typically a fraction of the dSYM's size. Stores
+ * can be passed wherever a binary path is accepted, and catalogs find them
+ * when they are named *.symstore. A lookup decompresses only the blocks of
+ * line rows and names it touches.
+ *
+ * @param path Path to the Mach-O file.
+ * @param arch Architecture name, or NULL for a thin binary.
+ * @param output Path of the store to write, replaced atomically.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_ARCH_NOT_FOUND if
+ *     the binary has no slice for arch, or another SYMBOLICATOR_E_* error
+ *     code otherwise.
+ */
+symbolicator_error_t symbolicator_store_export(const char *path, const char *arch, const char *output);
+
+/**
+ * Opens a directory of cached symbol indexes, keyed by binary UUID and
+ * architecture. The directory is created on first write. Batches created
+ * with the cache also share a cache of resolved frames, keyed by image
+ * UUID, architecture and offset, of up to 64 MiB; it is loaded from the
+ * directory here and written back by symbolicator_cache_save_frames().
+ *
+ * @param directory Directory holding the index files.
+ * @param max_bytes Size the directory is trimmed to, least recently used
+ *     indexes first, whenever a new index is stored.
+ * @param cache Pointer that will be set to a newly allocated
+ *     symbolicator_cache_t upon successful return. Must be freed using
+ *     symbolicator_cache_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_cache_new(const char *directory, uint64_t max_bytes, symbolicator_cache_t *cache);
+
+/**
+ * Frees a cache handle. Images opened through it stay valid.
+ *
+ * @param cache The cache to free.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if cache is NULL.
+ */
+symbolicator_error_t symbolicator_cache_free(symbolicator_cache_t cache);
+
+/**
+ * Like symbolicator_image_open(), but reuses the cached index for the
+ * binary's UUID when there is one, and stores a newly built index otherwise.
+ *
+ * @param cache The cache to consult.
+ * @param path Path to the Mach-O file.
+ * @param arch Architecture name, or NULL for a thin binary.
+ * @param image Pointer that will be set to a newly allocated
+ *     symbolicator_image_t upon successful return. Must be freed using
+ *     symbolicator_image_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or an SYMBOLICATOR_E_* error
+ *     code otherwise.
+ */
+symbolicator_error_t symbolicator_cache_open_image(symbolicator_cache_t cache, const char *path, const char *arch, symbolicator_image_t *image);
+
+/**
+ * Loads a cached index by UUID without touching the dSYM.
+ *
+ * @param cache The cache to consult.
+ * @param uuid The 16 byte LC_UUID of the binary.
+ * @param arch Architecture name the index was stored under.
+ * @param image Pointer that will be set to a newly allocated
+ *     symbolicator_image_t upon successful return. Must be freed using
+ *     symbolicator_image_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_NOT_FOUND if no
+ *     index is cached for uuid and arch, or another SYMBOLICATOR_E_* error
+ *     code otherwise.
+ */
+symbolicator_error_t symbolicator_cache_find_image(symbolicator_cache_t cache, const uint8_t uuid[16], const char *arch, symbolicator_image_t *image);
+
+/**
+ * Writes the resolved frame cache into the cache directory, so the next
+ * process to open it starts with the frames resolved so far.
+ *
+ * @param cache The cache to save.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or an SYMBOLICATOR_E_* error
+ *     code otherwise.
+ */
+symbolicator_error_t symbolicator_cache_save_frames(symbolicator_cache_t cache);
+
+/**
+ * Reports the hit rate and size of the resolved frame cache.
+ *
+ * @param cache The cache to query.
+ * @param stats Set to the statistics.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_cache_get_frame_stats(symbolicator_cache_t cache, symbolicator_frame_cache_stats_t *stats);
+
+/**
+ * Parses a text crash, spindump or sample report in a single pass over its
+ * lines.
+ *
+ * @param text The report text; need not be NUL-terminated.
+ * @param length Length of text in bytes.
+ * @param report Pointer that will be set to a newly allocated
+ *     symbolicator_report_t upon successful return. Must be freed using
+ *     symbolicator_report_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_parse(const char *text, size_t length, symbolicator_report_t *report);
+
+/**
+ * Maps a report file and parses it in place; the strings of the report
+ * point into the mapping rather than a copy. An .ips report is translated
+ * to the text format first, as symbolicator_ips_translate() does, and
+ * parsed from the translation; one that cannot be translated is parsed as
+ * it is.
+ *
+ * @param path Path of the report file.
+ * @param report Pointer that will be set to a newly allocated
+ *     symbolicator_report_t upon successful return. Must be freed using
+ *     symbolicator_report_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_IO_ERROR if the
+ *     file cannot be read, SYMBOLICATOR_E_BAD_FORMAT if it holds nothing
+ *     but whitespace, or SYMBOLICATOR_E_INVALID_ARG if one or more
+ *     parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_open(const char *path, symbolicator_report_t *report);
+
+/**
+ * Frees a report and all strings returned from it.
+ *
+ * @param report The report to free.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if report is NULL.
+ */
+symbolicator_error_t symbolicator_report_free(symbolicator_report_t report);
+
+/**
+ * Copies the header fields of a report.
+ *
+ * @param report The report to query.
+ * @param info Receives the fields. Strings are owned by the report.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_get_info(symbolicator_report_t report, symbolicator_report_info_t *info);
+
+/**
+ * Returns the text a report was parsed from, which the byte offsets of its
+ * frames refer to: the file contents, or the translation of an .ips file.
+ *
+ * @param report The report to query.
+ * @param text Set to the text, owned by the report; not NUL-terminated.
+ * @param length Set to the length of text in bytes.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_get_text(symbolicator_report_t report, const char **text, size_t *length);
+
+/**
+ * Returns the binary image table of a report, in report order.
+ *
+ * @param report The report to query.
+ * @param images Set to an array owned by the report.
+ * @param count Set to the number of entries in images.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_get_images(symbolicator_report_t report, const symbolicator_report_image_t **images, size_t *count);
+
+/**
+ * Returns every frame address of a report, in report order.
+ *
+ * @param report The report to query.
+ * @param frames Set to an array owned by the report.
+ * @param count Set to the number of entries in frames.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_get_frames(symbolicator_report_t report, const symbolicator_report_frame_t **frames, size_t *count);
+
+/**
+ * Renders the symbolicated report: the parsed text with each frame's
+ * unresolved symbol replaced, in a single pass. Backtrace lines become
+ * "<address> <replacement>", sample lines "<replacement> [<address>]".
+ * A replacement with several newline separated entries, such as an inline
+ * chain from symbolicator_image_lookup_inlined(), repeats a backtrace line
+ * once per entry; sample lines keep only the last entry.
+ *
+ * @param report The report to render.
+ * @param replacements One entry per frame, in the order returned by
+ *     symbolicator_report_get_frames(). NULL entries keep the frame as is.
+ * @param count Number of entries in replacements.
+ * @param output Set to the rendered text, owned by the report and valid
+ *     until the next render or symbolicator_report_free().
+ * @param length Set to the length of output in bytes.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_report_render(symbolicator_report_t report, const char *const *replacements, size_t count, const char **output, size_t *length);
+
+/**
+ * Creates a batch that symbolicates many reports over a shared pool of
+ * threads, loading the symbols of each distinct image once.
+ *
+ * @param cache Index cache to read and store symbol indexes, or NULL.
+ * @param threads Number of worker threads, 0 for one per core.
+ * @param batch Pointer that will be set to a newly allocated
+ *     symbolicator_batch_t upon successful return. Must be freed using
+ *     symbolicator_batch_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or an SYMBOLICATOR_E_* error
+ *     code otherwise.
+ */
+symbolicator_error_t symbolicator_batch_new(symbolicator_cache_t cache, unsigned threads, symbolicator_batch_t *batch);
+
+/**
+ * Frees a batch and stops its threads.
+ *
+ * @param batch The batch to free.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if batch is NULL.
+ */
+symbolicator_error_t symbolicator_batch_free(symbolicator_batch_t batch);
+
+/**
+ * Adds a report given as text. The text is copied. .ips reports are
+ * translated to the text format before they are parsed.
+ *
+ * @param batch The batch to add to.
+ * @param name Name handed back with the result.
+ * @param text Report text; need not be NUL-terminated.
+ * @param length Length of text in bytes.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_batch_add_report(symbolicator_batch_t batch, const char *name, const char *text, size_t length);
+
+/**
+ * Adds a report file, read by a worker when the batch runs. Its path is
+ * the name handed back with the result.
+ *
+ * @param batch The batch to add to.
+ * @param path Path to a text or .ips crash report.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_batch_add_report_file(symbolicator_batch_t batch, const char *path);
+
+/**
+ * Registers the Mach-O file (usually the DWARF file of a dSYM) holding the
+ * symbols of the binary with the given UUID.
+ *
+ * @param batch The batch to register with.
+ * @param uuid The 16 byte LC_UUID.
+ * @param path Path to the Mach-O file.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_batch_add_binary(symbolicator_batch_t batch, const uint8_t uuid[16], const char *path);
+
+/**
+ * Makes the batch expand each frame into the calls inlined at its address,
+ * from the DWARF inlined subroutine records. Text reports then repeat a
+ * backtrace line once per call, innermost first; .ips text output marks
+ * the inlined ones "[inlined]". Off by default.
+ *
+ * @param batch The batch to configure. Must not be running.
+ * @param enabled Nonzero to expand inlined calls.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if batch is NULL.
+ */
+symbolicator_error_t symbolicator_batch_set_expand_inlines(symbolicator_batch_t batch, int enabled);
+
+/**
+ * Makes the batch demangle Swift and C++ function names. Each distinct name
+ * is demangled once for the lifetime of the batch; names the demangler does
+ * not cover are left as they are. Off by default.
+ *
+ * @param batch The batch to configure. Must not be running.
+ * @param enabled Nonzero to demangle function names.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if batch is NULL.
+ */
+symbolicator_error_t symbolicator_batch_set_demangle(symbolicator_batch_t batch, int enabled);
+
+/**
+ * Makes the batch group reports by crash signature, the exception type and
+ * the top frames of the crashing thread, and resolve and deliver only the
+ * first report of each group. Query the groups with
+ * symbolicator_batch_get_buckets(). Reports that fail to parse or have no
+ * crashing thread frames are delivered on their own. Off by default.
+ *
+ * @param batch The batch to configure. Must not be running.
+ * @param frames Number of frames in a signature, or 0 to turn grouping off.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if batch is NULL.
+ */
+symbolicator_error_t symbolicator_batch_set_deduplicate(symbolicator_batch_t batch, unsigned frames);
+
+/**
+ * Selects what the result callback receives. In SYMBOLICATOR_BATCH_FORMAT_JSON
+ * each report arrives as one structured record holding its header fields,
+ * its threads and their frames with image, image offset, symbol, file, line
+ * and inline chain, and its binary images. A record never contains a
+ * newline, so appending one per report streams NDJSON. Records are written
+ * straight from the resolved frames, without re-parsing any text or
+ * building a document tree. SYMBOLICATOR_BATCH_FORMAT_TEXT is the default.
+ *
+ * @param batch The batch to configure. Must not be running.
+ * @param format The output format.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if batch is NULL or format is unknown.
+ */
+symbolicator_error_t symbolicator_batch_set_format(symbolicator_batch_t batch, symbolicator_batch_format_t format);
+
+/**
+ * Parses every report in parallel, loads the symbols of each image their
+ * frames point into once, then resolves and renders the reports, handing
+ * each one to result as it completes. Reports stream through a bounded
+ * pipeline, so only a few dozen are in memory at once however many the
+ * batch holds. Blocks until all are delivered. A batch can be run again,
+ * for instance after changing its settings; every report is read and
+ * parsed anew, and images already loaded are reused.
+ *
+ * @param batch The batch to run.
+ * @param locate Called with the images still lacking symbols, or NULL.
+ * @param result Called with each finished report.
+ * @param user_data Passed to both callbacks.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or an SYMBOLICATOR_E_* error
+ *     code otherwise. Failures of single reports go to result instead.
+ */
+symbolicator_error_t symbolicator_batch_run(symbolicator_batch_t batch, symbolicator_batch_locate_cb_t locate, symbolicator_batch_result_cb_t result, void *user_data);
+
+/**
+ * Reports how long each stage of the last symbolicator_batch_run() took.
+ *
+ * @param batch The batch to query. Must not be running.
+ * @param timings Set to the stage timings, all zero before the first run.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_batch_get_timings(symbolicator_batch_t batch, symbolicator_batch_timings_t *timings);
+
+/**
+ * Lists the signature buckets of the last symbolicator_batch_run(), ordered
+ * by the first report of each. Empty when deduplication is off.
+ *
+ * @param batch The batch to query. Must not be running.
+ * @param buckets Set to the buckets, owned by the batch and valid until it
+ *     is run again or freed.
+ * @param count Set to the number of buckets.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_batch_get_buckets(symbolicator_batch_t batch, const symbolicator_batch_bucket_t **buckets, size_t *count);
+
+/**
+ * Opens a catalog mapping binary UUIDs to the Mach-O files below a set of
+ * search roots, read from their LC_UUID load commands.
+ *
+ * @param file File the catalog is loaded from and saved to, or NULL to keep
+ *     it in memory. A missing or incompatible file starts an empty catalog.
+ * @param catalog Pointer that will be set to a newly allocated
+ *     symbolicator_catalog_t upon successful return. Must be freed using
+ *     symbolicator_catalog_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_catalog_new(const char *file, symbolicator_catalog_t *catalog);
+
+/**
+ * Frees a catalog.
+ *
+ * @param catalog The catalog to free.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or SYMBOLICATOR_E_INVALID_ARG
+ *     if catalog is NULL.
+ */
+symbolicator_error_t symbolicator_catalog_free(symbolicator_catalog_t catalog);
+
+/**
+ * Scans the roots in parallel and saves the catalog. Directories whose
+ * modification time is unchanged since the last scan are not listed again,
+ * so refreshing an unchanged tree reads no files.
+ *
+ * @param catalog The catalog to refresh.
+ * @param roots Directories or Mach-O files to search.
+ * @param count Number of entries in roots.
+ * @param threads Number of worker threads, 0 for one per core.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, or an SYMBOLICATOR_E_* error
+ *     code otherwise. Roots that do not exist are skipped.
+ */
+symbolicator_error_t symbolicator_catalog_refresh(symbolicator_catalog_t catalog, const char *const *roots, size_t count, unsigned threads);
+
+/**
+ * Refreshes the directories among the roots, then keeps the catalog up to
+ * date in the background from filesystem change notifications (FSEvents on
+ * macOS, inotify on Linux) until it is freed. Bundles added below a root
+ * can be found within a second or so, and the catalog is saved after each
+ * update. Calling it again only refreshes.
+ *
+ * @param catalog The catalog to keep up to date.
+ * @param roots Directories to watch.
+ * @param count Number of entries in roots.
+ * @param threads Number of threads scanning changed directories, 0 for one
+ *     per core.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_IO_ERROR when
+ *     the system has no change notifications (the roots are still
+ *     refreshed), or another SYMBOLICATOR_E_* error code otherwise.
+ */
+symbolicator_error_t symbolicator_catalog_watch(symbolicator_catalog_t catalog, const char *const *roots, size_t count, unsigned threads);
+
+/**
+ * Scans the roots concurrently for the dSYM bundles of several binaries,
+ * stopping as soon as one has been seen for each UUID, so one batch of
+ * reports costs one scan however many images it names. Directories listed
+ * on the way join the catalog, which is then saved; UUIDs already found in
+ * a dSYM are not searched for. Look the bundles up with
+ * symbolicator_catalog_find() afterwards.
+ *
+ * @param catalog The catalog to search with.
+ * @param uuids uuid_count LC_UUIDs of 16 bytes each.
+ * @param uuid_count Number of UUIDs.
+ * @param roots Directories or Mach-O files to search.
+ * @param count Number of entries in roots.
+ * @param threads Number of worker threads, 0 for one per core.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS when a dSYM was found for every UUID,
+ *     SYMBOLICATOR_E_NOT_FOUND when some are missing, or another
+ *     SYMBOLICATOR_E_* error code otherwise.
+ */
+symbolicator_error_t symbolicator_catalog_search(symbolicator_catalog_t catalog, const uint8_t *uuids, size_t uuid_count, const char *const *roots, size_t count, unsigned threads);
+
+/**
+ * Looks up the Mach-O file of a binary UUID. The DWARF file of a dSYM
+ * bundle is preferred over other binaries with the same UUID.
+ *
+ * @param catalog The catalog to query.
+ * @param uuid The 16 byte LC_UUID.
+ * @param arch Architecture name the file must have a slice for, or NULL.
+ * @param path Pointer that will be set to a newly allocated NUL-terminated
+ *     path upon successful return. Must be freed using
+ *     symbolicator_string_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_NOT_FOUND if no
+ *     file with uuid is known, or SYMBOLICATOR_E_INVALID_ARG if one or more
+ *     parameters are invalid.
+ */
+symbolicator_error_t symbolicator_catalog_find(symbolicator_catalog_t catalog, const uint8_t uuid[16], const char *arch, char **path);
+
+/**
+ * Translates an .ips crash report (a JSON header line followed by a JSON
+ * payload) into the legacy text crash format, reading the payload in one
+ * streaming pass.
+ *
+ * @param json The .ips contents; need not be NUL-terminated.
+ * @param length Length of json in bytes.
+ * @param text Pointer that will be set to a newly allocated NUL-terminated
+ *     string upon successful return. Must be freed using
+ *     symbolicator_string_free() after use.
+ * @param text_length Set to the length of text, may be NULL.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_BAD_FORMAT if the
+ *     payload is not valid JSON, or SYMBOLICATOR_E_INVALID_ARG if one or more
+ *     parameters are invalid.
+ */
+symbolicator_error_t symbolicator_ips_translate(const char *json, size_t length, char **text, size_t *text_length);
+
+/**
+ * Demangles a Swift or Itanium C++ symbol name, as found in Mach-O symbol
+ * tables or DWARF. Swift names come out in the short form atos prints.
+ *
+ * @param mangled NUL-terminated mangled name.
+ * @param demangled Pointer that will be set to a newly allocated
+ *     NUL-terminated string upon successful return. Must be freed using
+ *     symbolicator_string_free() after use.
+ *
+ * @return SYMBOLICATOR_E_SUCCESS on success, SYMBOLICATOR_E_BAD_FORMAT if
+ *     mangled is not a name the demangler understands, or
+ *     SYMBOLICATOR_E_INVALID_ARG if one or more parameters are invalid.
+ */
+symbolicator_error_t symbolicator_demangle(const char *mangled, char **demangled);
+
+/**
+ * Frees a string allocated by the library.
+ *
+ * @param string The string to free, may be NULL.
+ */
+void symbolicator_string_free(char *string);
+
+/**
+ * Returns a description of the last error raised on the calling thread.
+ *
+ * @return A NUL-terminated string owned by the library. Empty when no error
+ *     has been recorded.
+ */
+const char *symbolicator_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+//
+//  work_pool.cpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#include "work_pool.hpp"
+
+#include <algorithm>
+
+namespace symbolicator {
+
+namespace {
+
+/// Pool and index of the worker running on this thread, if any.
+thread_local const void *currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+WorkPool::WorkPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned index = 0; index < threads; ++index) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned index = 0; index < threads; ++index) {
+        threads_.emplace_back([this, index] { loop(index); });
+    }
+}
+
+WorkPool::~WorkPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkPool::submit(std::function<void()> task) {
+    const size_t target = currentPool == this ? currentWorker : next_++ % workers_.size();
+    pending_++;
+    {
+        std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+        workers_[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++queued_;
+    }
+    wake_.notify_one();
+    idle_.notify_all();
+}
+
+bool WorkPool::runOne(size_t self) {
+    std::function<void()> task;
+    const size_t count = workers_.size();
+    for (size_t step = 0; step < count && !task; ++step) {
+        Worker &worker = *workers_[(self + step) % count];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            continue;
+        }
+        // Own deque: newest first, for locality. Others: steal the oldest.
+        if (step == 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --queued_;
+    }
+    task();
+    if (--pending_ == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.notify_all();
+    }
+    return true;
+}
+
+void WorkPool::loop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    for (;;) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+void WorkPool::wait() {
+    const size_t self = currentPool == this ? currentWorker : next_++ % workers_.size();
+    while (pending_ > 0) {
+        if (runOne(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0 || queued_ > 0; });
+    }
+}
+
+} // namespace symbolicator
@@ -0,0 +1,70 @@
+//
+//  work_pool.hpp
+//  SymbolicatorX
+//
+//  Created by 钟晓跃 on 2026/10/17.
+//  Copyright © 2026 钟晓跃. All rights reserved.
+//
+
+#ifndef SYMBOLICATOR_WORK_POOL_HPP
+#define SYMBOLICATOR_WORK_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace symbolicator {
+
+/// Fixed set of threads with one task deque each. A worker pops its own
+/// newest task first and, when it runs dry, steals the oldest task of
+/// another worker, so tasks spawned from tasks stay local while idle
+/// threads still pick up stragglers. Tasks must not throw.
+class WorkPool {
+public:
+    /// `threads` of 0 uses one thread per hardware core.
+    explicit WorkPool(unsigned threads = 0);
+    ~WorkPool();
+
+    WorkPool(const WorkPool &) = delete;
+    WorkPool &operator=(const WorkPool &) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+    /// Queues `task`; from inside a task it goes to the current worker's deque.
+    void submit(std::function<void()> task);
+
+    /// Returns once every submitted task, including tasks submitted while
+    /// waiting, has finished. The calling thread runs tasks meanwhile.
+    /// Must not be called from inside a task.
+    void wait();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool runOne(size_t self);
+    void loop(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    size_t queued_ = 0;                 // guarded by mutex_
+    bool stopping_ = false;             // guarded by mutex_
+    std::atomic<size_t> pending_ {0};   // queued plus running
+    std::atomic<size_t> next_ {0};
+};
+
+} // namespace symbolicator
+
+#endif
@@ -15,3 +15,4 @@
 #include <libimobiledevice/house_arrest.h>
 #import <usbmuxd/usbmuxd-proto.h>
 #import <usbmuxd/usbmuxd.h>
+#import <libsymbolicator/symbolicator.h>
@@ -13,6 +13,10 @@ extension String {
     var trimmed: String {
         return trimmingCharacters(in: .whitespacesAndNewlines)
     }
+    
+    var nonEmpty: String? {
+        return isEmpty ? nil : self
+    }
 
     func run() -> (output: String?, error: String?) {
         let pipe = Pipe()
@@ -28,41 +28,107 @@ class DSYMSearch {
             guard foundItem == nil else { return }
             
             DispatchQueue.global().async {
-                if let crashFileDirectory = crashFileDirectory, let results = FileSearch.search(fileExtension: "dsym", directory: crashFileDirectory, recursive: false), let foundUUID = firstMatching(paths: results, uuid: uuid, errorHandler: errorHandler) {
-                    
-                    completion(foundUUID)
-                } else if let results = FileSearch.search(fileExtension: "dsym", directory: "~/Library/Developer/Xcode/Archives/", recursive: true), let foundUUID = firstMatching(paths: results, uuid: uuid, errorHandler: errorHandler) {
-                    
-                    completion(foundUUID)
-                } else {
-                    
-                    completion(nil)
-                }
+                
+                let found = catalogSearch(forUUIDs: [uuid], crashFileDirectory: crashFileDirectory, errorHandler: errorHandler)
+                completion(found[uuid])
             }
         }
     }
     
-    private static func firstMatching(paths: [String], uuid: String, errorHandler: @escaping ErrorHandler) -> String? {
+    /// Looks up several UUIDs with a single Spotlight query. Completes on the
+    /// main queue with the dSYM path of every UUID that was found.
+    static func search(forUUIDs uuids: [String], completion: @escaping ([String: String]) -> Void) {
         
-        return paths.first { file in
-            let command = "dwarfdump --uuid \"\(file)\""
-            let (output, error) = command.run()
-
-            if let errorOutput = error?.trimmed, !errorOutput.isEmpty {
-                errorHandler(["\(command):\n\(errorOutput)"])
+        guard !uuids.isEmpty else {
+            completion([:])
+            return
+        }
+        
+        let predicate = NSCompoundPredicate(orPredicateWithSubpredicates: uuids.map {
+            NSPredicate(format: "com_apple_xcode_dsym_uuids == %@", $0)
+        })
+        let spotlightSearch = SpotlightSearch()
+        spotlightSearch.search(forPredicate: predicate) { (results) in
+            
+            var paths = [String: String]()
+            results?.forEach { metadataItem in
+                let itemUUIDs = metadataItem.value(forAttribute: "com_apple_xcode_dsym_uuids") as? [String] ?? []
+                uuids.filter(itemUUIDs.contains).forEach { uuid in
+                    if paths[uuid] == nil, let dsymPath = dsymPath(from: metadataItem, withUUID: uuid) {
+                        paths[uuid] = dsymPath
+                    }
+                }
             }
-
-            guard
-                let dwarfDumpOutput = output?.trimmed,
-                let foundUUID = dwarfDumpOutput.scan(pattern: "UUID: (.*) \\(").first?.first
-            else {
-                return false
+            
+            // Keeps the query alive until it has finished gathering.
+            withExtendedLifetime(spotlightSearch) {
+                completion(paths)
             }
-
-            return foundUUID == uuid
         }
     }
     
+    /// Where Xcode puts archives, dSYMs included.
+    static let archivesDirectory = "~/Library/Developer/Xcode/Archives/"
+    /// Where Xcode puts builds, which carry a dSYM in Release.
+    static let derivedDataDirectory = "~/Library/Developer/Xcode/DerivedData/"
+    
+    /// Keeps the catalog's view of Xcode's Archives current from FSEvents,
+    /// so a fresh archive is found before Spotlight has indexed it.
+    static func watchArchives() {
+        
+        Symbolicator.queue.addOperation {
+            try? DSYMCatalog.shared?.watch(roots: [archivesDirectory])
+        }
+    }
+    
+    /// Symbol stores searched besides Xcode's folders, set with
+    /// `defaults write <bundle id> symbolStores -array <path>...`.
+    static var symbolStores: [String] {
+        UserDefaults.standard.stringArray(forKey: "symbolStores") ?? []
+    }
+    
+    /// Looks up `uuids` where Spotlight has no answer, through the persistent
+    /// UUID catalog. UUIDs it does not know yet are searched for in one pass
+    /// over the dSYMs next to the crash file, Xcode's Archives and
+    /// DerivedData and the symbol stores together, which stops as soon as
+    /// each of them has been found.
+    /// Blocks; returns the dSYM path of every UUID that was found.
+    static func catalogSearch(forUUIDs uuids: [String], crashFileDirectory: String?, errorHandler: ErrorHandler? = nil) -> [String: String] {
+        
+        guard !uuids.isEmpty, let catalog = DSYMCatalog.shared else { return [:] }
+        
+        var paths = [String: String]()
+        let lookUp = { (uuids: [String]) in
+            uuids.forEach { uuid in
+                if let binaryUUID = BinaryUUID(uuid), let dsymPath = catalog.dsymPath(uuid: binaryUUID) {
+                    paths[uuid] = dsymPath
+                }
+            }
+        }
+        lookUp(uuids)
+        
+        let missing = uuids.filter { paths[$0] == nil }
+        let missingUUIDs = missing.compactMap { BinaryUUID($0) }
+        guard !missingUUIDs.isEmpty else { return paths }
+        
+        var roots = [String]()
+        if let crashFileDirectory = crashFileDirectory {
+            roots += FileSearch.search(fileExtension: "dsym", directory: crashFileDirectory, recursive: false) ?? []
+        }
+        roots += [archivesDirectory, derivedDataDirectory] + symbolStores
+        
+        do {
+            try catalog.search(uuids: missingUUIDs, roots: roots)
+        } catch let error as SymbolicatorError {
+            errorHandler?([error.message])
+        } catch {
+            errorHandler?(["\(error)"])
+        }
+        
+        lookUp(missing)
+        return paths
+    }
+    
     private static func dsymPath(from metadataItem: NSMetadataItem, withUUID uuid: String) -> String? {
         
         guard
@@ -13,7 +13,9 @@ class SpotlightSearch {
     typealias CompletionHandler = ([NSMetadataItem]?) -> Void
     
     static let shared  = SpotlightSearch()
-    private init() {}
+    
+    /// Separate instances run their queries independently of `shared`.
+    init() {}
     
     private var query = NSMetadataQuery()
     private var completion: CompletionHandler?
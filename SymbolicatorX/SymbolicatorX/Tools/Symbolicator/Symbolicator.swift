@@ -13,9 +13,32 @@ class Symbolicator {
     typealias CompletionHandler = (String) -> Void
     typealias ErrorHandler = (String) -> Void
     
-    static func symbolicate(crashFile: CrashFile, dsymFile: DSYMFile, errorHandler: @escaping ErrorHandler, completion: @escaping CompletionHandler) {
+    /// Symbolication runs here rather than on the global queues, so a burst
+    /// of requests takes one core each instead of a thread each.
+    static let queue: OperationQueue = {
+        let queue = OperationQueue()
+        queue.name = "Symbolicator"
+        queue.qualityOfService = .userInitiated
+        queue.maxConcurrentOperationCount = ProcessInfo.processInfo.activeProcessorCount
+        return queue
+    }()
+    
+    static func symbolicate(crashFile: CrashFile, dsymFile: DSYMFile?, errorHandler: @escaping ErrorHandler, completion: @escaping CompletionHandler) {
         
-        DispatchQueue.global().async {
+        queue.addOperation {
+            
+            if crashFile.ipsContent != nil || crashFile.ipsPath != nil {
+                symbolicate(ipsOf: crashFile, dsymFile: dsymFile, errorHandler: errorHandler, completion: completion)
+                return
+            }
+            
+            // Text reports carry the position and image of every frame, so
+            // each image is resolved on its own and the output is written in
+            // one pass instead of searching for each address.
+            if let report = crashFile.report {
+                symbolicate(report: report, of: crashFile, dsymFile: dsymFile, errorHandler: errorHandler, completion: completion)
+                return
+            }
             
             guard let architecture = crashFile.architecture else {
                 errorHandler("Could not detect crash file architecture.")
@@ -32,56 +55,237 @@ class Symbolicator {
                 return
             }
             
-            let command = symbolicationCommand(dsymPath: dsymFile.binaryPath,architecture: architecture.atosString!,loadAddress: loadAddress,addresses: addresses)
-            let result = command.run()
-            
-            if let error = result.error?.trimmed, error != "" { errorHandler(error)
+            let image: SymbolImage
+            do {
+                image = try loadImage(crashFile: crashFile, dsymFile: dsymFile, architecture: architecture.atosString)
+            } catch let error as SymbolicatorError {
+                errorHandler("Could not load symbols from \(dsymFile?.filename ?? "cache"): \(error.message)")
                 return
-            }
-            
-            guard
-                let output = result.output?.trimmed,
-                output.components(separatedBy: .newlines).count > 0
-            else {
-                errorHandler("atos command gave no output")
+            } catch {
+                errorHandler("\(error)")
                 return
             }
             
-            let outputLines = output.components(separatedBy: .newlines)
-            guard addresses.count == outputLines.count else {
-                errorHandler("Unexpected result from atos command:\n\(output)")
+            let loadAddressValue = UInt64(truncatingIfNeeded: loadAddress.hex() ?? 0)
+            let imageName = (try? image.name()) ?? crashFile.processName ?? ""
+            
+            let frames: [SymbolFrame]
+            do {
+                frames = try image.lookup(
+                    loadAddress: loadAddressValue,
+                    addresses: addresses.map { UInt64(truncatingIfNeeded: $0.hex() ?? 0) }
+                )
+            } catch {
+                errorHandler("\(error)")
                 return
             }
             
             var replacedContent = crashFile.content
-            for index in 0..<outputLines.count {
-                
-                let address = addresses[index]
-                let replacement = outputLines[index]
-
-                if crashFile.crashFileType == .crashinfo {
-                    replacedContent = replacedContent.replacingOccurrences(of: address, with: replacement)
-                } else {
-                    let sampleOccurences = replacedContent.scan(pattern: "\\?{3}.*?\\[\(address)\\]").flatMap { $0 }
-                    sampleOccurences.forEach {
-                        replacedContent = replacedContent.replacingOccurrences(of: $0, with: "\(replacement) [\(address)]")
-                    }
-
-                    let crashOccurences = replacedContent.scan(pattern: "\(address)\\s.*?$").flatMap { $0 }
-                    crashOccurences.forEach {
-                        replacedContent = replacedContent.replacingOccurrences(of: $0, with: "\(address) \(replacement)")
+            for (address, frame) in zip(addresses, frames) {
+                replacedContent = replacedContent.replacingOccurrences(of: address, with: frame.atosDescription(address: address, imageName: imageName))
+            }
+            
+            completion(replacedContent)
+        }
+    }
+    
+    /// Resolves the frames of every image that has symbols, each against its
+    /// own architecture and load address. Frames of an image without a load
+    /// address or symbols, the main executable included, are left as they are;
+    /// a chosen dSYM that fails to load is reported after the result.
+    private static func symbolicate(report: CrashReport, of crashFile: CrashFile, dsymFile: DSYMFile?, errorHandler: @escaping ErrorHandler, completion: @escaping CompletionHandler) {
+        
+        var replacements = [String?](repeating: nil, count: report.frames.count)
+        var dsymError: String?
+        do {
+            let mainIndices = report.frames.indices.filter { report.frames[$0].isMainImage }
+            if !mainIndices.isEmpty, let mainImage = report.mainImage {
+                var image: SymbolImage?
+                do {
+                    image = try loadImage(crashFile: crashFile, dsymFile: dsymFile, architecture: architecture(of: mainImage, default: crashFile.architecture))
+                } catch {
+                    // Without a chosen dSYM the main image just has no symbols yet.
+                    if let dsymFile = dsymFile {
+                        let message = (error as? SymbolicatorError)?.message ?? "\(error)"
+                        dsymError = "Could not load symbols from \(dsymFile.filename): \(message)"
                     }
                 }
+                if let image = image {
+                    try resolve(mainIndices, of: report, with: image, loadAddress: mainImage.start, into: &replacements)
+                }
+            } else if !mainIndices.isEmpty, dsymFile != nil {
+                dsymError = "Could not detect application load address from crash report. Application might have crashed during launch."
             }
             
-            completion(replacedContent)
+            // Frameworks and extensions get one batch per image against their own dSYM.
+            let otherIndices = Dictionary(grouping: report.frames.indices.filter { !report.frames[$0].isMainImage }) {
+                report.frames[$0].imageIndex
+            }
+            let otherImages = otherIndices.keys.compactMap { $0 }.filter { BinaryUUID(report.images[$0].uuid) != nil }
+            let dsymPaths = locateDSYMs(for: otherImages.map { report.images[$0] }, architecture: crashFile.architecture)
+            for imageIndex in otherImages {
+                let reportImage = report.images[imageIndex]
+                guard
+                    let indices = otherIndices[imageIndex],
+                    let otherImage = loadImage(reportImage: reportImage, architecture: crashFile.architecture, dsymPaths: dsymPaths)
+                else { continue }
+                
+                try resolve(indices, of: report, with: otherImage, loadAddress: reportImage.start, into: &replacements)
+            }
+            
+            completion(try report.render(replacements: replacements))
+        } catch {
+            errorHandler("\(error)")
+            return
+        }
+        
+        if let dsymError = dsymError {
+            errorHandler(dsymError)
         }
     }
     
-    private static func symbolicationCommand(dsymPath: String, architecture: String, loadAddress: String, addresses: [String]) -> String {
+    /// .ips frames name their image UUID and offset, so the payload goes to the
+    /// engine as is and the text is rendered once with the symbols in place.
+    private static func symbolicate(ipsOf crashFile: CrashFile, dsymFile: DSYMFile?, errorHandler: @escaping ErrorHandler, completion: @escaping CompletionHandler) {
+        
+        var output: String?
+        var failure: String?
+        do {
+            let batch = try SymbolBatch(cache: SymbolCache.shared, threads: 1)
+            try batch.setExpandsInlines(true)
+            try batch.setDemangles(true)
+            if let path = crashFile.ipsPath {
+                try batch.addReportFile(path: path.path)
+            } else if let ips = crashFile.ipsContent {
+                try batch.addReport(name: crashFile.filename, content: ips)
+            }
+            if let uuid = crashFile.uuid, let dsymFile = dsymFile {
+                try batch.addBinary(uuid: uuid, path: dsymFile.binaryPath)
+            }
+            
+            try batch.run(locate: { (missing) in
+                
+                let found = locateDSYMs(uuids: missing.map { $0.uuid.pretty })
+                var binaries = [BinaryUUID: String]()
+                missing.forEach { image in
+                    if let dsymPath = found[image.uuid.pretty] {
+                        binaries[image.uuid] = DSYMFile.binaryPath(inBundle: URL(fileURLWithPath: dsymPath))
+                    }
+                }
+                return binaries
+            }, result: { (_, text, error) in
+                output = text
+                failure = error
+            })
+        } catch let error as SymbolicatorError {
+            errorHandler(error.message)
+            return
+        } catch {
+            errorHandler("\(error)")
+            return
+        }
         
-        let addressesString = addresses.joined(separator: " ")
-        let dsymPath = dsymPath.replacingOccurrences(of: " ", with: "\\ ")
-        return "xcrun atos -o \(dsymPath) -arch \(architecture) -l \(loadAddress) \(addressesString)"
+        guard let text = output else {
+            errorHandler(failure ?? "Could not symbolicate \(crashFile.filename).")
+            return
+        }
+        completion(text)
+    }
+    
+    /// Prefers the index cached for the crash's UUID, so a report can be
+    /// symbolicated again without its dSYM once it has been seen.
+    private static func loadImage(crashFile: CrashFile, dsymFile: DSYMFile?, architecture: String?) throws -> SymbolImage {
+        
+        let cache = SymbolCache.shared
+        
+        if let uuid = crashFile.uuid, let architecture = architecture,
+            let image = try? cache?.image(uuid: uuid, architecture: architecture) {
+            return image
+        }
+        
+        guard let dsymFile = dsymFile else {
+            throw SymbolicatorError.notFound
+        }
+        
+        if let cache = cache {
+            return try cache.image(path: dsymFile.binaryPath, architecture: architecture)
+        }
+        return try SymbolImage(path: dsymFile.binaryPath, architecture: architecture)
+    }
+    
+    private static func resolve(_ indices: [Int], of report: CrashReport, with image: SymbolImage, loadAddress: UInt64, into replacements: inout [String?]) throws {
+        
+        let imageName = try image.name()
+        for index in indices {
+            // One line per inlined call; the report repeats the frame line for each.
+            let frames = try image.lookupInlined(loadAddress: loadAddress, address: report.frames[index].addressValue)
+            replacements[index] = frames.map {
+                $0.atosDescription(address: report.frames[index].address, imageName: imageName)
+            }.joined(separator: "\n")
+        }
+    }
+    
+    private static func architecture(of reportImage: CrashReport.Image, default architecture: Architecture?) -> String? {
+        return Architecture(reportImage.architecture)?.atosString ?? architecture?.atosString
+    }
+    
+    /// Symbols for a non-main image: the cached index for its UUID, else the
+    /// dSYM Spotlight found for it. Missing symbols are not an error.
+    private static func loadImage(reportImage: CrashReport.Image, architecture: Architecture?, dsymPaths: [String: String]) -> SymbolImage? {
+        
+        guard let uuid = BinaryUUID(reportImage.uuid) else { return nil }
+        let architectureString = self.architecture(of: reportImage, default: architecture)
+        
+        if let architectureString = architectureString,
+            let image = try? SymbolCache.shared?.image(uuid: uuid, architecture: architectureString) {
+            return image
+        }
+        
+        guard let dsymPath = dsymPaths[uuid.pretty] else { return nil }
+        
+        let binaryPath = DSYMFile.binaryPath(inBundle: URL(fileURLWithPath: dsymPath))
+        if let cache = SymbolCache.shared {
+            return try? cache.image(path: binaryPath, architecture: architectureString)
+        }
+        return try? SymbolImage(path: binaryPath, architecture: architectureString)
+    }
+    
+    /// Runs one Spotlight query for every image whose symbols are not cached
+    /// yet and waits for it, keyed by `BinaryUUID.pretty`.
+    private static func locateDSYMs(for reportImages: [CrashReport.Image], architecture: Architecture?) -> [String: String] {
+        
+        let uuids = reportImages.compactMap { reportImage -> String? in
+            guard let uuid = BinaryUUID(reportImage.uuid) else { return nil }
+            if let architectureString = self.architecture(of: reportImage, default: architecture),
+                SymbolCache.shared?.contains(uuid: uuid, architecture: architectureString) == true {
+                return nil
+            }
+            return uuid.pretty
+        }
+        return locateDSYMs(uuids: uuids)
+    }
+    
+    /// Looks up dSYM bundles for `uuids` (in `BinaryUUID.pretty` form) with one
+    /// Spotlight query, then in the dSYM catalog for whatever Spotlight missed.
+    /// Must not be called on the main queue.
+    static func locateDSYMs(uuids: [String]) -> [String: String] {
+        
+        guard !uuids.isEmpty else { return [:] }
+        
+        var spotlightPaths = [String: String]()
+        let semaphore = DispatchSemaphore(value: 0)
+        DispatchQueue.main.async {
+            DSYMSearch.search(forUUIDs: uuids) { (result) in
+                spotlightPaths = result
+                semaphore.signal()
+            }
+        }
+        var paths = semaphore.wait(timeout: .now() + 10) == .success ? spotlightPaths : [:]
+        
+        let missing = uuids.filter { paths[$0] == nil }
+        DSYMSearch.catalogSearch(forUUIDs: missing, crashFileDirectory: nil).forEach { uuid, path in
+            paths[uuid] = path
+        }
+        return paths
     }
 }